@@ -44,6 +44,21 @@ arrow_table_slice* arrow_table_slice::copy() const {
   return new arrow_table_slice(header_, batch_);
 }
 
+table_slice_ptr arrow_table_slice::copy_rows(size_type first_row,
+                                             size_type num_rows) const {
+  VAST_ASSERT(batch_ != nullptr);
+  VAST_ASSERT(num_rows > 0);
+  VAST_ASSERT(first_row + num_rows <= rows());
+  auto header = header_;
+  header.rows = num_rows;
+  header.offset = offset() + first_row;
+  auto batch = batch_->Slice(detail::narrow_cast<int64_t>(first_row),
+                             detail::narrow_cast<int64_t>(num_rows));
+  return table_slice_ptr{new arrow_table_slice(std::move(header),
+                                               std::move(batch)),
+                         false};
+}
+
 namespace {
 
 class arrow_output_stream : public arrow::io::OutputStream {
@@ -532,7 +532,7 @@ bool arrow_table_slice_builder::add_impl(data_view x) {
   return true;
 }
 
-table_slice_ptr arrow_table_slice_builder::finish() {
+table_slice_ptr arrow_table_slice_builder::finish_impl() {
   // Sanity check.
   if (col_ != 0)
     return nullptr;
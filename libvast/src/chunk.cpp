@@ -17,6 +17,7 @@
 #include "vast/error.hpp"
 #include "vast/filesystem.hpp"
 
+#include <caf/binary_deserializer.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/make_counted.hpp>
 #include <caf/serializer.hpp>
@@ -30,6 +31,15 @@
 
 namespace vast {
 
+namespace {
+
+// The chunk whose bytes the deserializer of the innermost
+// chunk_sharing_guard on this thread hands out.
+thread_local chunk_ptr shared_chunk;
+thread_local caf::deserializer* shared_source = nullptr;
+
+} // namespace <anonymous>
+
 chunk_ptr chunk::make(size_type size) {
   VAST_ASSERT(size > 0);
   auto data = new value_type[size];
@@ -88,7 +98,7 @@ chunk::value_type chunk::operator[](size_type i) const {
 }
 
 chunk_ptr chunk::slice(size_type start, size_type length) const {
-  VAST_ASSERT(start + length < size());
+  VAST_ASSERT(start < size() && start + length <= size());
   if (length == 0)
     length = size() - start;
   auto self = const_cast<chunk*>(this); // Atomic ref-counting is fine.
@@ -157,9 +167,30 @@ caf::error inspect(caf::deserializer& source, chunk_ptr& x) {
     x = nullptr;
     return caf::none;
   }
+  if (&source == shared_source) {
+    auto& bd = static_cast<caf::binary_deserializer&>(source);
+    if (n > bd.remaining())
+      return make_error(ec::format_error, "chunk exceeds its input");
+    x = shared_chunk->slice(shared_chunk->size() - bd.remaining(), n);
+    bd.skip(n);
+    return caf::none;
+  }
   x = chunk::make(n);
   auto data = const_cast<chunk::pointer>(x->data());
   return source.apply_raw(n, data);
 }
 
+chunk_sharing_guard::chunk_sharing_guard(chunk_ptr chk,
+                                         caf::deserializer& source)
+  : previous_chunk_{std::move(shared_chunk)}, previous_source_{shared_source} {
+  VAST_ASSERT(chk != nullptr);
+  shared_chunk = std::move(chk);
+  shared_source = &source;
+}
+
+chunk_sharing_guard::~chunk_sharing_guard() {
+  shared_chunk = std::move(previous_chunk_);
+  shared_source = previous_source_;
+}
+
 } // namespace vast
@@ -0,0 +1,388 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/column_encoding.hpp"
+
+#include <caf/binary_deserializer.hpp>
+#include <caf/binary_serializer.hpp>
+#include <caf/optional.hpp>
+
+#include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/bit.hpp"
+#include "vast/detail/overload.hpp"
+#include "vast/detail/varbyte.hpp"
+#include "vast/detail/zigzag.hpp"
+#include "vast/error.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace vast {
+
+namespace {
+
+// Appends variable-length integers and bit-packed values to a buffer. Callers
+// must align the writer before switching from bits to bytes.
+class column_writer {
+public:
+  explicit column_writer(std::vector<char>& buf) : buf_{buf} {
+    // nop
+  }
+
+  void write_varint(uint64_t x) {
+    VAST_ASSERT(used_ == 0);
+    char tmp[detail::varbyte::max_size<uint64_t>()];
+    auto n = detail::varbyte::encode(x, tmp);
+    buf_.insert(buf_.end(), tmp, tmp + n);
+  }
+
+  void write_bytes(std::string_view x) {
+    write_varint(x.size());
+    buf_.insert(buf_.end(), x.begin(), x.end());
+  }
+
+  void write_bits(uint64_t x, size_t width) {
+    VAST_ASSERT(width <= 32);
+    acc_ |= (x & ((uint64_t{1} << width) - 1)) << used_;
+    used_ += width;
+    while (used_ >= 8) {
+      buf_.push_back(static_cast<char>(acc_ & 0xff));
+      acc_ >>= 8;
+      used_ -= 8;
+    }
+  }
+
+  void align() {
+    if (used_ > 0) {
+      buf_.push_back(static_cast<char>(acc_ & 0xff));
+      acc_ = 0;
+      used_ = 0;
+    }
+  }
+
+private:
+  std::vector<char>& buf_;
+  uint64_t acc_ = 0;
+  size_t used_ = 0;
+};
+
+// Reads what a column_writer wrote, checking all bounds.
+class column_reader {
+public:
+  column_reader(const char* buffer, size_t size)
+    : first_{reinterpret_cast<const uint8_t*>(buffer)}, last_{first_ + size} {
+    // nop
+  }
+
+  bool read_varint(uint64_t& x) {
+    auto i = first_;
+    while (i != last_ && (*i & 0x80))
+      ++i;
+    auto n = static_cast<size_t>(i - first_);
+    if (i == last_ || n >= detail::varbyte::max_size<uint64_t>())
+      return false;
+    first_ += detail::varbyte::decode(x, first_);
+    return true;
+  }
+
+  bool read_bytes(std::string& x) {
+    uint64_t n;
+    if (!read_varint(n) || n > static_cast<uint64_t>(last_ - first_))
+      return false;
+    x.assign(reinterpret_cast<const char*>(first_), n);
+    first_ += n;
+    return true;
+  }
+
+  bool read_bits(uint64_t& x, size_t width) {
+    VAST_ASSERT(width <= 32);
+    while (used_ < width) {
+      if (first_ == last_)
+        return false;
+      acc_ |= uint64_t{*first_++} << used_;
+      used_ += 8;
+    }
+    x = acc_ & ((uint64_t{1} << width) - 1);
+    acc_ >>= width;
+    used_ -= width;
+    return true;
+  }
+
+  void align() {
+    acc_ = 0;
+    used_ = 0;
+  }
+
+  size_t remaining() const {
+    return last_ - first_;
+  }
+
+private:
+  const uint8_t* first_;
+  const uint8_t* last_;
+  uint64_t acc_ = 0;
+  size_t used_ = 0;
+};
+
+// Converts a value of a delta-encoded or bit-packed column to its bits.
+caf::optional<uint64_t> to_bits(const data_view& x) {
+  using result_type = caf::optional<uint64_t>;
+  auto f = detail::overload(
+    [](view<count> y) -> result_type { return y; },
+    [](view<integer> y) -> result_type { return static_cast<uint64_t>(y); },
+    [](view<bool> y) -> result_type { return y ? 1 : 0; },
+    [](view<time> y) -> result_type {
+      return static_cast<uint64_t>(y.time_since_epoch().count());
+    },
+    [](view<duration> y) -> result_type {
+      return static_cast<uint64_t>(y.count());
+    },
+    [](view<port> y) -> result_type {
+      return (uint64_t{y.number()} << 8) | y.type();
+    },
+    [](const auto&) -> result_type { return caf::none; });
+  return caf::visit(f, x);
+}
+
+// Converts the bits of a value back to data of the column type.
+caf::optional<data> from_bits(const type& t, uint64_t x) {
+  using result_type = caf::optional<data>;
+  auto f = detail::overload(
+    [&](const count_type&) -> result_type { return data{count{x}}; },
+    [&](const integer_type&) -> result_type {
+      return data{static_cast<integer>(x)};
+    },
+    [&](const bool_type&) -> result_type { return data{x != 0}; },
+    [&](const time_type&) -> result_type {
+      return data{time{duration{static_cast<duration::rep>(x)}}};
+    },
+    [&](const duration_type&) -> result_type {
+      return data{duration{static_cast<duration::rep>(x)}};
+    },
+    [&](const port_type&) -> result_type {
+      return data{port{static_cast<port::number_type>(x >> 8),
+                       static_cast<port::port_type>(x & 0xff)}};
+    },
+    [&](const auto&) -> result_type { return caf::none; });
+  return caf::visit(f, t);
+}
+
+// Writes a bitmap of the null values of a column followed by the non-null
+// values in the given encoding. Returns false if a value does not fit the
+// encoding.
+bool encode_compact(std::vector<char>& buf, const table_slice& slice,
+                    size_t col, column_encoding encoding) {
+  column_writer writer{buf};
+  for (size_t row = 0; row < slice.rows(); ++row)
+    writer.write_bits(caf::holds_alternative<caf::none_t>(slice.at(row, col)),
+                      1);
+  writer.align();
+  switch (encoding) {
+    case column_encoding::delta: {
+      uint64_t previous = 0;
+      for (size_t row = 0; row < slice.rows(); ++row) {
+        auto x = slice.at(row, col);
+        if (caf::holds_alternative<caf::none_t>(x))
+          continue;
+        auto bits = to_bits(x);
+        if (!bits)
+          return false;
+        auto delta = static_cast<int64_t>(*bits - previous);
+        writer.write_varint(detail::zigzag::encode(delta));
+        previous = *bits;
+      }
+      return true;
+    }
+    case column_encoding::dictionary: {
+      // The views remain valid as long as the slice lives.
+      std::map<std::string_view, uint64_t> codes;
+      std::vector<std::string_view> dictionary;
+      std::vector<uint64_t> xs;
+      for (size_t row = 0; row < slice.rows(); ++row) {
+        auto x = slice.at(row, col);
+        if (caf::holds_alternative<caf::none_t>(x))
+          continue;
+        auto str = caf::get_if<view<std::string>>(&x);
+        if (!str)
+          return false;
+        auto [i, added] = codes.emplace(*str, dictionary.size());
+        if (added)
+          dictionary.push_back(*str);
+        xs.push_back(i->second);
+      }
+      writer.write_varint(dictionary.size());
+      for (auto& entry : dictionary)
+        writer.write_bytes(entry);
+      uint64_t max_code = dictionary.empty() ? 0 : dictionary.size() - 1;
+      auto width = detail::log2p1(max_code);
+      if (width > 32)
+        return false;
+      for (auto code : xs)
+        writer.write_bits(code, width);
+      writer.align();
+      return true;
+    }
+    case column_encoding::bitpacked: {
+      std::vector<uint64_t> xs;
+      for (size_t row = 0; row < slice.rows(); ++row) {
+        auto x = slice.at(row, col);
+        if (caf::holds_alternative<caf::none_t>(x))
+          continue;
+        auto bits = to_bits(x);
+        if (!bits)
+          return false;
+        xs.push_back(*bits);
+      }
+      uint64_t max = xs.empty() ? 0 : *std::max_element(xs.begin(), xs.end());
+      auto width = detail::log2p1(max);
+      if (width > 32)
+        return false;
+      writer.write_varint(width);
+      for (auto x : xs)
+        writer.write_bits(x, width);
+      writer.align();
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+} // namespace <anonymous>
+
+column_encoding encoding_for(const type& t) {
+  auto f = detail::overload(
+    [](const count_type&) { return column_encoding::delta; },
+    [](const integer_type&) { return column_encoding::delta; },
+    [](const time_type&) { return column_encoding::delta; },
+    [](const duration_type&) { return column_encoding::delta; },
+    [](const string_type&) { return column_encoding::dictionary; },
+    [](const bool_type&) { return column_encoding::bitpacked; },
+    [](const port_type&) { return column_encoding::bitpacked; },
+    [](const auto&) { return column_encoding::plain; });
+  return caf::visit(f, t);
+}
+
+caf::expected<column_encoding>
+encode_column(std::vector<char>& buf, const table_slice& slice, size_t col) {
+  VAST_ASSERT(col < slice.columns());
+  auto encoding = encoding_for(slice.layout().fields[col].type);
+  if (encoding != column_encoding::plain) {
+    auto before = buf.size();
+    if (encode_compact(buf, slice, col, encoding))
+      return encoding;
+    buf.resize(before);
+  }
+  std::vector<data> values;
+  values.reserve(slice.rows());
+  for (size_t row = 0; row < slice.rows(); ++row)
+    values.emplace_back(materialize(slice.at(row, col)));
+  caf::binary_serializer sink{nullptr, buf};
+  if (auto err = sink(values))
+    return err;
+  return column_encoding::plain;
+}
+
+caf::expected<std::vector<data>>
+decode_column(const char* buffer, size_t size, const type& t,
+              column_encoding encoding, size_t rows) {
+  auto malformed = [] {
+    return make_error(ec::format_error, "malformed column");
+  };
+  std::vector<data> result;
+  if (encoding == column_encoding::plain) {
+    caf::binary_deserializer source{nullptr, buffer, size};
+    if (auto err = source(result))
+      return err;
+    if (result.size() != rows)
+      return malformed();
+    return result;
+  }
+  column_reader reader{buffer, size};
+  std::vector<bool> nulls(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    uint64_t bit;
+    if (!reader.read_bits(bit, 1))
+      return malformed();
+    nulls[row] = bit != 0;
+  }
+  reader.align();
+  result.resize(rows);
+  switch (encoding) {
+    case column_encoding::delta: {
+      uint64_t previous = 0;
+      for (size_t row = 0; row < rows; ++row) {
+        if (nulls[row])
+          continue;
+        uint64_t x;
+        if (!reader.read_varint(x))
+          return malformed();
+        previous += static_cast<uint64_t>(detail::zigzag::decode(x));
+        auto y = from_bits(t, previous);
+        if (!y)
+          return malformed();
+        result[row] = std::move(*y);
+      }
+      break;
+    }
+    case column_encoding::dictionary: {
+      uint64_t n;
+      if (!reader.read_varint(n) || n > reader.remaining())
+        return malformed();
+      std::vector<std::string> dictionary(n);
+      for (auto& entry : dictionary)
+        if (!reader.read_bytes(entry))
+          return malformed();
+      auto width = detail::log2p1(n == 0 ? n : n - 1);
+      if (width > 32)
+        return malformed();
+      for (size_t row = 0; row < rows; ++row) {
+        if (nulls[row])
+          continue;
+        uint64_t code;
+        if (!reader.read_bits(code, width) || code >= n)
+          return malformed();
+        result[row] = dictionary[code];
+      }
+      break;
+    }
+    case column_encoding::bitpacked: {
+      uint64_t width;
+      if (!reader.read_varint(width) || width > 32)
+        return malformed();
+      for (size_t row = 0; row < rows; ++row) {
+        if (nulls[row])
+          continue;
+        uint64_t x;
+        if (!reader.read_bits(x, width))
+          return malformed();
+        auto y = from_bits(t, x);
+        if (!y)
+          return malformed();
+        result[row] = std::move(*y);
+      }
+      break;
+    }
+    default:
+      return make_error(ec::format_error, "unknown column encoding");
+  }
+  return result;
+}
+
+} // namespace vast
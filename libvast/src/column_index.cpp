@@ -13,8 +13,10 @@
 
 #include "vast/column_index.hpp"
 
+#include <caf/binary_deserializer.hpp>
+
+#include "vast/chunk.hpp"
 #include "vast/expression_visitors.hpp"
-#include "vast/load.hpp"
 #include "vast/logger.hpp"
 #include "vast/save.hpp"
 #include "vast/table_slice.hpp"
@@ -59,7 +61,18 @@ caf::error column_index::init() {
   VAST_TRACE("");
   // Materialize the index when encountering persistent state.
   if (exists(filename_)) {
-    if (auto err = load(nullptr, filename_, last_flush_, idx_)) {
+    // Map the file instead of reading it, so that the coders keep the
+    // serialized bitmaps as slices of the mapping and decode them on first
+    // access.
+    auto chk = chunk::mmap(filename_);
+    if (chk == nullptr) {
+      VAST_ERROR(this, "failed to mmap value index", filename_);
+      return make_error(ec::filesystem_error, "failed to mmap value index",
+                        filename_);
+    }
+    caf::binary_deserializer source{nullptr, chk->data(), chk->size()};
+    chunk_sharing_guard guard{chk, source};
+    if (auto err = source(last_flush_, idx_)) {
       VAST_ERROR(this, "failed to load value index from disk", sys_.render(err));
       return err;
     } else {
@@ -25,6 +25,22 @@ default_table_slice* default_table_slice::copy() const {
   return new default_table_slice(*this);
 }
 
+table_slice_ptr default_table_slice::copy_rows(size_type first_row,
+                                               size_type num_rows) const {
+  // Derived types must produce slices of their own kind.
+  if (implementation_id() != class_id)
+    return table_slice::copy_rows(first_row, num_rows);
+  VAST_ASSERT(num_rows > 0);
+  VAST_ASSERT(first_row + num_rows <= rows());
+  auto header = header_;
+  header.rows = num_rows;
+  header.offset = offset() + first_row;
+  auto result = new default_table_slice{std::move(header)};
+  auto first = xs_.begin() + first_row;
+  result->xs_.assign(first, first + num_rows);
+  return table_slice_ptr{result, false};
+}
+
 caf::error default_table_slice::serialize(caf::serializer& sink) const {
   return sink(xs_);
 }
@@ -63,6 +79,24 @@ table_slice_ptr default_table_slice::make(record_type layout,
   return result;
 }
 
+table_slice_ptr default_table_slice::make(table_slice_header header,
+                                          std::vector<vector> columns) {
+  VAST_ASSERT(columns.size() == header.layout.fields.size());
+  auto rows = header.rows;
+  auto result = new default_table_slice{std::move(header)};
+  result->xs_.reserve(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    vector xs;
+    xs.reserve(columns.size());
+    for (auto& column : columns) {
+      VAST_ASSERT(column.size() == rows);
+      xs.emplace_back(std::move(column[row]));
+    }
+    result->xs_.emplace_back(std::move(xs));
+  }
+  return table_slice_ptr{result, false};
+}
+
 caf::atom_value default_table_slice::implementation_id() const noexcept {
   return class_id;
 }
@@ -52,13 +52,33 @@ bool default_table_slice_builder::add_impl(data_view x) {
   return append(materialize(x));
 }
 
-table_slice_ptr default_table_slice_builder::finish() {
+bool default_table_slice_builder::add_owned_impl(data&& x) {
+  return append(std::move(x));
+}
+
+bool default_table_slice_builder::add_rows_impl(const table_slice& xs,
+                                                size_t first_row,
+                                                size_t num_rows) {
+  // Rows of a default table slice with the same layout already passed the
+  // type check, so we can take them as-is, provided we are at a row boundary.
+  auto slice = dynamic_cast<const default_table_slice*>(&xs);
+  if (slice == nullptr || col_ != 0)
+    return super::add_rows_impl(xs, first_row, num_rows);
+  lazy_init();
+  auto& rows = slice->container();
+  auto first = rows.begin() + first_row;
+  slice_->xs_.insert(slice_->xs_.end(), first, first + num_rows);
+  return true;
+}
+
+table_slice_ptr default_table_slice_builder::finish_impl() {
   // If we have an incomplete row, we take it as-is and keep the remaining null
   // values. Better to have incomplete than no data.
   if (col_ != 0)
     slice_->xs_.push_back(std::move(row_));
   // Populate slice.
   slice_->header_.rows = slice_->xs_.size();
+  last_rows_ = slice_->xs_.size();
   return table_slice_ptr{slice_.release(), false};
 }
 
@@ -81,6 +101,7 @@ void default_table_slice_builder::lazy_init() {
     table_slice_header header;
     header.layout = layout();
     slice_.reset(new default_table_slice{std::move(header)});
+    slice_->xs_.reserve(last_rows_);
     row_ = vector(slice_->columns());
     col_ = 0;
   }
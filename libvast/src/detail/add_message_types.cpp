@@ -22,10 +22,12 @@
 #include "vast/query_options.hpp"
 #include "vast/schema.hpp"
 #include "vast/system/accountant.hpp"
+#include "vast/system/query_budget.hpp"
 #include "vast/system/query_status.hpp"
 #include "vast/system/replicated_store.hpp"
 #include "vast/system/tracker.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
@@ -59,6 +61,7 @@ void add_message_types(caf::actor_system_config& cfg) {
   cfg.add_message_type<expression>("vast::expression");
   // Containers
   cfg.add_message_type<std::vector<event>>("std::vector<vast::event>");
+  cfg.add_message_type<std::vector<time>>("std::vector<vast::time>");
   // Actor-specific messages
   cfg.add_message_type<system::component_map>("vast::system::component_map");
   cfg.add_message_type<system::component_map_entry>(
@@ -66,6 +69,7 @@ void add_message_types(caf::actor_system_config& cfg) {
   cfg.add_message_type<system::registry>("vast::system::registry");
   cfg.add_message_type<system::performance_report>("vast::system::performance_"
                                                    "report");
+  cfg.add_message_type<system::query_budget>("vast::system::query_budget");
   cfg.add_message_type<system::query_status>("vast::system::query_status");
   cfg.add_message_type<system::actor_identity>("vast::system::actor_identity");
 #ifdef VAST_USE_OPENCL
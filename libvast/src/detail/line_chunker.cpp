@@ -0,0 +1,82 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/line_chunker.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/string.hpp"
+
+namespace vast::detail {
+
+line_chunker::line_chunker(std::istream& input, policy p)
+  : input_{input}, policy_{std::move(p)} {
+  // nop
+}
+
+std::string line_chunker::next(size_t max_records) {
+  VAST_ASSERT(max_records > 0);
+  std::string records;
+  size_t num_records = 0;
+  auto starts_with_prefix = [&](const std::string& prefix) {
+    return !prefix.empty() && starts_with(line_, prefix);
+  };
+  while (num_records < max_records && get_line()) {
+    if (line_number_ <= policy_.header_lines) {
+      header_ += line_;
+      header_ += '\n';
+    } else if (starts_with_prefix(policy_.header_marker)) {
+      // A new header only applies to subsequent chunks.
+      if (num_records > 0) {
+        pending_ = true;
+        break;
+      }
+      header_ = line_;
+      header_ += '\n';
+      in_header_ = true;
+    } else if (starts_with_prefix(policy_.comment_prefix)) {
+      if (in_header_) {
+        header_ += line_;
+        header_ += '\n';
+      }
+    } else {
+      in_header_ = false;
+      records += line_;
+      records += '\n';
+      ++num_records;
+    }
+  }
+  if (num_records == 0)
+    return {};
+  return header_ + records;
+}
+
+bool line_chunker::done() const {
+  return !pending_ && !input_;
+}
+
+bool line_chunker::get_line() {
+  if (pending_) {
+    pending_ = false;
+    return true;
+  }
+  // Skip empty lines, just like `line_range`.
+  while (std::getline(input_, line_)) {
+    if (!line_.empty()) {
+      ++line_number_;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace vast::detail
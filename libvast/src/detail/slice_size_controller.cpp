@@ -0,0 +1,91 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/slice_size_controller.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace vast::detail {
+
+namespace {
+
+// The smoothing factor for the event rate estimate.
+constexpr double alpha = 0.25;
+
+// The maximum number of latency samples between two summaries. Beyond this,
+// new samples overwrite old ones in a round-robin fashion.
+constexpr size_t max_samples = 4096;
+
+} // namespace
+
+slice_size_controller::slice_size_controller(duration target, size_t min_size,
+                                             size_t max_size)
+  : target_{target},
+    min_size_{min_size},
+    max_size_{max_size},
+    slice_size_{max_size} {
+  VAST_ASSERT(target > duration::zero());
+  VAST_ASSERT(0 < min_size && min_size <= max_size);
+}
+
+void slice_size_controller::observe(size_t events, duration elapsed) {
+  pending_events_ += events;
+  pending_time_ += elapsed;
+  if (pending_events_ == 0 || pending_time_ <= duration::zero())
+    return;
+  using double_seconds = std::chrono::duration<double>;
+  auto secs = std::chrono::duration_cast<double_seconds>(pending_time_).count();
+  auto rate = pending_events_ / secs;
+  pending_events_ = 0;
+  pending_time_ = duration::zero();
+  rate_ = rate_ == 0.0 ? rate : alpha * rate + (1 - alpha) * rate_;
+  // Pick the number of events that arrive within the target latency.
+  auto target_secs = std::chrono::duration_cast<double_seconds>(target_);
+  auto size = std::llround(rate_ * target_secs.count());
+  slice_size_ = std::clamp(static_cast<size_t>(std::max(size, 1ll)),
+                           min_size_, max_size_);
+}
+
+void slice_size_controller::record(duration latency) {
+  if (samples_.size() < max_samples)
+    samples_.push_back(latency);
+  else
+    samples_[num_samples_ % max_samples] = latency;
+  ++num_samples_;
+}
+
+slice_size_controller::summary slice_size_controller::summarize() {
+  summary result;
+  if (samples_.empty())
+    return result;
+  result.samples = num_samples_;
+  auto percentile = [&](double p) {
+    auto n = static_cast<size_t>(p * (samples_.size() - 1));
+    auto nth = samples_.begin() + n;
+    std::nth_element(samples_.begin(), nth, samples_.end());
+    return *nth;
+  };
+  result.p50 = percentile(0.5);
+  result.p90 = percentile(0.9);
+  result.p99 = percentile(0.99);
+  result.max = *std::max_element(samples_.begin(), samples_.end());
+  samples_.clear();
+  num_samples_ = 0;
+  return result;
+}
+
+} // namespace vast::detail
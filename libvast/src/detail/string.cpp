@@ -100,8 +100,16 @@ std::string replace_all(std::string str, std::string_view search,
 std::vector<std::string_view> split(std::string_view str, std::string_view sep,
                                     std::string_view esc, size_t max_splits,
                                     bool include_sep) {
+  std::vector<std::string_view> result;
+  split(result, str, sep, esc, max_splits, include_sep);
+  return result;
+}
+
+void split(std::vector<std::string_view>& result, std::string_view str,
+           std::string_view sep, std::string_view esc, size_t max_splits,
+           bool include_sep) {
   VAST_ASSERT(!sep.empty());
-  std::vector<std::string_view> pos;
+  result.clear();
   size_t splits = 0;
   auto end = str.end();
   auto begin = str.begin();
@@ -109,7 +117,8 @@ std::vector<std::string_view> split(std::string_view str, std::string_view sep,
   auto prev = i;
   auto push = [&](auto first, auto last) {
     using std::distance;
-    pos.emplace_back(str.substr(distance(begin, first), distance(first, last)));
+    result.emplace_back(
+      str.substr(distance(begin, first), distance(first, last)));
   };
   while (i != end) {
     // Find a separator that fits in the string.
@@ -154,7 +163,6 @@ std::vector<std::string_view> split(std::string_view str, std::string_view sep,
   }
   if (prev != end)
       push(prev, end);
-  return pos;
 }
 
 std::vector<std::string> to_strings(const std::vector<std::string_view>& v) {
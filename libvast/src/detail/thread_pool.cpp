@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/thread_pool.hpp"
+
+#include "vast/detail/assert.hpp"
+
+namespace vast::detail {
+
+thread_pool::thread_pool(size_t num_threads) {
+  VAST_ASSERT(num_threads > 0);
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    workers_.emplace_back([this] { run(); });
+}
+
+thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+void thread_pool::post(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    jobs_.push_back(std::move(job));
+  }
+  cv_.notify_one();
+}
+
+void thread_pool::run() {
+  for (;;) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      cv_.wait(lock, [&] { return stopping_ || !jobs_.empty(); });
+      // Drain the queue before shutting down.
+      if (jobs_.empty())
+        return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job();
+  }
+}
+
+} // namespace vast::detail
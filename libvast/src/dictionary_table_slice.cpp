@@ -0,0 +1,142 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/dictionary_table_slice.hpp"
+
+#include <unordered_map>
+
+#include <caf/deserializer.hpp>
+#include <caf/serializer.hpp>
+
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+#include "vast/value_index.hpp"
+
+namespace vast {
+
+dictionary_table_slice* dictionary_table_slice::copy() const {
+  return new dictionary_table_slice(*this);
+}
+
+table_slice_ptr dictionary_table_slice::copy_rows(size_type first_row,
+                                                  size_type num_rows) const {
+  // Derived types must produce slices of their own kind.
+  if (implementation_id() != class_id)
+    return table_slice::copy_rows(first_row, num_rows);
+  VAST_ASSERT(num_rows > 0);
+  VAST_ASSERT(first_row + num_rows <= rows());
+  auto header = header_;
+  header.rows = num_rows;
+  header.offset = offset() + first_row;
+  auto result = new dictionary_table_slice{std::move(header)};
+  result->columns_.resize(columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    auto& src = columns_[i];
+    auto& dst = result->columns_[i];
+    dst.encoded = src.encoded;
+    if (src.encoded) {
+      // Only copy the dictionary entries that the copied rows refer to, so
+      // that selecting many small runs does not duplicate the dictionary.
+      std::unordered_map<code_type, code_type> recoded;
+      dst.codes.reserve(num_rows);
+      for (auto row = first_row; row < first_row + num_rows; ++row) {
+        auto code = src.codes[row];
+        if (code == null_code) {
+          dst.codes.push_back(null_code);
+          continue;
+        }
+        auto next = static_cast<code_type>(dst.dictionary.size());
+        auto [j, added] = recoded.emplace(code, next);
+        if (added)
+          dst.dictionary.push_back(src.dictionary[code]);
+        dst.codes.push_back(j->second);
+      }
+    } else {
+      auto first = src.values.begin() + first_row;
+      dst.values.assign(first, first + num_rows);
+    }
+  }
+  return table_slice_ptr{result, false};
+}
+
+caf::error dictionary_table_slice::serialize(caf::serializer& sink) const {
+  return sink(columns_);
+}
+
+caf::error dictionary_table_slice::deserialize(caf::deserializer& source) {
+  if (auto err = source(columns_))
+    return err;
+  // Reject data that would make `at` read out of bounds.
+  if (columns_.size() != columns())
+    return make_error(ec::format_error, "column count mismatch");
+  for (auto& x : columns_) {
+    if (x.encoded) {
+      if (x.codes.size() != rows())
+        return make_error(ec::format_error, "row count mismatch");
+      for (auto code : x.codes)
+        if (code != null_code && code >= x.dictionary.size())
+          return make_error(ec::format_error, "invalid dictionary code");
+    } else if (x.values.size() != rows()) {
+      return make_error(ec::format_error, "row count mismatch");
+    }
+  }
+  return caf::none;
+}
+
+void dictionary_table_slice::append_column_to_index(size_type col,
+                                                    value_index& idx) const {
+  VAST_ASSERT(col < columns_.size());
+  auto& x = columns_[col];
+  if (!x.encoded) {
+    for (size_type row = 0; row < rows(); ++row)
+      idx.append(make_view(x.values[row]), offset() + row);
+    return;
+  }
+  for (size_type row = 0; row < rows(); ++row) {
+    auto code = x.codes[row];
+    if (code == null_code)
+      idx.append(make_view(caf::none), offset() + row);
+    else
+      idx.append(make_view(x.dictionary[code]), offset() + row);
+  }
+}
+
+data_view dictionary_table_slice::at(size_type row, size_type col) const {
+  VAST_ASSERT(row < rows());
+  VAST_ASSERT(col < columns_.size());
+  auto& x = columns_[col];
+  if (!x.encoded) {
+    VAST_ASSERT(row < x.values.size());
+    return make_view(x.values[row]);
+  }
+  VAST_ASSERT(row < x.codes.size());
+  auto code = x.codes[row];
+  if (code == null_code)
+    return make_view(caf::none);
+  return make_view(x.dictionary[code]);
+}
+
+table_slice_ptr dictionary_table_slice::make(table_slice_header header) {
+  return table_slice_ptr{new dictionary_table_slice{std::move(header)}, false};
+}
+
+caf::atom_value dictionary_table_slice::implementation_id() const noexcept {
+  return class_id;
+}
+
+dictionary_table_slice::dictionary_table_slice(table_slice_header header)
+  : table_slice{std::move(header)} {
+  // nop
+}
+
+} // namespace vast
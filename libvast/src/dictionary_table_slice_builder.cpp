@@ -0,0 +1,143 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/dictionary_table_slice_builder.hpp"
+
+#include <utility>
+
+#include <caf/make_counted.hpp>
+
+#include "vast/detail/assert.hpp"
+#include "vast/detail/narrow.hpp"
+
+namespace vast {
+
+namespace {
+
+/// Converts a dictionary-encoded column to plain encoding.
+void decode(dictionary_table_slice::column_data& x) {
+  x.values.reserve(x.codes.size());
+  for (auto code : x.codes)
+    if (code == dictionary_table_slice::null_code)
+      x.values.emplace_back(caf::none);
+    else
+      x.values.emplace_back(x.dictionary[code]);
+  x.encoded = false;
+  x.dictionary = {};
+  x.codes = {};
+}
+
+} // namespace
+
+caf::atom_value
+dictionary_table_slice_builder::get_implementation_id() noexcept {
+  return dictionary_table_slice::class_id;
+}
+
+dictionary_table_slice_builder::dictionary_table_slice_builder(
+  record_type layout)
+  : super{std::move(layout)}, col_{0}, rows_{0} {
+  VAST_ASSERT(columns() > 0);
+}
+
+table_slice_builder_ptr
+dictionary_table_slice_builder::make(record_type layout) {
+  return caf::make_counted<dictionary_table_slice_builder>(std::move(layout));
+}
+
+bool dictionary_table_slice_builder::add_impl(data_view x) {
+  lazy_init();
+  auto& column = slice_->columns_[col_];
+  if (column.encoded) {
+    if (caf::holds_alternative<caf::none_t>(x)) {
+      column.codes.push_back(dictionary_table_slice::null_code);
+    } else if (auto str = caf::get_if<view<std::string>>(&x)) {
+      auto& codes = codes_[col_];
+      auto i = codes.find(*str);
+      if (i == codes.end()) {
+        auto code = detail::narrow_cast<code_type>(column.dictionary.size());
+        VAST_ASSERT(code != dictionary_table_slice::null_code);
+        column.dictionary.emplace_back(*str);
+        i = codes.emplace(column.dictionary.back(), code).first;
+      }
+      column.codes.push_back(i->second);
+    } else {
+      return false;
+    }
+  } else {
+    // TODO: consider an unchecked version for improved performance.
+    auto y = materialize(x);
+    if (!type_check(layout().fields[col_].type, y))
+      return false;
+    column.values.push_back(std::move(y));
+  }
+  if (++col_ == columns()) {
+    ++rows_;
+    col_ = 0;
+  }
+  return true;
+}
+
+table_slice_ptr dictionary_table_slice_builder::finish_impl() {
+  if (slice_ == nullptr)
+    lazy_init();
+  // If we have an incomplete row, we take it as-is and fill the remaining
+  // columns with null values. Better to have incomplete than no data.
+  while (col_ != 0)
+    if (!add_impl(make_view(caf::none)))
+      return nullptr;
+  for (auto& column : slice_->columns_)
+    if (column.encoded && column.dictionary.size() > max_distinct_ratio * rows_)
+      decode(column);
+  slice_->header_.rows = rows_;
+  codes_.clear();
+  rows_ = 0;
+  return table_slice_ptr{slice_.release(), false};
+}
+
+size_t dictionary_table_slice_builder::rows() const noexcept {
+  return rows_;
+}
+
+void dictionary_table_slice_builder::reserve(size_t num_rows) {
+  lazy_init();
+  for (auto& column : slice_->columns_) {
+    if (column.encoded)
+      column.codes.reserve(num_rows);
+    else
+      column.values.reserve(num_rows);
+  }
+}
+
+caf::atom_value
+dictionary_table_slice_builder::implementation_id() const noexcept {
+  return dictionary_table_slice::class_id;
+}
+
+void dictionary_table_slice_builder::lazy_init() {
+  if (slice_ == nullptr) {
+    table_slice_header header;
+    header.layout = layout();
+    slice_.reset(new dictionary_table_slice{std::move(header)});
+    slice_->columns_.resize(columns());
+    for (size_t i = 0; i < columns(); ++i)
+      slice_->columns_[i].encoded
+        = caf::holds_alternative<string_type>(layout().fields[i].type);
+    codes_.clear();
+    codes_.resize(columns());
+    rows_ = 0;
+    col_ = 0;
+  }
+}
+
+} // namespace vast
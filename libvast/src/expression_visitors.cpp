@@ -22,6 +22,7 @@
 #include "vast/concept/printable/vast/type.hpp"
 #include "vast/data.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/dictionary_table_slice.hpp"
 #include "vast/die.hpp"
 #include "vast/event.hpp"
 #include "vast/ids.hpp"
@@ -629,9 +630,95 @@ bool evaluate_at(const table_slice& slice, size_t row, const expression& expr) {
   return caf::visit(table_slice_row_evaluator{slice, row}, expr);
 }
 
+namespace {
+
+// Evaluates an expression for all rows of a dictionary table slice at once.
+// Predicates over dictionary-encoded columns run once per dictionary entry
+// instead of once per row; all other predicates fall back to the row
+// evaluator.
+struct dictionary_slice_evaluator {
+  using result_type = std::vector<bool>;
+
+  result_type operator()(caf::none_t) const {
+    return result_type(slice_.rows(), false);
+  }
+
+  result_type operator()(const conjunction& c) const {
+    result_type result(slice_.rows(), true);
+    for (auto& op : c) {
+      auto xs = caf::visit(*this, op);
+      for (size_t row = 0; row < result.size(); ++row)
+        result[row] = result[row] && xs[row];
+    }
+    return result;
+  }
+
+  result_type operator()(const disjunction& d) const {
+    result_type result(slice_.rows(), false);
+    for (auto& op : d) {
+      auto xs = caf::visit(*this, op);
+      for (size_t row = 0; row < result.size(); ++row)
+        result[row] = result[row] || xs[row];
+    }
+    return result;
+  }
+
+  result_type operator()(const negation& n) const {
+    auto result = caf::visit(*this, n.expr());
+    result.flip();
+    return result;
+  }
+
+  result_type operator()(const predicate& p) const {
+    auto e = caf::get_if<data_extractor>(&p.lhs);
+    auto d = caf::get_if<data>(&p.rhs);
+    if (e != nullptr && d != nullptr && e->type == slice_.layout()) {
+      VAST_ASSERT(e->offset.size() == 1);
+      auto col = e->offset[0];
+      auto& column = slice_.container()[col];
+      if (column.encoded)
+        return evaluate_encoded(column, slice_.layout().fields[col].type, p.op,
+                                *d);
+    }
+    result_type result(slice_.rows());
+    for (size_t row = 0; row < result.size(); ++row)
+      result[row] = table_slice_row_evaluator{slice_, row}(p);
+    return result;
+  }
+
+  result_type
+  evaluate_encoded(const dictionary_table_slice::column_data& column,
+                   const type& t, relational_operator op, const data& d) const {
+    auto rhs = make_data_view(d);
+    auto check = [&](data_view x) {
+      return evaluate_view(to_canonical(t, x), op, rhs);
+    };
+    std::vector<bool> matches(column.dictionary.size());
+    for (size_t i = 0; i < matches.size(); ++i)
+      matches[i] = check(make_view(column.dictionary[i]));
+    auto null_matches = check(make_view(caf::none));
+    result_type result(slice_.rows());
+    for (size_t row = 0; row < result.size(); ++row) {
+      auto code = column.codes[row];
+      result[row] = code == dictionary_table_slice::null_code ? null_matches
+                                                               : matches[code];
+    }
+    return result;
+  }
+
+  const dictionary_table_slice& slice_;
+};
+
+} // namespace <anonymous>
+
 ids evaluate(const table_slice& slice, const expression& expr) {
   ids result;
   result.append(false, slice.offset());
+  if (auto x = dynamic_cast<const dictionary_table_slice*>(&slice)) {
+    for (auto bit : caf::visit(dictionary_slice_evaluator{*x}, expr))
+      result.append_bit(bit);
+    return result;
+  }
   for (size_t row = 0; row != slice.rows(); ++row)
     result.append_bit(evaluate_at(slice, row, expr));
   return result;
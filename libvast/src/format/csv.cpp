@@ -114,24 +114,29 @@ caf::error writer::write(const table_slice& x) {
       append(field.name);
     }
     append('\n');
-    write_buf();
+    if (auto err = emit(std::move(buf_)))
+      return err;
+    buf_.clear();
   }
   // Print the cell contents.
-  auto iter = std::back_inserter(buf_);
-  for (size_t row = 0; row < x.rows(); ++row) {
-    append(last_layout_);
-    append(separator);
-    if (auto err = render(iter, x.at(row, 0)))
-      return err;
-    for (size_t column = 1; column < x.columns(); ++column) {
-      append(separator);
-      if (auto err = render(iter, x.at(row, column)))
+  auto f = [separator, type = last_layout_](std::vector<char>& buf,
+                                            const table_slice& slice) {
+    auto iter = std::back_inserter(buf);
+    for (size_t row = 0; row < slice.rows(); ++row) {
+      buf.insert(buf.end(), type.begin(), type.end());
+      buf.push_back(separator);
+      if (auto err = render(iter, slice.at(row, 0)))
         return err;
+      for (size_t column = 1; column < slice.columns(); ++column) {
+        buf.push_back(separator);
+        if (auto err = render(iter, slice.at(row, column)))
+          return err;
+      }
+      buf.push_back('\n');
     }
-    append('\n');
-    write_buf();
-  }
-  return caf::none;
+    return caf::error{};
+  };
+  return print(x, std::move(f));
 }
 
 const char* writer::name() const {
@@ -177,6 +182,13 @@ const char* reader::name() const {
   return "csv-reader";
 }
 
+detail::line_chunker::policy reader::chunking_policy() {
+  // The first line contains the column names.
+  detail::line_chunker::policy result;
+  result.header_lines = 1;
+  return result;
+}
+
 caf::optional<record_type>
 reader::make_layout(const std::vector<std::string>& names) {
   for (auto& t : schema_) {
@@ -193,7 +193,7 @@ caf::error add(table_slice_builder& builder, const vast::json::object& xs,
     if (!x)
       return make_error(ec::convert_error, x.error().context(),
                         "could not convert", field.name, ":", to_string(*i));
-    if (!builder.add(make_data_view(*x)))
+    if (!builder.add(std::move(*x)))
       return make_error(ec::type_clash, "unexpected type", field.name, ":",
                         to_string(*i));
   }
@@ -34,6 +34,7 @@ caf::error multi_layout_reader::finish(consumer& f,
                                        table_slice_builder_ptr& builder_ptr,
                                        caf::error result) {
   if (builder_ptr != nullptr && builder_ptr->rows() > 0) {
+    last_slice_start_ = builder_ptr->first_value_time();
     auto ptr = builder_ptr->finish();
     // Override error in case we encounter an error in the builder.
     if (ptr == nullptr)
@@ -15,6 +15,9 @@
 
 #include "vast/error.hpp"
 
+#include <chrono>
+#include <ostream>
+
 namespace vast::format {
 
 ostream_writer::ostream_writer(ostream_ptr out) : out_(std::move(out)) {
@@ -22,12 +25,15 @@ ostream_writer::ostream_writer(ostream_ptr out) : out_(std::move(out)) {
 }
 
 ostream_writer::~ostream_writer() {
-  // nop
+  if (out_ != nullptr)
+    drain();
 }
 
 caf::expected<void> ostream_writer::flush() {
   if (out_ == nullptr)
     return make_error(ec::format_error, "no output stream available");
+  if (auto err = drain())
+    return err;
   out_->flush();
   if (!*out_)
     return make_error(ec::format_error, "failed to flush");
@@ -39,6 +45,70 @@ std::ostream& ostream_writer::out() {
   return *out_;
 }
 
+void ostream_writer::parallelize(std::shared_ptr<detail::thread_pool> pool) {
+  pool_ = std::move(pool);
+}
+
+caf::error ostream_writer::print(const table_slice& xs, renderer f) {
+  if (pool_ == nullptr) {
+    // Without a pool, we render the whole slice and write it at once.
+    if (auto err = f(buf_, xs)) {
+      buf_.clear();
+      return err;
+    }
+    write_buf();
+    return caf::none;
+  }
+  // Keep the slice alive until the worker is done with it.
+  auto slice = caf::intrusive_ptr<const table_slice>{&xs};
+  pending_.push_back(pool_->async(
+    [slice = std::move(slice),
+     f = std::move(f)]() mutable -> caf::expected<std::vector<char>> {
+      std::vector<char> buf;
+      if (auto err = f(buf, *slice))
+        return err;
+      return buf;
+    }));
+  // Bound the memory held by rendered but unwritten slices.
+  return write_pending(2 * pool_->size());
+}
+
+caf::error ostream_writer::emit(std::vector<char> buf) {
+  if (pending_.empty()) {
+    VAST_ASSERT(out_ != nullptr);
+    out_->write(buf.data(), buf.size());
+    return caf::none;
+  }
+  std::promise<caf::expected<std::vector<char>>> ready;
+  ready.set_value(std::move(buf));
+  pending_.push_back(ready.get_future());
+  return caf::none;
+}
+
+caf::error ostream_writer::drain() {
+  return write_pending(0);
+}
+
+caf::error ostream_writer::write_pending(size_t max_pending) {
+  VAST_ASSERT(out_ != nullptr);
+  while (!pending_.empty()) {
+    auto& front = pending_.front();
+    if (pending_.size() <= max_pending
+        && front.wait_for(std::chrono::seconds::zero())
+             != std::future_status::ready)
+      break;
+    auto buf = front.get();
+    pending_.pop_front();
+    if (!buf) {
+      // The output would have a gap, so we discard everything after it.
+      pending_.clear();
+      return std::move(buf.error());
+    }
+    out_->write(buf->data(), buf->size());
+  }
+  return caf::none;
+}
+
 void ostream_writer::write_buf() {
   VAST_ASSERT(out_ != nullptr);
   out_->write(buf_.data(), buf_.size());
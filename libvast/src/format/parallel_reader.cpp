@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/format/parallel_reader.hpp"
+
+#include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace vast::format {
+
+parallel_reader::parallel_reader(caf::atom_value table_slice_type,
+                                 std::unique_ptr<std::istream> in,
+                                 detail::line_chunker::policy policy,
+                                 reader_factory factory, size_t num_workers,
+                                 size_t chunk_size, bool ordered)
+  : reader(table_slice_type),
+    input_{std::move(in)},
+    chunker_{*input_, std::move(policy)},
+    factory_{std::move(factory)},
+    chunk_size_{chunk_size},
+    ordered_{ordered},
+    workers_{std::make_unique<detail::thread_pool>(num_workers)} {
+  VAST_ASSERT(factory_ != nullptr);
+  VAST_ASSERT(chunk_size_ > 0);
+  // The prototype answers schema and name requests on behalf of the readers
+  // that run on the workers.
+  prototype_ = factory_(std::make_unique<std::istringstream>());
+}
+
+parallel_reader::~parallel_reader() {
+  // Wait for all workers before tearing down the results.
+  for (auto& x : in_flight_)
+    x.wait();
+}
+
+caf::error parallel_reader::schema(vast::schema x) {
+  if (auto err = prototype_->schema(x))
+    return err;
+  schema_ = std::move(x);
+  return caf::none;
+}
+
+vast::schema parallel_reader::schema() const {
+  return prototype_->schema();
+}
+
+const char* parallel_reader::name() const {
+  return prototype_->name();
+}
+
+caf::error parallel_reader::read_impl(size_t max_events, size_t max_slice_size,
+                                      consumer& f) {
+  size_t produced = 0;
+  while (produced < max_events) {
+    if (ready_.empty()) {
+      if (error_)
+        return std::exchange(error_, caf::none);
+      dispatch(max_slice_size);
+      if (in_flight_.empty())
+        return make_error(ec::end_of_input, "input exhausted");
+      collect();
+      continue;
+    }
+    auto x = std::move(ready_.front());
+    ready_.pop_front();
+    // Never exceed the event limit of the caller.
+    if (x.slice->rows() > max_events - produced) {
+      auto [head, tail] = split(x.slice, max_events - produced);
+      ready_.push_front({std::move(tail), x.start});
+      x.slice = std::move(head);
+    }
+    produced += x.slice->rows();
+    last_slice_start_ = x.start;
+    f(std::move(x.slice));
+  }
+  // Keep the workers busy while the caller processes our slices.
+  dispatch(max_slice_size);
+  return caf::none;
+}
+
+void parallel_reader::dispatch(size_t max_slice_size) {
+  // Buffering two chunks per worker avoids idle workers in between calls.
+  auto max_in_flight = 2 * workers_->size();
+  while (in_flight_.size() < max_in_flight && !chunker_.done()) {
+    auto chunk = chunker_.next(chunk_size_);
+    if (chunk.empty())
+      break;
+    auto job = [factory = factory_, sch = schema_, chunk = std::move(chunk),
+                max_slice_size]() mutable {
+      chunk_result result;
+      auto rd = factory(std::make_unique<std::istringstream>(std::move(chunk)));
+      if (!sch.empty())
+        if (auto err = rd->schema(std::move(sch))) {
+          result.error = std::move(err);
+          return result;
+        }
+      auto push_slice = [&](table_slice_ptr x) {
+        result.slices.push_back({std::move(x), rd->last_slice_start()});
+      };
+      auto err = rd->read(std::numeric_limits<size_t>::max(), max_slice_size,
+                          push_slice)
+                   .first;
+      if (err != ec::end_of_input)
+        result.error = std::move(err);
+      return result;
+    };
+    in_flight_.push_back(workers_->async(std::move(job)));
+  }
+}
+
+void parallel_reader::collect() {
+  VAST_ASSERT(!in_flight_.empty());
+  auto i = in_flight_.begin();
+  if (!ordered_) {
+    // Prefer any chunk that is already done over waiting for the oldest one.
+    using namespace std::chrono_literals;
+    auto is_ready = [](auto& x) {
+      return x.wait_for(0s) == std::future_status::ready;
+    };
+    if (auto j = std::find_if(in_flight_.begin(), in_flight_.end(), is_ready);
+        j != in_flight_.end())
+      i = j;
+  }
+  auto result = i->get();
+  in_flight_.erase(i);
+  for (auto& x : result.slices)
+    ready_.push_back(std::move(x));
+  if (result.error) {
+    VAST_WARNING(this, "failed to parse chunk:", render(result.error));
+    error_ = std::move(result.error);
+  }
+}
+
+} // namespace vast::format
@@ -15,6 +15,7 @@
 
 #include "vast/byte.hpp"
 #include "vast/community_id.hpp"
+#include "vast/data.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
@@ -30,6 +31,7 @@
 #include <caf/config_value.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <thread>
 #include <utility>
 
@@ -200,6 +202,7 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
 #endif
       if (!pcap_) {
         flows_.clear();
+        timeouts_.clear();
         return make_error(ec::format_error, "failed to open pcap file ", input_,
                           ": ", std::string{buf});
       }
@@ -213,15 +216,12 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
     VAST_DEBUG(this, "evicts flows after", max_age_ << "s of inactivity");
     VAST_DEBUG(this, "expires flow table every", expire_interval_ << "s");
   }
-  for (size_t produced = 0; produced < max_events; ++produced) {
-    // Attempt to fetch next packet.
-    const u_char* data;
-    pcap_pkthdr* header;
-    auto r = ::pcap_next_ex(pcap_, &header, &data);
-    if (r == 0)
-      return finish(f, caf::none); // timed out
-    if (r == -2)
-      return finish(f, make_error(ec::end_of_input, "reached end of trace"));
+  for (size_t produced = 0; produced < max_events;) {
+    // Capture a batch of packets.
+    batch_.clear();
+    auto n = std::min(max_events - produced, max_slice_size);
+    auto r = ::pcap_dispatch(pcap_, static_cast<int>(n), capture,
+                             reinterpret_cast<u_char*>(this));
     if (r == -1) {
       auto err = std::string{::pcap_geterr(pcap_)};
       ::pcap_close(pcap_);
@@ -229,193 +229,268 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       return finish(f, make_error(ec::format_error,
                                   "failed to get next packet: ", err));
     }
-    // Parse frame.
-    span<const byte> frame{reinterpret_cast<const byte*>(data), header->len};
-    frame = decapsulate(frame, frame_type::ethernet);
-    if (frame.empty())
-      return make_error(ec::format_error, "failed to decapsulate frame");
-    constexpr size_t ethernet_header_size = 14;
-    auto layer3 = frame.subspan<ethernet_header_size>();
-    span<const byte> layer4;
-    uint8_t layer4_proto = 0;
-    flow conn;
-    // Parse layer 3.
-    switch (as_ether_type(frame.subspan<12, 2>())) {
-      default: {
-        VAST_DEBUG(this, "skips non-IP packet");
-        continue;
-      }
-      case ether_type::ipv4: {
-        constexpr size_t ipv4_header_size = 20;
-        if (header->len < ethernet_header_size + ipv4_header_size)
-          return make_error(ec::format_error, "IPv4 header too short");
-        size_t header_size = (to_integer<uint8_t>(layer3[0]) & 0x0f) * 4;
-        if (header_size < ipv4_header_size)
-          return make_error(ec::format_error,
-                            "IPv4 header too short: ", header_size, " bytes");
-        auto orig_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 12));
-        auto resp_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 16));
-        conn.src_addr = {orig_h, address::ipv4, address::network};
-        conn.dst_addr = {resp_h, address::ipv4, address::network};
-        layer4_proto = to_integer<uint8_t>(layer3[9]);
-        layer4 = layer3.subspan(header_size);
-        break;
-      }
-      case ether_type::ipv6: {
-        if (header->len < ethernet_header_size + 40)
-          return make_error(ec::format_error, "IPv6 header too short");
-        auto orig_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 8));
-        auto resp_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 24));
-        conn.src_addr = {orig_h, address::ipv4, address::network};
-        conn.dst_addr = {resp_h, address::ipv4, address::network};
-        layer4_proto = to_integer<uint8_t>(layer3[6]);
-        layer4 = layer3.subspan(40);
-        break;
-      }
-    }
-    // Parse layer 4.
-    auto payload_size = layer4.size();
-    if (layer4_proto == IPPROTO_TCP) {
-      VAST_ASSERT(!layer4.empty());
-      auto orig_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
-      auto resp_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
-      orig_p = detail::to_host_order(orig_p);
-      resp_p = detail::to_host_order(resp_p);
-      conn.src_port = {orig_p, port::tcp};
-      conn.dst_port = {resp_p, port::tcp};
-      auto data_offset
-        = *reinterpret_cast<const uint8_t*>(std::launder(layer4.data() + 12))
-          >> 4;
-      payload_size -= data_offset * 4;
-    } else if (layer4_proto == IPPROTO_UDP) {
-      VAST_ASSERT(!layer4.empty());
-      auto orig_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
-      auto resp_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
-      orig_p = detail::to_host_order(orig_p);
-      resp_p = detail::to_host_order(resp_p);
-      conn.src_port = {orig_p, port::udp};
-      conn.dst_port = {resp_p, port::udp};
-      payload_size -= 8;
-    } else if (layer4_proto == IPPROTO_ICMP) {
-      VAST_ASSERT(!layer4.empty());
-      auto message_type = to_integer<uint8_t>(layer4[0]);
-      auto message_code = to_integer<uint8_t>(layer4[1]);
-      conn.src_port = {message_type, port::icmp};
-      conn.dst_port = {message_code, port::icmp};
-      payload_size -= 8; // TODO: account for variable-size data.
-    }
-    // Parse packet timestamp
-    uint64_t packet_time = header->ts.tv_sec;
-    if (last_expire_ == 0)
-      last_expire_ = packet_time;
-    if (!update_flow(conn, packet_time, payload_size)) {
-      // Skip cut off packets.
-      continue;
-    }
-    evict_inactive(packet_time);
-    shrink_to_max_size();
-    // Extract timestamp.
-    using namespace std::chrono;
-    auto secs = seconds(header->ts.tv_sec);
-    auto ts = time{duration_cast<duration>(secs)};
-#ifdef PCAP_TSTAMP_PRECISION_NANO
-    ts += nanoseconds(header->ts.tv_usec);
-#else
-    ts += microseconds(header->ts.tv_usec);
-#endif
-    // Assemble packet.
-    auto layer3_ptr = reinterpret_cast<const char*>(layer3.data());
-    auto packet = std::string_view{std::launder(layer3_ptr), layer3.size()};
-    auto& cid = state(conn).community_id;
-    if (!(builder_->add(ts) && builder_->add(conn.src_addr)
-          && builder_->add(conn.dst_addr) && builder_->add(conn.src_port)
-          && builder_->add(conn.dst_port)
-          && (!community_id_ || builder_->add(std::string_view{cid}))
-          && builder_->add(packet))) {
-      return make_error(ec::parse_error, "unable to fill row");
+    if (batch_.size() == 0) {
+      if (interface_)
+        return finish(f, caf::none); // timed out
+      return finish(f, make_error(ec::end_of_input, "reached end of trace"));
     }
+    produced += batch_.size();
+    // Pace the batch as a whole in pseudo-realtime mode.
     if (pseudo_realtime_ > 0) {
-      if (ts < last_timestamp_) {
+      auto first = batch_.timestamps.front();
+      auto last = batch_.timestamps.back();
+      if (first < last_timestamp_) {
         VAST_WARNING(this, "encountered non-monotonic packet timestamps:",
-                     ts.time_since_epoch().count(), '<',
+                     first.time_since_epoch().count(), '<',
                      last_timestamp_.time_since_epoch().count());
       }
       if (last_timestamp_ != time::min()) {
-        auto delta = ts - last_timestamp_;
+        auto delta = last - last_timestamp_;
         std::this_thread::sleep_for(delta / pseudo_realtime_);
       }
-      last_timestamp_ = ts;
+      last_timestamp_ = last;
+    }
+    // Update the flow table and fill the builder.
+    builder_->reserve(max_slice_size);
+    for (size_t i = 0; i < batch_.size(); ++i) {
+      auto& packet = batch_.layer3[i];
+      if (packet.empty())
+        continue;
+      auto& conn = batch_.flows[i];
+      auto packet_time = batch_.seconds[i];
+      if (last_expire_ == 0)
+        last_expire_ = packet_time;
+      // Expire flows before the lookup, such that a packet after the maximum
+      // flow age of inactivity starts a new flow.
+      evict_inactive(packet_time);
+      auto st = update_flow(conn, packet_time, batch_.payload_sizes[i]);
+      if (!st) {
+        // Skip cut off packets.
+        continue;
+      }
+      if (!(builder_->add(batch_.timestamps[i]) && builder_->add(conn.src_addr)
+            && builder_->add(conn.dst_addr) && builder_->add(conn.src_port)
+            && builder_->add(conn.dst_port)
+            && (!community_id_ || builder_->add(st->community_id()))
+            && builder_->add(data{std::move(packet)}))) {
+        return make_error(ec::parse_error, "unable to fill row");
+      }
+      if (builder_->rows() == max_slice_size)
+        if (auto err = finish(f, caf::none))
+          return err;
     }
-    if (builder_->rows() == max_slice_size)
-      if (auto err = finish(f, caf::none))
-        return err;
   }
   return finish(f, caf::none);
 }
 
-reader::flow_state& reader::state(const flow& x) {
-  auto i = flows_.find(x);
-  if (i == flows_.end()) {
-    auto cf = flow{x.src_addr, x.dst_addr, x.src_port, x.dst_port};
-    auto id = community_id::compute<policy::base64>(cf);
-    i = flows_.emplace(x, flow_state{0, 0, std::move(id)}).first;
+void reader::packet_batch::clear() {
+  timestamps.clear();
+  seconds.clear();
+  flows.clear();
+  payload_sizes.clear();
+  layer3.clear();
+}
+
+void reader::capture(u_char* self, const pcap_pkthdr* header,
+                     const u_char* data) {
+  auto& rd = *reinterpret_cast<reader*>(self);
+  auto& xs = rd.batch_;
+  using namespace std::chrono;
+  auto ts = time{duration_cast<duration>(seconds(header->ts.tv_sec))};
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+  ts += nanoseconds(header->ts.tv_usec);
+#else
+  ts += microseconds(header->ts.tv_usec);
+#endif
+  xs.timestamps.push_back(ts);
+  xs.seconds.push_back(header->ts.tv_sec);
+  xs.flows.emplace_back();
+  xs.payload_sizes.push_back(0);
+  xs.layer3.emplace_back();
+  if (auto err = rd.decode(data, header->caplen)) {
+    VAST_WARNING(&rd, "skips malformed packet:", render(err));
+    xs.layer3.back().clear();
+  }
+}
+
+caf::error reader::decode(const u_char* data, size_t size) {
+  // Parse frame.
+  span<const byte> frame{reinterpret_cast<const byte*>(data), size};
+  frame = decapsulate(frame, frame_type::ethernet);
+  if (frame.empty())
+    return make_error(ec::format_error, "failed to decapsulate frame");
+  constexpr size_t ethernet_header_size = 14;
+  auto layer3 = frame.subspan<ethernet_header_size>();
+  span<const byte> layer4;
+  uint8_t layer4_proto = 0;
+  auto& conn = batch_.flows.back();
+  // Parse layer 3.
+  switch (as_ether_type(frame.subspan<12, 2>())) {
+    default: {
+      VAST_DEBUG(this, "skips non-IP packet");
+      return caf::none;
+    }
+    case ether_type::ipv4: {
+      constexpr size_t ipv4_header_size = 20;
+      if (size < ethernet_header_size + ipv4_header_size)
+        return make_error(ec::format_error, "IPv4 header too short");
+      size_t header_size = (to_integer<uint8_t>(layer3[0]) & 0x0f) * 4;
+      if (header_size < ipv4_header_size)
+        return make_error(ec::format_error,
+                          "IPv4 header too short: ", header_size, " bytes");
+      auto orig_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 12));
+      auto resp_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 16));
+      conn.src_addr = {orig_h, address::ipv4, address::network};
+      conn.dst_addr = {resp_h, address::ipv4, address::network};
+      layer4_proto = to_integer<uint8_t>(layer3[9]);
+      layer4 = layer3.subspan(header_size);
+      break;
+    }
+    case ether_type::ipv6: {
+      if (size < ethernet_header_size + 40)
+        return make_error(ec::format_error, "IPv6 header too short");
+      auto orig_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 8));
+      auto resp_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 24));
+      conn.src_addr = {orig_h, address::ipv6, address::network};
+      conn.dst_addr = {resp_h, address::ipv6, address::network};
+      layer4_proto = to_integer<uint8_t>(layer3[6]);
+      layer4 = layer3.subspan(40);
+      break;
+    }
   }
-  return i->second;
+  // Parse layer 4.
+  auto payload_size = layer4.size();
+  if (layer4_proto == IPPROTO_TCP) {
+    VAST_ASSERT(!layer4.empty());
+    auto orig_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
+    auto resp_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
+    orig_p = detail::to_host_order(orig_p);
+    resp_p = detail::to_host_order(resp_p);
+    conn.src_port = {orig_p, port::tcp};
+    conn.dst_port = {resp_p, port::tcp};
+    auto data_offset
+      = *reinterpret_cast<const uint8_t*>(std::launder(layer4.data() + 12))
+        >> 4;
+    payload_size -= data_offset * 4;
+  } else if (layer4_proto == IPPROTO_UDP) {
+    VAST_ASSERT(!layer4.empty());
+    auto orig_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
+    auto resp_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
+    orig_p = detail::to_host_order(orig_p);
+    resp_p = detail::to_host_order(resp_p);
+    conn.src_port = {orig_p, port::udp};
+    conn.dst_port = {resp_p, port::udp};
+    payload_size -= 8;
+  } else if (layer4_proto == IPPROTO_ICMP) {
+    VAST_ASSERT(!layer4.empty());
+    auto message_type = to_integer<uint8_t>(layer4[0]);
+    auto message_code = to_integer<uint8_t>(layer4[1]);
+    conn.src_port = {message_type, port::icmp};
+    conn.dst_port = {message_code, port::icmp};
+    payload_size -= 8; // TODO: account for variable-size data.
+  }
+  batch_.payload_sizes.back() = payload_size;
+  auto layer3_ptr = reinterpret_cast<const char*>(layer3.data());
+  batch_.layer3.back().assign(std::launder(layer3_ptr), layer3.size());
+  return caf::none;
 }
 
-bool reader::update_flow(const flow& x, uint64_t packet_time,
-                         uint64_t payload_size) {
-  auto& st = state(x);
+reader::flow_state* reader::update_flow(const flow& x, uint64_t packet_time,
+                                        uint64_t payload_size) {
+  auto i = flows_.find(x);
+  if (i == flows_.end()) {
+    shrink_to_max_size();
+    flow_state st;
+    st.bytes = 0;
+    st.community_id_length = 0;
+    if (community_id_) {
+      auto cf = flow{x.src_addr, x.dst_addr, x.src_port, x.dst_port};
+      auto id = community_id::compute<policy::base64>(cf);
+      VAST_ASSERT(id.size() <= max_community_id_length);
+      std::copy(id.begin(), id.end(), st.community_id_data.begin());
+      st.community_id_length = static_cast<uint8_t>(id.size());
+    }
+    i = flows_.emplace(x, st).first;
+    if (timeouts_.empty() || timeouts_.back().first < packet_time)
+      timeouts_.emplace_back(packet_time, std::vector<flow>{});
+    timeouts_.back().second.push_back(x);
+  }
+  auto& st = i.value();
   st.last = packet_time;
   auto& flow_size = st.bytes;
   if (flow_size == cutoff_)
-    return false;
+    return nullptr;
   VAST_ASSERT(flow_size < cutoff_);
   // Trim the packet if needed.
   flow_size += std::min(payload_size, cutoff_ - flow_size);
-  return true;
+  return &st;
 }
 
 void reader::evict_inactive(uint64_t packet_time) {
   if (packet_time - last_expire_ <= expire_interval_)
     return;
   last_expire_ = packet_time;
-  auto i = flows_.begin();
-  while (i != flows_.end())
-    if (packet_time - i->second.last > max_age_)
-      i = flows_.erase(i);
-    else
-      ++i;
+  auto expired = [&](uint64_t t) { return t + max_age_ < packet_time; };
+  // Only the oldest groups can contain inactive flows. Flows that were active
+  // since their scheduling go back into the group matching their last
+  // activity.
+  while (!timeouts_.empty() && expired(timeouts_.front().first)) {
+    auto xs = std::move(timeouts_.front().second);
+    timeouts_.pop_front();
+    for (auto& x : xs) {
+      auto i = flows_.find(x);
+      VAST_ASSERT(i != flows_.end());
+      auto last = i->second.last;
+      if (expired(last))
+        flows_.erase(i);
+      else
+        reschedule(x, last);
+    }
+  }
 }
 
 void reader::shrink_to_max_size() {
-  while (flows_.size() >= max_flows_) {
-    auto buckets = flows_.bucket_count();
-    auto unif1 = std::uniform_int_distribution<size_t>{0, buckets - 1};
-    auto bucket = unif1(generator_);
-    auto bucket_size = flows_.bucket_size(bucket);
-    while (bucket_size == 0) {
-      ++bucket;
-      bucket %= buckets;
-      bucket_size = flows_.bucket_size(bucket);
+  // Evict the least recently active flows. The front group holds the oldest
+  // schedules, but flows that were active since then move on to the group of
+  // their last activity.
+  while (flows_.size() >= max_flows_ && !timeouts_.empty()) {
+    auto scheduled = timeouts_.front().first;
+    auto& xs = timeouts_.front().second;
+    if (xs.empty()) {
+      timeouts_.pop_front();
+      continue;
     }
-    auto unif2 = std::uniform_int_distribution<size_t>{0, bucket_size - 1};
-    auto offset = unif2(generator_);
-    VAST_ASSERT(offset < bucket_size);
-    auto begin = flows_.begin(bucket);
-    std::advance(begin, offset);
-    flows_.erase(begin->first);
+    auto x = xs.back();
+    xs.pop_back();
+    auto i = flows_.find(x);
+    VAST_ASSERT(i != flows_.end());
+    if (auto last = i->second.last; last > scheduled)
+      reschedule(x, last);
+    else
+      flows_.erase(i);
   }
 }
 
+void reader::reschedule(const flow& x, uint64_t last) {
+  // We only ever append groups, so that references to the front group remain
+  // valid. Flows may land in a slightly younger group, which only delays
+  // their next check.
+  auto pred = [](auto& group, uint64_t t) { return group.first < t; };
+  auto i = std::lower_bound(timeouts_.begin(), timeouts_.end(), last, pred);
+  if (i == timeouts_.end())
+    timeouts_.emplace_back(last, std::vector<flow>{x});
+  else
+    i->second.push_back(x);
+}
+
 writer::writer(std::string trace, size_t flush_interval, size_t snaplen)
   : flush_interval_{flush_interval}, snaplen_{snaplen}, trace_{std::move(trace)} {
 }
@@ -32,6 +32,7 @@ single_layout_reader::~single_layout_reader() {
 
 caf::error single_layout_reader::finish(consumer& f, caf::error result) {
   if (builder_ != nullptr && builder_->rows() > 0) {
+    last_slice_start_ = builder_->first_value_time();
     auto ptr = builder_->finish();
     // Override error in case we encounter an error in the builder.
     if (ptr == nullptr)
@@ -13,6 +13,10 @@
 
 #include "vast/format/writer.hpp"
 
+#include <caf/settings.hpp>
+
+#include "vast/defaults.hpp"
+#include "vast/detail/thread_pool.hpp"
 #include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/table_slice.hpp"
@@ -28,4 +32,16 @@ caf::expected<void> writer::flush() {
   return caf::no_error;
 }
 
+void writer::parallelize(std::shared_ptr<detail::thread_pool>) {
+  // nop
+}
+
+void parallelize(writer& x, const caf::settings& options,
+                 const std::string& category) {
+  auto parallel
+    = get_or(options, category + ".parallel", defaults::export_::parallel);
+  if (parallel > 0)
+    x.parallelize(std::make_shared<detail::thread_pool>(parallel));
+}
+
 } // namespace vast::format
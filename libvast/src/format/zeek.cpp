@@ -34,6 +34,7 @@
 
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 namespace vast::format::zeek {
 
@@ -221,6 +222,15 @@ const char* reader::name() const {
   return "zeek-reader";
 }
 
+detail::line_chunker::policy reader::chunking_policy() {
+  // Every log starts with a #separator line, followed by further header lines.
+  // Other comments, e.g., #close, do not belong to the header.
+  detail::line_chunker::policy result;
+  result.header_marker = "#separator";
+  result.comment_prefix = "#";
+  return result;
+}
+
 void reader::patch(std::vector<data>& xs) {
   auto protocol = port::unknown;
   // Get the protocol from the proto field if available.
@@ -271,8 +281,10 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
     if (lines_->done())
       return make_error(ec::end_of_input, "input exhausted");
   }
-  // Local buffer for parsing records.
-  std::vector<data> xs;
+  // Scratch buffers for parsing records, whose storage we reuse across lines
+  // and batches.
+  auto& fields = fields_;
+  auto& xs = values_;
   // Counts successfully parsed records.
   size_t produced = 0;
   // Loop until reaching EOF or the configured limit of records.
@@ -313,7 +325,7 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       // Ignore comments.
       VAST_DEBUG(this, "ignores comment at line", lines_->line_number());
     } else {
-      auto fields = detail::split(lines_->get(), separator_);
+      detail::split(fields, lines_->get(), separator_);
       if (fields.size() != parsers_.size()) {
         VAST_WARNING(this, "ignores invalid record at line",
                      lines_->line_number(), ':', "got", fields.size(),
@@ -341,8 +353,10 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
                                         std::string{fields[i]}));
       }
       patch(xs);
+      // The builder takes ownership of the parsed values, which the next line
+      // overwrites anyway.
       for (size_t i = 0; i < fields.size(); ++i) {
-        if (!builder_->add(make_data_view(xs[i])))
+        if (!builder_->add(std::move(xs[i])))
           return finish(f, make_error(ec::type_clash, "field", i, "line",
                                       lines_->line_number(),
                                       std::string{fields[i]}));
@@ -587,8 +601,15 @@ public:
   using super::super;
 
   ~writer_child() override {
-    if (out_ != nullptr)
+    if (out_ != nullptr) {
+      drain();
       *out_ << "#close" << separator << time_factory{} << '\n';
+    }
+  }
+
+  /// Writes `header` after all previously written slices.
+  caf::error write_header(const std::string& header) {
+    return emit(std::vector<char>(header.begin(), header.end()));
   }
 
   error write(const table_slice& slice) override {
@@ -610,12 +631,19 @@ caf::error writer::write(const table_slice& slice) {
     if (writers_.empty()) {
       VAST_DEBUG(this, "creates a new stream for STDOUT");
       auto out = std::make_unique<detail::fdostream>(1);
-      writers_.emplace(slice.layout().name(),
-                       std::make_unique<writer_child>(std::move(out)));
+      auto stdout_child = std::make_unique<writer_child>(std::move(out));
+      stdout_child->parallelize(pool_);
+      writers_.emplace(slice.layout().name(), std::move(stdout_child));
     }
     child = writers_.begin()->second.get();
     if (slice.layout() != previous_layout_) {
-      print_header(slice.layout(), child->out());
+      // Slices of the previous layout may still be rendering, so the header
+      // has to queue up behind them.
+      std::ostringstream header;
+      print_header(slice.layout(), header);
+      auto err = static_cast<writer_child*>(child)->write_header(header.str());
+      if (err)
+        return err;
       previous_layout_ = slice.layout();
     }
   } else {
@@ -634,8 +662,9 @@ caf::error writer::write(const table_slice& slice) {
       auto filename = dir_ / (slice.layout().name() + ".log");
       auto fos = std::make_unique<std::ofstream>(filename.str());
       print_header(slice.layout(), *fos);
-      auto i = writers_.emplace(slice.layout().name(),
-                                std::make_unique<writer_child>(std::move(fos)));
+      auto layout_child = std::make_unique<writer_child>(std::move(fos));
+      layout_child->parallelize(pool_);
+      auto i = writers_.emplace(slice.layout().name(), std::move(layout_child));
       child = i.first->second.get();
     }
   }
@@ -650,6 +679,12 @@ caf::expected<void> writer::flush() {
   return caf::no_error;
 }
 
+void writer::parallelize(std::shared_ptr<detail::thread_pool> pool) {
+  pool_ = std::move(pool);
+  for (auto& kvp : writers_)
+    kvp.second->parallelize(pool_);
+}
+
 const char* writer::name() const {
   return "zeek-writer";
 }
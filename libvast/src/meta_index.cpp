@@ -23,9 +23,73 @@
 #include "vast/system/atoms.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/time.hpp"
+#include "vast/time_synopsis.hpp"
+
+#include <algorithm>
+#include <future>
+#include <tuple>
+#include <utility>
 
 namespace vast {
 
+namespace {
+
+/// The minimum number of rows that we hand to a single thread.
+constexpr size_t min_rows_per_job = 16'384;
+
+/// Checks whether a time synopsis answers `op` by comparing with its bounds.
+bool is_comparison(relational_operator op) {
+  switch (op) {
+    default:
+      return false;
+    case equal:
+    case not_equal:
+    case less:
+    case less_equal:
+    case greater:
+    case greater_equal:
+      return true;
+  }
+}
+
+/// Marks all rows in [first, last) whose bounds may contain values that
+/// satisfy `op` with `x`, following the semantics of `min_max_synopsis`.
+/// Dispatching on the operator outside of the loop leaves a branch-free loop
+/// body that the compiler can vectorize.
+void scan_ranges(const int64_t* mins, const int64_t* maxs, size_t first,
+                 size_t last, relational_operator op, int64_t x,
+                 uint8_t* hits) {
+  auto run = [&](auto pred) {
+    for (auto i = first; i < last; ++i)
+      hits[i] |= static_cast<uint8_t>(pred(mins[i], maxs[i]));
+  };
+  switch (op) {
+    default:
+      VAST_ASSERT(!"unsupported operator");
+      break;
+    case equal:
+      run([x](int64_t min, int64_t max) { return (min <= x) & (x <= max); });
+      break;
+    case not_equal:
+      run([x](int64_t min, int64_t max) { return (min > x) | (x > max); });
+      break;
+    case less:
+      run([x](int64_t min, int64_t) { return min < x; });
+      break;
+    case less_equal:
+      run([x](int64_t min, int64_t) { return min <= x; });
+      break;
+    case greater:
+      run([x](int64_t, int64_t max) { return max > x; });
+      break;
+    case greater_equal:
+      run([x](int64_t, int64_t max) { return max >= x; });
+      break;
+  }
+}
+
+} // namespace <anonymous>
+
 void meta_index::add(const uuid& partition, const table_slice& slice) {
   auto& part_synopsis = partition_synopses_[partition];
   auto& layout = slice.layout();
@@ -62,6 +126,82 @@ void meta_index::add(const uuid& partition, const table_slice& slice) {
         if (!caf::holds_alternative<caf::none_t>(view))
           syn->add(std::move(view));
       }
+  update_columns(partition, layout, *table_syn);
+}
+
+void meta_index::update_columns(const uuid& partition,
+                                const record_type& layout,
+                                const table_synopsis& table_syn) {
+  auto& cols = columns_[layout];
+  if (cols.columns.empty())
+    cols.columns.resize(table_syn.size());
+  VAST_ASSERT(cols.columns.size() == table_syn.size());
+  auto to_ranges = [](const synopsis_ptr& syn) {
+    auto ts = static_cast<const time_synopsis*>(syn.get());
+    return std::pair{ts->min().time_since_epoch().count(),
+                     ts->max().time_since_epoch().count()};
+  };
+  auto [i, added] = cols.rows.emplace(partition, cols.partitions.size());
+  if (added) {
+    cols.partitions.push_back(partition);
+    for (size_t col = 0; col < table_syn.size(); ++col) {
+      auto& c = cols.columns[col];
+      auto& syn = table_syn[col];
+      c.synopses.push_back(syn);
+      if (!c.has_ranges)
+        continue;
+      if (dynamic_cast<const time_synopsis*>(syn.get()) == nullptr) {
+        c.has_ranges = false;
+        c.mins = {};
+        c.maxs = {};
+        continue;
+      }
+      auto [min, max] = to_ranges(syn);
+      c.mins.push_back(min);
+      c.maxs.push_back(max);
+    }
+  } else {
+    auto row = i->second;
+    for (auto& c : cols.columns)
+      if (c.has_ranges)
+        std::tie(c.mins[row], c.maxs[row]) = to_ranges(c.synopses[row]);
+  }
+}
+
+void meta_index::rebuild_columns() {
+  columns_.clear();
+  for (auto& [part_id, part_syn] : partition_synopses_)
+    for (auto& [layout, table_syn] : part_syn)
+      update_columns(part_id, layout, table_syn);
+}
+
+void meta_index::scan(const column& col, relational_operator op, time x,
+                      std::vector<uint8_t>& hits) const {
+  VAST_ASSERT(col.has_ranges);
+  auto rows = hits.size();
+  auto mins = col.mins.data();
+  auto maxs = col.maxs.data();
+  auto rhs = x.time_since_epoch().count();
+  auto out = hits.data();
+  auto jobs = pool_ ? std::min(pool_->size() + 1, rows / min_rows_per_job)
+                    : size_t{1};
+  if (jobs <= 1) {
+    scan_ranges(mins, maxs, 0, rows, op, rhs, out);
+    return;
+  }
+  // Every job writes to a disjoint range of bytes, so we need no locking. The
+  // calling thread scans the first range itself.
+  auto step = (rows + jobs - 1) / jobs;
+  std::vector<std::future<void>> pending;
+  pending.reserve(jobs - 1);
+  for (auto first = step; first < rows; first += step) {
+    auto last = std::min(first + step, rows);
+    pending.push_back(pool_->async(
+      [=] { scan_ranges(mins, maxs, first, last, op, rhs, out); }));
+  }
+  scan_ranges(mins, maxs, 0, step, op, rhs, out);
+  for (auto& f : pending)
+    f.get();
 }
 
 std::vector<uuid> meta_index::lookup(const expression& expr) const {
@@ -118,25 +258,41 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
       auto search = [&](auto match) {
         VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
         auto& rhs = caf::get<data>(x.rhs);
+        // Time bounds support scanning only for plain comparisons.
+        auto ts = caf::get_if<time>(&rhs);
+        auto scannable = ts != nullptr && is_comparison(x.op);
         result_type result;
         auto found_matching_synopsis = false;
-        // We factor the nested loop into a lambda so that we can abort
-        // the iteration more easily with a return statement.
-        auto lookup = [&](auto& part_id, auto& part_syn) {
-          for (auto& [layout, table_syn] : part_syn)
-            for (size_t i = 0; i < table_syn.size(); ++i)
-              if (table_syn[i] && match(layout.fields[i])) {
+        std::vector<uint8_t> hits;
+        for (auto& [layout, cols] : columns_) {
+          auto rows = cols.partitions.size();
+          hits.assign(rows, 0);
+          for (size_t i = 0; i < cols.columns.size(); ++i) {
+            if (!match(layout.fields[i]))
+              continue;
+            auto& col = cols.columns[i];
+            if (col.has_ranges && scannable) {
+              found_matching_synopsis = true;
+              scan(col, x.op, *ts, hits);
+              continue;
+            }
+            for (size_t row = 0; row < rows; ++row)
+              if (auto& syn = col.synopses[row]) {
                 found_matching_synopsis = true;
-                auto opt = table_syn[i]->lookup(x.op, make_view(rhs));
-                if (!opt || *opt) {
-                  result.push_back(part_id);
-                  return;
-                }
+                if (hits[row])
+                  continue;
+                auto opt = syn->lookup(x.op, make_view(rhs));
+                if (!opt || *opt)
+                  hits[row] = 1;
               }
-        };
-        for (auto& [part_id, part_syn] : partition_synopses_)
-          lookup(part_id, part_syn);
+          }
+          for (size_t row = 0; row < rows; ++row)
+            if (hits[row])
+              result.push_back(cols.partitions[row]);
+        }
+        // A partition appears once per layout.
         std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
         return found_matching_synopsis ? result : all_partitions();
       };
       auto extract_expr = detail::overload(
@@ -148,12 +304,13 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
             return search(pred);
           } else if (lhs.attr == system::type_atom::value) {
             result_type result;
-            for (auto& [part_id, part_syn] : partition_synopses_)
-              for (auto& pair : part_syn)
-                if (evaluate(pair.first.name(), x.op, d)) {
-                  result.push_back(part_id);
-                  break;
-                }
+            for (auto& [layout, cols] : columns_)
+              if (evaluate(layout.name(), x.op, d))
+                result.insert(result.end(), cols.partitions.begin(),
+                              cols.partitions.end());
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()),
+                         result.end());
             return result;
           }
           VAST_WARNING(this, "cannot process attribute extractor:", lhs.attr);
@@ -183,18 +340,100 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
   return caf::visit(f, expr);
 }
 
+std::vector<uuid> meta_index::lookup_older_than(time cutoff) const {
+  // Checks whether a timestamp synopsis bounds all events of a layout.
+  auto precedes = [&](const record_type& layout, const table_synopsis& syns) {
+    for (size_t i = 0; i < syns.size(); ++i)
+      if (syns[i] && has_attribute(layout.fields[i].type, "timestamp"))
+        if (auto ts = dynamic_cast<const time_synopsis*>(syns[i].get()))
+          return ts->max() < cutoff;
+    return false;
+  };
+  std::vector<uuid> result;
+  for (auto& [part_id, part_syn] : partition_synopses_) {
+    auto all_precede = !part_syn.empty();
+    for (auto& [layout, table_syn] : part_syn)
+      if (!precedes(layout, table_syn)) {
+        all_precede = false;
+        break;
+      }
+    if (all_precede)
+      result.push_back(part_id);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+time meta_index::max_timestamp(const uuid& partition) const {
+  auto i = partition_synopses_.find(partition);
+  if (i == partition_synopses_.end() || i->second.empty())
+    return time::max();
+  auto is_timestamp = [](const record_field& field) {
+    return caf::holds_alternative<time_type>(field.type)
+           && has_attribute(field.type, "timestamp");
+  };
+  auto result = time::min();
+  for (auto& [layout, table_syn] : i->second) {
+    auto& fields = layout.fields;
+    auto j = std::find_if(fields.begin(), fields.end(), is_timestamp);
+    if (j == fields.end())
+      continue;
+    auto& syn = table_syn[std::distance(fields.begin(), j)];
+    auto ts = dynamic_cast<const time_synopsis*>(syn.get());
+    if (ts == nullptr)
+      return time::max();
+    result = std::max(result, ts->max());
+  }
+  return result;
+}
+
+void meta_index::erase(const uuid& partition) {
+  if (partition_synopses_.erase(partition) == 0)
+    return;
+  for (auto i = columns_.begin(); i != columns_.end();) {
+    auto& cols = i->second;
+    auto& parts = cols.partitions;
+    if (auto j = cols.rows.find(partition); j != cols.rows.end()) {
+      auto row = j->second;
+      cols.rows.erase(j);
+      for (auto& kvp : cols.rows)
+        if (kvp.second > row)
+          --kvp.second;
+      parts.erase(parts.begin() + row);
+      for (auto& c : cols.columns) {
+        c.synopses.erase(c.synopses.begin() + row);
+        if (c.has_ranges) {
+          c.mins.erase(c.mins.begin() + row);
+          c.maxs.erase(c.maxs.begin() + row);
+        }
+      }
+    }
+    if (parts.empty())
+      i = columns_.erase(i);
+    else
+      ++i;
+  }
+}
+
 caf::settings& meta_index::factory_options() {
   return synopsis_options_;
 }
 
+void meta_index::parallelize(std::shared_ptr<detail::thread_pool> pool) {
+  pool_ = std::move(pool);
+}
+
 caf::error inspect(caf::serializer& sink, const meta_index& x) {
   return sink(x.synopsis_options_, x.partition_synopses_,
               x.blacklisted_layouts_);
 }
 
 caf::error inspect(caf::deserializer& source, meta_index& x) {
-  return source(x.synopsis_options_, x.partition_synopses_,
-                x.blacklisted_layouts_);
+  if (auto err = source(x.synopsis_options_, x.partition_synopses_,
+                        x.blacklisted_layouts_))
+    return err;
+  x.rebuild_columns();
+  return caf::none;
 }
 
 // Perform a deep equality comparison for meta indices. This is slow and we only
@@ -15,15 +15,24 @@
 
 #include <caf/binary_deserializer.hpp>
 
+#include <numeric>
+
 #include "vast/bitmap.hpp"
 #include "vast/bitmap_algorithms.hpp"
+#include "vast/data.hpp"
+#include "vast/default_table_slice.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
+#include "vast/expression.hpp"
+#include "vast/factory.hpp"
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/si_literals.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
+#include "vast/table_slice_builder_factory.hpp"
 
 namespace vast {
 
@@ -34,8 +43,8 @@ segment_ptr segment::make(chunk_ptr chunk) {
   // Setup a CAF deserializer
   caf::binary_deserializer source{nullptr, chunk->data(), chunk->size()};
   auto result = segment_ptr{new segment, false};
-  if (auto error = source(result->header_, result->meta_)) {
-    VAST_ERROR_ANON(__func__, "failed to deserialize segment meta data");
+  if (auto error = source(result->header_)) {
+    VAST_ERROR_ANON(__func__, "failed to deserialize segment header");
     return nullptr;
   }
   if (result->header_.magic != magic) {
@@ -48,6 +57,10 @@ segment_ptr segment::make(chunk_ptr chunk) {
                     result->header_.version, "instead of", version);
     return nullptr;
   }
+  if (auto error = result->load_meta(source)) {
+    VAST_ERROR_ANON(__func__, "failed to deserialize segment meta data");
+    return nullptr;
+  }
   // Skip meta data. Since the buffer following the chunk meta data was
   // previously serialized as chunk pointer (uint32_t size + data), we have
   // to add add sizeof(uint32_t) bytes to directly jump to the table slice
@@ -73,15 +86,30 @@ size_t segment::num_slices() const {
 
 caf::expected<std::vector<table_slice_ptr>>
 segment::lookup(const ids& xs) const {
+  return lookup(xs, {}, expression{});
+}
+
+caf::expected<std::vector<table_slice_ptr>>
+segment::lookup(const ids& xs, const std::vector<std::string>& fields,
+                const expression& expr) const {
+  projection_cache projection{fields};
+  return lookup(xs, projection, expr);
+}
+
+caf::expected<std::vector<table_slice_ptr>>
+segment::lookup(const ids& xs, projection_cache& projection,
+                const expression& expr) const {
   std::vector<table_slice_ptr> result;
   auto f = [](auto& slice) {
     return std::pair{slice.offset, slice.offset + slice.size};
   };
   auto g = [&](auto& slice) -> caf::error {
-    auto x = make_slice(slice);
+    auto index = static_cast<size_t>(&slice - meta_.slices.data());
+    auto x = make_slice(index, projection, expr);
     if (!x)
       return x.error();
-    result.push_back(*x);
+    if (*x != nullptr)
+      result.push_back(std::move(*x));
     return caf::none;
   };
   auto begin = meta_.slices.begin();
@@ -92,24 +120,127 @@ segment::lookup(const ids& xs) const {
 }
 
 caf::expected<table_slice_ptr>
-segment::make_slice(const table_slice_synopsis& slice) const {
-  auto slice_size = detail::narrow_cast<size_t>(slice.end - slice.start);
-  caf::binary_deserializer source{nullptr, chunk_->data() + slice.start,
-                                  slice_size};
-  table_slice_ptr result;
-  if (auto error = source(result))
+segment::make_slice(size_t index, projection_cache& projection,
+                    const expression& expr) const {
+  using detail::narrow_cast;
+  auto& slice = meta_.slices[index];
+  if (meta_.columns.empty()) {
+    // The slice is stored as a whole.
+    auto slice_size = narrow_cast<size_t>(slice.end - slice.start);
+    caf::binary_deserializer source{nullptr, chunk_->data() + slice.start,
+                                    slice_size};
+    table_slice_ptr result;
+    if (auto error = source(result))
+      return error;
+    if (!projection.fields().empty())
+      return projection(result);
+    return result;
+  }
+  // The slice is stored column by column, preceded by the implementation ID
+  // and the header.
+  auto& directory = meta_.columns[index];
+  auto preamble_end = directory.empty() ? slice.end : directory.front().start;
+  caf::binary_deserializer source{
+    nullptr, chunk_->data() + slice.start,
+    narrow_cast<size_t>(preamble_end - slice.start)};
+  caf::atom_value implementation_id;
+  table_slice_header header;
+  if (auto error = source(implementation_id, header))
     return error;
+  auto& layout = header.layout;
+  if (directory.size() != layout.fields.size())
+    return make_error(ec::format_error, "column directory does not match",
+                      "the slice layout");
+  if (!meta_.zones[index].lookup(expr, layout))
+    return table_slice_ptr{nullptr};
+  std::vector<size_t> all_columns;
+  auto projecting = !projection.fields().empty();
+  if (!projecting) {
+    all_columns.resize(layout.fields.size());
+    std::iota(all_columns.begin(), all_columns.end(), size_t{0});
+  }
+  auto& columns = projecting ? projection.columns(layout) : all_columns;
+  if (projecting && columns.empty())
+    return table_slice_ptr{nullptr};
+  // Decode only the selected columns.
+  std::vector<vector> values;
+  values.reserve(columns.size());
+  for (auto column : columns) {
+    auto& synopsis = directory[column];
+    if (synopsis.start < slice.start || synopsis.end > slice.end
+        || synopsis.start > synopsis.end)
+      return make_error(ec::format_error, "invalid column directory entry");
+    auto xs = decode_column(chunk_->data() + synopsis.start,
+                            narrow_cast<size_t>(synopsis.end - synopsis.start),
+                            layout.fields[column].type, synopsis.encoding,
+                            header.rows);
+    if (!xs)
+      return xs.error();
+    values.push_back(std::move(*xs));
+  }
+  auto result_layout = layout;
+  if (columns.size() < layout.fields.size()) {
+    std::vector<record_field> projected_fields;
+    projected_fields.reserve(columns.size());
+    for (auto column : columns)
+      projected_fields.emplace_back(layout.fields[column]);
+    result_layout = record_type{std::move(projected_fields)}
+                      .name(layout.name())
+                      .attributes(layout.attributes());
+  }
+  // The values passed the type checks of a builder before we stored them, so
+  // we can move them into a default slice as they are.
+  if (implementation_id == default_table_slice::class_id) {
+    table_slice_header result_header;
+    result_header.layout = std::move(result_layout);
+    result_header.rows = header.rows;
+    result_header.offset = slice.offset;
+    return default_table_slice::make(std::move(result_header),
+                                     std::move(values));
+  }
+  auto builder = factory<table_slice_builder>::make(implementation_id,
+                                                    std::move(result_layout));
+  if (builder == nullptr)
+    return make_error(ec::format_error, "no table slice builder for",
+                      to_string(implementation_id));
+  builder->reserve(header.rows);
+  for (size_t row = 0; row < header.rows; ++row)
+    for (auto& column : values)
+      if (!builder->add(make_view(column[row])))
+        return make_error(ec::format_error, "failed to rebuild table slice");
+  auto result = builder->finish();
+  if (result == nullptr)
+    return make_error(ec::format_error, "failed to rebuild table slice");
+  result.unshared().offset(slice.offset);
   return result;
 }
 
+caf::error segment::load_meta(caf::deserializer& source) {
+  // Version 1 segments lack the column directory.
+  if (header_.version < columnar_version)
+    return source(meta_.slices);
+  if (auto error = source(meta_))
+    return error;
+  if (meta_.columns.size() != meta_.slices.size())
+    return make_error(ec::format_error, "column directory does not match",
+                      "the slices");
+  if (meta_.zones.size() != meta_.slices.size())
+    return make_error(ec::format_error, "zone maps do not match the slices");
+  return caf::none;
+}
+
 caf::error inspect(caf::serializer& sink, const segment_ptr& x) {
   VAST_ASSERT(x != nullptr);
+  if (x->header_.version < segment::columnar_version)
+    return sink(x->header_, x->meta_.slices, x->chunk_);
   return sink(x->header_, x->meta_, x->chunk_);
 }
 
 caf::error inspect(caf::deserializer& source, segment_ptr& x) {
   x.reset(new segment, false);
-  return source(x->header_, x->meta_, x->chunk_);
+  return caf::error::eval([&] { return source(x->header_); },
+                          [&] { return x->load_meta(source); },
+                          [&] { return source(x->chunk_); });
 }
 
 ids flat_slice_ids(const segment::meta_data& x) {
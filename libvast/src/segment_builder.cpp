@@ -15,11 +15,13 @@
 
 #include <caf/binary_serializer.hpp>
 
+#include "vast/column_encoding.hpp"
 #include "vast/error.hpp"
 #include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/segment.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/zone_map.hpp"
 
 #include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
@@ -34,18 +36,35 @@ segment_builder::segment_builder() {
 caf::error segment_builder::add(table_slice_ptr x) {
   if (x->offset() < min_table_slice_offset_)
     return make_error(ec::unspecified, "slice offsets not increasing");
+  using detail::narrow_cast;
   auto before = table_slice_buffer_.size();
+  // Write the implementation ID and the header, followed by each column.
   caf::binary_serializer sink{nullptr, table_slice_buffer_};
-  if (auto error = sink(x)) {
+  if (auto error = sink(x->implementation_id(), x->header())) {
     table_slice_buffer_.resize(before);
     return error;
   }
+  std::vector<segment::column_synopsis> columns;
+  columns.reserve(x->columns());
+  for (size_t column = 0; column < x->columns(); ++column) {
+    auto start = table_slice_buffer_.size();
+    auto encoding = encode_column(table_slice_buffer_, *x, column);
+    if (!encoding) {
+      table_slice_buffer_.resize(before);
+      return std::move(encoding.error());
+    }
+    columns.push_back({narrow_cast<int64_t>(start),
+                       narrow_cast<int64_t>(table_slice_buffer_.size()),
+                       *encoding});
+  }
   auto after = table_slice_buffer_.size();
   VAST_ASSERT(before < after);
   meta_.slices.push_back({
-    detail::narrow_cast<int64_t>(before),
-    detail::narrow_cast<int64_t>(after),
+    narrow_cast<int64_t>(before),
+    narrow_cast<int64_t>(after),
     x->offset(), x->rows()});
+  meta_.columns.push_back(std::move(columns));
+  meta_.zones.push_back(zone_map::make(*x));
   min_table_slice_offset_ = x->offset() + x->rows();
   slices_.push_back(x);
   return caf::none;
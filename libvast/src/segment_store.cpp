@@ -20,6 +20,7 @@
 #include "vast/bitmap_algorithms.hpp"
 #include "vast/error.hpp"
 #include "vast/event.hpp"
+#include "vast/expression.hpp"
 #include "vast/ids.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
@@ -34,6 +35,9 @@
 #include "vast/table_slice.hpp"
 #include "vast/to_events.hpp"
 
+#include <algorithm>
+#include <unordered_set>
+
 namespace vast {
 
 segment_store_ptr segment_store::make(path dir, size_t max_segment_size,
@@ -88,6 +92,57 @@ caf::error segment_store::flush() {
   return save(nullptr, meta_path(), segments_);
 }
 
+caf::expected<size_t> segment_store::compact(uint64_t threshold,
+                                             size_t max_merges) {
+  VAST_TRACE(VAST_ARG(threshold), VAST_ARG(max_merges));
+  // Collect all persisted segments in the order of their event IDs.
+  std::vector<uuid> ordered;
+  std::unordered_set<uuid> seen;
+  for (auto i = segments_.begin(); i != segments_.end(); ++i)
+    if (i->value != builder_.id() && seen.insert(i->value).second)
+      ordered.push_back(i->value);
+  // Merge runs of adjacent small segments, where each run stays within the
+  // maximum segment size.
+  size_t merged = 0;
+  size_t merges = 0;
+  std::vector<uuid> run;
+  uint64_t run_bytes = 0;
+  auto finish_run = [&]() -> caf::error {
+    if (run.size() > 1) {
+      if (auto err = merge(run))
+        return err;
+      merged += run.size() - 1;
+      ++merges;
+    }
+    run.clear();
+    run_bytes = 0;
+    return caf::none;
+  };
+  for (auto& id : ordered) {
+    if (merges == max_merges)
+      break;
+    auto bytes = file_size(segment_path() / to_string(id));
+    if (!bytes)
+      return bytes.error();
+    if (*bytes >= threshold) {
+      if (auto err = finish_run())
+        return err;
+      continue;
+    }
+    if (run_bytes + *bytes > max_segment_size_)
+      if (auto err = finish_run())
+        return err;
+    run.push_back(id);
+    run_bytes += *bytes;
+  }
+  if (merges < max_merges)
+    if (auto err = finish_run())
+      return err;
+  if (merged > 0)
+    VAST_INFO(this, "merged away", merged, "segments");
+  return merged;
+}
+
 caf::expected<segment_ptr> segment_store::load_segment(uuid id) const {
   auto filename = segment_path() / to_string(id);
   VAST_DEBUG(this, "loads segment from", filename);
@@ -97,13 +152,24 @@ caf::expected<segment_ptr> segment_store::load_segment(uuid id) const {
 }
 
 std::unique_ptr<store::lookup> segment_store::extract(const ids& xs) const {
+  return extract(xs, {}, expression{});
+}
+
+std::unique_ptr<store::lookup>
+segment_store::extract(const ids& xs, const std::vector<std::string>& fields,
+                       const expression& expr) const {
 
   class lookup : public store::lookup {
   public:
     using uuid_iterator = std::vector<uuid>::iterator;
 
-    lookup(const segment_store& store, ids xs, std::vector<uuid>&& candidates)
-      : store_{store}, xs_{std::move(xs)}, candidates_{std::move(candidates)} {
+    lookup(const segment_store& store, ids xs, std::vector<uuid>&& candidates,
+           std::vector<std::string> fields, expression expr)
+      : store_{store},
+        xs_{std::move(xs)},
+        candidates_{std::move(candidates)},
+        projection_{std::move(fields)},
+        expr_{std::move(expr)} {
       // nop
     }
 
@@ -143,12 +209,14 @@ std::unique_ptr<store::lookup> segment_store::extract(const ids& xs) const {
         i = store_.cache_.emplace(cand, seg_ptr).first;
       }
       VAST_ASSERT(seg_ptr != nullptr);
-      return seg_ptr->lookup(xs_);
+      return seg_ptr->lookup(xs_, projection_, expr_);
     }
 
     const segment_store& store_;
     ids xs_;
     std::vector<uuid> candidates_;
+    projection_cache projection_;
+    expression expr_;
     uuid_iterator first_ = candidates_.begin();
     caf::expected<std::vector<table_slice_ptr>> buffer_{caf::no_error};
     std::vector<table_slice_ptr>::iterator it_;
@@ -166,7 +234,8 @@ std::unique_ptr<store::lookup> segment_store::extract(const ids& xs) const {
   std::partition(candidates.begin(), candidates.end(), [&](const auto& id) {
     return id == builder_.id() || cache_.find(id) != cache_.end();
   });
-  return std::make_unique<lookup>(*this, std::move(xs), std::move(candidates));
+  return std::make_unique<lookup>(*this, std::move(xs), std::move(candidates),
+                                  fields, expr);
 }
 
 caf::error segment_store::erase(const ids& xs) {
@@ -384,6 +453,66 @@ caf::error segment_store::select_segments(const ids& selection,
   return select_with(selection, begin, end, f, g);
 }
 
+caf::expected<segment_ptr> segment_store::get_segment(const uuid& id) const {
+  if (auto i = cache_.find(id); i != cache_.end())
+    return i->second;
+  return load_segment(id);
+}
+
+caf::error segment_store::merge(const std::vector<uuid>& xs) {
+  VAST_ASSERT(xs.size() > 1);
+  std::vector<segment_ptr> stale;
+  std::vector<table_slice_ptr> slices;
+  for (auto& x : xs) {
+    auto seg = get_segment(x);
+    if (!seg)
+      return seg.error();
+    auto seg_slices = (*seg)->lookup(flat_slice_ids((*seg)->meta()));
+    if (!seg_slices)
+      return seg_slices.error();
+    slices.insert(slices.end(), seg_slices->begin(), seg_slices->end());
+    stale.emplace_back(std::move(*seg));
+  }
+  // The builder requires table slices in ascending ID order.
+  std::sort(slices.begin(), slices.end(), [](auto& x, auto& y) {
+    return x->offset() < y->offset();
+  });
+  segment_builder builder;
+  for (auto& slice : slices)
+    if (auto err = builder.add(slice))
+      return err;
+  auto x = builder.finish();
+  if (x == nullptr)
+    return make_error(ec::unspecified, "failed to build segment");
+  auto filename = segment_path() / to_string(x->id());
+  if (auto err = save(nullptr, filename, x))
+    return err;
+  // Point a copy of the meta data to the new segment and persist it. Only
+  // then we commit the copy, so that a failure leaves the store untouched.
+  auto updated = segments_;
+  for (auto& seg : stale)
+    updated.erase_value(seg->id());
+  for (auto& slice : slices)
+    if (!updated.inject(slice->offset(), slice->offset() + slice->rows(),
+                        x->id())) {
+      rm(filename);
+      return make_error(ec::unspecified, "failed to update range_map");
+    }
+  if (auto err = save(nullptr, meta_path(), updated)) {
+    rm(filename);
+    return err;
+  }
+  segments_ = std::move(updated);
+  for (auto& seg : stale) {
+    cache_.erase(seg->id());
+    // Schedule deletion of the segment file when releasing the chunk.
+    auto stale_filename = segment_path() / to_string(seg->id());
+    seg->chunk()->add_deletion_step([=] { rm(stale_filename); });
+  }
+  VAST_DEBUG(this, "merged", xs.size(), "segments into", x->id());
+  return caf::none;
+}
+
 uint64_t segment_store::drop(segment& x) {
   uint64_t erased_events = 0;
   auto segment_id = x.id();
@@ -19,6 +19,16 @@ store::~store() {
   // nop
 }
 
+std::unique_ptr<store::lookup>
+store::extract(const ids& xs, const std::vector<std::string>&,
+               const expression&) const {
+  return extract(xs);
+}
+
+caf::expected<size_t> store::compact(uint64_t, size_t) {
+  return size_t{0};
+}
+
 store::lookup::~lookup() {
   // nop
 }
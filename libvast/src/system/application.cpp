@@ -98,7 +98,15 @@ auto make_export_command() {
     opts("?export")
       .add<bool>("continuous,c", "marks a query as continuous")
       .add<bool>("unified,u", "marks a query as unified")
+      .add<bool>("latest,l", "returns the most recent results sorted by time")
+      .add<bool>("federated", "runs the query on all peered nodes")
       .add<size_t>("max-events,n", "maximum number of results")
+      .add<size_t>("max-buffer", "maximum size of cached results in MiB")
+      .add<size_t>("max-partitions", "maximum number of partitions to "
+                                     "evaluate at once")
+      .add<caf::timespan>("timeout", "cancels the query after this time")
+      .add<std::vector<std::string>>("fields", "list of fields to include in "
+                                               "the results")
       .add<std::string>("read,r", "path for reading the query"));
   export_->add_subcommand("zeek", "exports query results in Zeek format",
                           documentation::vast_export_zeek,
@@ -145,7 +153,12 @@ auto make_import_command() {
       .add<caf::atom_value>("table-slice-type,t", "table slice type")
       .add<bool>("blocking,b", "block until the IMPORTER forwarded all data")
       .add<size_t>("max-events,n", "the maximum number of events to "
-                                   "import"));
+                                   "import")
+      .add<size_t>("parallel,P", "number of threads for parsing line-based "
+                                 "formats")
+      .add<size_t>("chunk-size", "number of records per parallel parsing "
+                                 "task")
+      .add<bool>("unordered", "allow parallel parsing to reorder events"));
   import_->add_subcommand("zeek", "imports Zeek logs from STDIN or file",
                           documentation::vast_import_zeek,
                           source_opts("?import.zeek"));
@@ -190,6 +203,13 @@ auto make_import_command() {
   return import_;
 }
 
+auto make_erase_command() {
+  return std::make_unique<command>(
+    "erase", "erases events older than a given age", documentation::vast_erase,
+    opts("?erase").add<std::string>("older-than,o", "minimum age of events to "
+                                                     "erase, e.g., 30d"));
+}
+
 auto make_kill_command() {
   return std::make_unique<command>("kill", "terminates a component", "", opts(),
                                    false);
@@ -275,7 +295,15 @@ auto make_spawn_command() {
     opts()
       .add<bool>("continuous,c", "marks a query as continuous")
       .add<bool>("unified,u", "marks a query as unified")
-      .add<uint64_t>("events,e", "maximum number of results"));
+      .add<bool>("latest,l", "returns the most recent results sorted by time")
+      .add<bool>("federated", "runs the query on all peered nodes")
+      .add<uint64_t>("events,e", "maximum number of results")
+      .add<size_t>("max-buffer", "maximum size of cached results in MiB")
+      .add<size_t>("max-partitions", "maximum number of partitions to "
+                                     "evaluate at once")
+      .add<caf::timespan>("timeout", "cancels the query after this time")
+      .add<std::vector<std::string>>("fields", "list of fields to include in "
+                                               "the results"));
   spawn->add_subcommand("importer", "creates a new importer", "",
                         opts().add<size_t>("ids,n", "number of initial IDs to "
                                                     "request (deprecated)"));
@@ -328,6 +356,7 @@ auto make_command_factory() {
   // well iff necessary
   return command::factory{
     {"count", count_command},
+    {"erase", remote_command},
     {"export ascii",
      writer_command<format::ascii::writer, defaults::export_::ascii>},
     {"export csv", writer_command<format::csv::writer, defaults::export_::csv>},
@@ -398,6 +427,7 @@ std::pair<std::unique_ptr<command>, command::factory>
 make_application(std::string_view path) {
   auto root = make_root_command(path);
   root->add_subcommand(make_count_command());
+  root->add_subcommand(make_erase_command());
   root->add_subcommand(make_export_command());
   root->add_subcommand(make_infer_command());
   root->add_subcommand(make_import_command());
@@ -455,7 +485,8 @@ command::opts_builder source_opts(std::string_view category) {
 command::opts_builder sink_opts(std::string_view category) {
   return command::opts(category)
     .add<std::string>("write,w", "path to write events to")
-    .add<bool>("uds,d", "treat -w as UNIX domain socket to connect to");
+    .add<bool>("uds,d", "treat -w as UNIX domain socket to connect to")
+    .add<size_t>("parallel,P", "number of threads for rendering results");
 }
 
 command::opts_builder opts(std::string_view category) {
@@ -20,8 +20,10 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/event.hpp"
+#include "vast/expression.hpp"
 #include "vast/logger.hpp"
 #include "vast/segment_store.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/store.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/to_events.hpp"
@@ -36,6 +38,7 @@ using std::chrono::duration_cast;
 using std::chrono::microseconds;
 using std::chrono::steady_clock;
 using namespace caf;
+using namespace vast::binary_byte_literals;
 
 namespace vast::system {
 
@@ -85,35 +88,73 @@ archive(archive_type::stateful_pointer<archive_state> self, path dir,
     self->send(self->state.accountant, announce_atom::value, self->name());
     self->delayed_send(self, defs::telemetry_rate, telemetry_atom::value);
   }
+  namespace sd = vast::defaults::system;
+  auto& cfg = self->system().config();
+  auto compaction_interval = get_or(cfg, "system.compaction-interval",
+                                    timespan{sd::compaction_interval});
+  auto compaction_threshold
+    = 1_MiB
+      * get_or(cfg, "system.compaction-threshold", sd::compaction_threshold);
+  auto compaction_max_merges = get_or(cfg, "system.compaction-max-merges",
+                                      sd::compaction_max_merges);
+  if (compaction_interval > compaction_interval.zero())
+    self->delayed_send(self, compaction_interval, compact_atom::value);
+  auto extract = [=](const ids& xs, time deadline,
+                     const std::vector<std::string>& fields,
+                     const expression& expr)
+    -> caf::result<done_atom, caf::error> {
+    VAST_ASSERT(rank(xs) > 0);
+    VAST_DEBUG(self, "got query for", rank(xs),
+               "events in range [" << select(xs, 1) << ','
+                                   << (select(xs, -1) + 1) << ')');
+    if (self->state.active_exporters.count(self->current_sender()->address())
+        == 0) {
+      VAST_DEBUG(self, "dismisses query for inactive sender");
+      return make_error(ec::no_error);
+    }
+    using receiver_type = caf::typed_actor<caf::reacts_to<table_slice_ptr>>;
+    auto requester = caf::actor_cast<receiver_type>(self->current_sender());
+    auto session = self->state.store->extract(xs, fields, expr);
+    // Resolve the projected columns once per layout for the entire query.
+    projection_cache projection{fields};
+    while (true) {
+      // Check the deadline between segments, so that a cancelled query
+      // does not keep the ARCHIVE busy.
+      if (std::chrono::system_clock::now() > deadline) {
+        VAST_DEBUG(self, "aborts query after exceeding its deadline");
+        return {done_atom::value,
+                make_error(ec::budget_exceeded, "archive lookup timed out")};
+      }
+      auto slice = session->next();
+      if (!slice) {
+        if (!slice.error()) // Either we are done ...
+          break;
+        // ... or an error occured.
+        return {done_atom::value, std::move(slice.error())};
+      }
+      // The slice may contain entries that are not selected by xs.
+      for (auto& sub_slice : select(*slice, xs)) {
+        if (!fields.empty()) {
+          sub_slice = projection(sub_slice);
+          if (sub_slice == nullptr)
+            continue;
+        }
+        self->send(requester, sub_slice);
+      }
+    }
+    return {done_atom::value, make_error(ec::no_error)};
+  };
   return {[=](const ids& xs) -> caf::result<done_atom, caf::error> {
-            VAST_ASSERT(rank(xs) > 0);
-            VAST_DEBUG(self, "got query for", rank(xs),
-                       "events in range [" << select(xs, 1) << ','
-                                           << (select(xs, -1) + 1) << ')');
-            if (self->state.active_exporters.count(
-                  self->current_sender()->address())
-                == 0) {
-              VAST_DEBUG(self, "dismisses query for inactive sender");
-              return make_error(ec::no_error);
-            }
-            using receiver_type = caf::typed_actor<
-              caf::reacts_to<table_slice_ptr>>;
-            auto requester = caf::actor_cast<receiver_type>(
-              self->current_sender());
-            auto session = self->state.store->extract(xs);
-            while (true) {
-              auto slice = session->next();
-              if (!slice) {
-                if (!slice.error()) // Either we are done ...
-                  break;
-                // ... or an error occured.
-                return {done_atom::value, std::move(slice.error())};
-              }
-              // The slice may contain entries that are not selected by xs.
-              for (auto& sub_slice : select(*slice, xs))
-                self->send(requester, sub_slice);
-            }
-            return {done_atom::value, make_error(ec::no_error)};
+            return extract(xs, time::max(), {}, expression{});
+          },
+          [=](const ids& xs,
+              time deadline) -> caf::result<done_atom, caf::error> {
+            return extract(xs, deadline, {}, expression{});
+          },
+          [=](const ids& xs, time deadline,
+              const std::vector<std::string>& fields, const expression& expr)
+            -> caf::result<done_atom, caf::error> {
+            return extract(xs, deadline, fields, expr);
           },
           [=](stream<table_slice_ptr> in) {
             self->make_sink(
@@ -135,6 +176,7 @@ archive(archive_type::stateful_pointer<archive_state> self, path dir,
                   events += slice->rows();
                 }
                 t.stop(events);
+                self->state.ingested_since_compaction += events;
               },
               [=](unit_t&, const error& err) {
                 if (err) {
@@ -164,6 +206,26 @@ archive(archive_type::stateful_pointer<archive_state> self, path dir,
             if (auto err = self->state.store->erase(xs))
               VAST_ERROR(self,
                          "failed to erase events:", self->system().render(err));
+          },
+          [=](compact_atom) {
+            auto& st = self->state;
+            if (st.ingested_since_compaction > 0) {
+              VAST_DEBUG(self, "defers compaction while ingesting");
+            } else if (auto merged = st.store->compact(compaction_threshold,
+                                                       1);
+                       !merged) {
+              VAST_ERROR(self, "failed to compact segments:",
+                         self->system().render(merged.error()));
+            } else if (*merged > 0
+                       && ++st.compaction_merges < compaction_max_merges) {
+              // Perform one merge per message to keep serving lookups in
+              // between.
+              self->send(self, compact_atom::value);
+              return;
+            }
+            st.compaction_merges = 0;
+            st.ingested_since_compaction = 0;
+            self->delayed_send(self, compaction_interval, compact_atom::value);
           }};
 }
 
@@ -17,6 +17,7 @@
 #include <caf/behavior.hpp>
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
+#include <caf/system_messages.hpp>
 
 #include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
@@ -159,9 +160,21 @@ caf::behavior evaluator(caf::stateful_actor<evaluator_state>* self,
   VAST_ASSERT(!eval.empty());
   using std::get;
   using std::move;
+  // Cancel the evaluation when the client goes away. Outstanding INDEXER
+  // responses get dropped once we terminate.
+  self->set_down_handler([=](const caf::down_msg& msg) {
+    auto& st = self->state;
+    if (msg.source == st.client) {
+      VAST_DEBUG(self, "cancels evaluation after its client went down");
+      if (st.pending_responses > 0)
+        st.promise.deliver(done_atom::value);
+      self->quit(msg.reason);
+    }
+  });
   return {[=, expr{move(expr)}, eval{move(eval)}](caf::actor client) {
     auto& st = self->state;
     st.init(client, move(expr), self->make_response_promise());
+    self->monitor(client);
     for (auto& [layout, triples] : eval) {
       st.pending_responses += triples.size();
       for (auto& triple : triples) {
@@ -19,9 +19,11 @@
 #include "vast/concept/printable/vast/event.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
+#include "vast/data.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/logger.hpp"
@@ -32,6 +34,11 @@
 #include "vast/to_events.hpp"
 
 #include <caf/all.hpp>
+#include <caf/binary_serializer.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <type_traits>
 
 using namespace std::chrono;
 using namespace std::string_literals;
@@ -42,6 +49,11 @@ namespace system {
 
 namespace {
 
+// Ordered queries evaluate the partitions one after another, newest first, so
+// that they can stop as soon as the remaining partitions hold only older
+// events than the results so far.
+constexpr size_t ordered_partitions_per_request = 1;
+
 void ship_results(stateful_actor<exporter_state>* self) {
   VAST_TRACE("");
   auto& st = self->state;
@@ -51,16 +63,29 @@ void ship_results(stateful_actor<exporter_state>* self) {
     // Fetch the next table slice. Either we grab the entire first slice in
     // st.results or we need to split it up.
     table_slice_ptr slice = nullptr;
+    size_t bytes = 0;
     if (st.results[0]->rows() <= st.query.requested) {
       slice = std::move(st.results[0]);
       st.results.erase(st.results.begin());
+      if (!st.result_sizes.empty()) {
+        bytes = st.result_sizes.front();
+        st.result_sizes.erase(st.result_sizes.begin());
+      }
     } else {
       auto [first, second] = split(st.results[0], st.query.requested);
       VAST_ASSERT(first != nullptr && second != nullptr);
       VAST_ASSERT(first->rows() == st.query.requested);
+      if (!st.result_sizes.empty()) {
+        // Attribute the footprint to both halves by their share of rows.
+        auto& size = st.result_sizes.front();
+        bytes = size * first->rows() / st.results[0]->rows();
+        size -= bytes;
+      }
       slice = std::move(first);
       st.results[0] = std::move(second);
     }
+    VAST_ASSERT(bytes <= st.buffered_bytes);
+    st.buffered_bytes -= bytes;
     // Ship the slice and update state.
     auto rows = slice->rows();
     VAST_ASSERT(rows <= st.query.cached);
@@ -71,6 +96,163 @@ void ship_results(stateful_actor<exporter_state>* self) {
   }
 }
 
+// Approximates the memory footprint of a slice by its serialized size, which
+// includes the payload of strings and containers.
+size_t approximate_size(const table_slice& slice) {
+  std::vector<char> buf;
+  caf::binary_serializer sink{nullptr, buf};
+  if (auto err = slice.serialize(sink))
+    return slice.rows() * slice.columns() * sizeof(data);
+  return buf.size();
+}
+
+// Computes the fields that the ARCHIVE must ship for the candidate check to
+// see every column that `expr` references. Returns an empty list when the
+// expression references columns by something other than their name.
+std::vector<std::string>
+make_archive_projection(const expression& expr,
+                        std::vector<std::string> projection) {
+  if (projection.empty())
+    return {};
+  auto add = [&](const auto& operand) {
+    using operand_type = std::decay_t<decltype(operand)>;
+    if constexpr (std::is_same_v<operand_type, data>) {
+      return true;
+    } else if constexpr (std::is_same_v<operand_type, key_extractor>) {
+      projection.push_back(operand.key);
+      return true;
+    } else if constexpr (std::is_same_v<operand_type, attribute_extractor>) {
+      // The event type is part of the layout, but the timestamp attribute
+      // refers to a column of unknown name.
+      return operand.attr == type_atom::get_value();
+    } else {
+      return false;
+    }
+  };
+  for (auto& pred : caf::visit(predicatizer{}, expr))
+    if (!caf::visit(add, pred.lhs) || !caf::visit(add, pred.rhs))
+      return {};
+  std::sort(projection.begin(), projection.end());
+  projection.erase(std::unique(projection.begin(), projection.end()),
+                   projection.end());
+  return projection;
+}
+
+// Returns the column that holds the event timestamp in a layout.
+caf::optional<size_t> timestamp_column(const record_type& layout) {
+  auto is_timestamp = [](const record_field& field) {
+    return caf::holds_alternative<time_type>(field.type)
+           && has_attribute(field.type, "timestamp");
+  };
+  auto& fields = layout.fields;
+  auto i = std::find_if(fields.begin(), fields.end(), is_timestamp);
+  if (i == fields.end())
+    return caf::none;
+  return static_cast<size_t>(std::distance(fields.begin(), i));
+}
+
+// Returns the event timestamp of a row, treating rows without a timestamp as
+// older than all others.
+time timestamp_at(const table_slice& slice, caf::optional<size_t> column,
+                  size_t row) {
+  if (!column)
+    return time::min();
+  auto x = slice.at(row, *column);
+  if (auto ts = caf::get_if<time>(&x))
+    return *ts;
+  return time::min();
+}
+
+// Selects the `n` most recent rows of `xs`, sorted by event timestamp.
+std::vector<table_slice_ptr>
+select_latest(const std::vector<table_slice_ptr>& xs, size_t n) {
+  struct ranked_row {
+    time timestamp;
+    size_t slice;
+    size_t row;
+  };
+  std::vector<ranked_row> rows;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto column = timestamp_column(xs[i]->layout());
+    for (size_t row = 0; row < xs[i]->rows(); ++row)
+      rows.push_back({timestamp_at(*xs[i], column, row), i, row});
+  }
+  auto older = [](const ranked_row& x, const ranked_row& y) {
+    return std::tie(x.timestamp, x.slice, x.row)
+           < std::tie(y.timestamp, y.slice, y.row);
+  };
+  if (rows.size() > n) {
+    std::nth_element(rows.begin(), rows.end() - n, rows.end(), older);
+    rows.erase(rows.begin(), rows.end() - n);
+  }
+  std::sort(rows.begin(), rows.end(), older);
+  // Copy runs of consecutive rows of the same slice in bulk.
+  std::vector<table_slice_ptr> result;
+  for (size_t i = 0; i < rows.size();) {
+    auto j = i + 1;
+    while (j < rows.size() && rows[j].slice == rows[i].slice
+           && rows[j].row == rows[j - 1].row + 1)
+      ++j;
+    auto& slice = xs[rows[i].slice];
+    if (j - i == slice->rows())
+      result.push_back(slice);
+    else if (auto x = slice->copy_rows(rows[i].row, j - i))
+      result.push_back(std::move(x));
+    i = j;
+  }
+  return result;
+}
+
+// Prunes the results of an ordered query to the requested number of rows and
+// checks whether the partitions that the INDEX did not yet evaluate can still
+// contribute to them.
+bool prune_ordered_results(stateful_actor<exporter_state>* self) {
+  auto& st = self->state;
+  auto& qs = st.query;
+  if (qs.requested == 0 || qs.requested == max_events)
+    return false;
+  st.ordered_results = select_latest(st.ordered_results, qs.requested);
+  size_t rows = 0;
+  for (auto& slice : st.ordered_results)
+    rows += slice->rows();
+  if (rows < qs.requested || qs.received >= st.partition_bounds.size())
+    return false;
+  // The partitions are sorted by their bounds, so the next partition bounds
+  // all remaining ones.
+  auto& oldest = *st.ordered_results.front();
+  auto ts = timestamp_at(oldest, timestamp_column(oldest.layout()), 0);
+  return ts > st.partition_bounds[qs.received];
+}
+
+// Ranks and projects the results of a completed ordered query and ships them.
+void ship_ordered_results(stateful_actor<exporter_state>* self) {
+  auto& st = self->state;
+  auto n = st.query.requested == 0 ? max_events : st.query.requested;
+  for (auto& slice : select_latest(st.ordered_results, n)) {
+    if (!st.projection.empty())
+      slice = project(slice, st.projection);
+    if (slice != nullptr)
+      st.cache(std::move(slice));
+  }
+  st.ordered_results.clear();
+  ship_results(self);
+}
+
+void forward_hits(stateful_actor<exporter_state>* self, ids hits) {
+  auto& st = self->state;
+  ++st.query.lookups_issued;
+  self->send(st.archive, std::move(hits), st.deadline, st.archive_projection,
+             st.expr);
+}
+
+void forward_deferred_hits(stateful_actor<exporter_state>* self) {
+  auto& st = self->state;
+  if (st.deferred_hits.empty() || st.exceeds_buffer_budget())
+    return;
+  VAST_DEBUG(self, "forwards deferred hits to archive");
+  forward_hits(self, std::exchange(st.deferred_hits, ids{}));
+}
+
 void report_statistics(stateful_actor<exporter_state>* self) {
   auto& st = self->state;
   if (st.statistics_subscriber)
@@ -116,6 +298,17 @@ void request_more_hits(stateful_actor<exporter_state>* self) {
                "results and waits for client to request more");
     return;
   }
+  // Do nothing while the cached results exhaust the buffer budget.
+  if (st.exceeds_buffer_budget()) {
+    VAST_DEBUG(self, "caches more than", st.budget.max_buffered_bytes,
+               "bytes of results and waits for the client to drain them");
+    return;
+  }
+  // Do nothing if we still have hits that await an ARCHIVE lookup.
+  if (!st.deferred_hits.empty()) {
+    VAST_DEBUG(self, "waits for deferred hits");
+    return;
+  }
   // Do nothing if we are still waiting for results from the ARCHIVE.
   if (st.query.lookups_issued > st.query.lookups_complete) {
     VAST_DEBUG(self, "currently awaits",
@@ -139,6 +332,8 @@ void request_more_hits(stateful_actor<exporter_state>* self) {
   // TODO: Figure out right number of partitions to ask for. For now, we
   // bound the number by an arbitrary constant.
   auto n = std::min(remaining, size_t{2});
+  if (st.budget.max_partitions > 0)
+    n = std::min(n, st.budget.max_partitions);
   // Store how many partitions we schedule with our request. When receiving
   // 'done', we add this number to `received`.
   st.query.scheduled = n;
@@ -155,17 +350,47 @@ caf::settings exporter_state::status() {
   put(result, "start", caf::deep_to_string(start));
   put(result, "id", to_string(id));
   put(result, "expression", to_string(expr));
+  if (budget.max_buffered_bytes > 0)
+    put(result, "buffered-bytes", buffered_bytes);
   return result;
 }
 
+bool exporter_state::exceeds_buffer_budget() const {
+  return budget.max_buffered_bytes > 0
+         && buffered_bytes >= budget.max_buffered_bytes;
+}
+
+void exporter_state::cache(table_slice_ptr slice) {
+  // Only queries with a buffer budget pay for measuring the results.
+  if (budget.max_buffered_bytes > 0) {
+    auto size = approximate_size(*slice);
+    result_sizes.push_back(size);
+    buffered_bytes += size;
+  }
+  query.cached += slice->rows();
+  results.emplace_back(std::move(slice));
+}
+
 behavior exporter(stateful_actor<exporter_state>* self, expression expr,
-                  query_options options) {
+                  query_options options, query_budget budget,
+                  std::vector<std::string> projection) {
   if (auto a = self->system().registry().get(accountant_atom::value)) {
     self->state.accountant = actor_cast<accountant_type>(a);
     self->send(self->state.accountant, announce_atom::value, self->name());
   }
   self->state.options = options;
   self->state.expr = std::move(expr);
+  self->state.budget = budget;
+  if (has_ordered_option(options)
+      && (budget.max_partitions == 0
+          || budget.max_partitions > ordered_partitions_per_request))
+    self->state.budget.max_partitions = ordered_partitions_per_request;
+  // Ordered queries rank their results by a column that the projection may
+  // not include, so the ARCHIVE must ship entire rows.
+  if (!has_ordered_option(options))
+    self->state.archive_projection
+      = make_archive_projection(self->state.expr, projection);
+  self->state.projection = std::move(projection);
   if (has_continuous_option(options))
     VAST_DEBUG(self, "has continuous query option");
   self->set_exit_handler(
@@ -219,8 +444,18 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       // No rows qualify.
       return;
     }
-    st.query.cached += selection_size;
-    select(st.results, slice, selection);
+    if (has_ordered_option(st.options)) {
+      // Ordered queries rank and project their results once they complete.
+      select(st.ordered_results, slice, selection);
+    } else {
+      for (auto& x : select(slice, selection)) {
+        // Drop the columns that only the candidate check needed.
+        if (!st.projection.empty())
+          x = project(x, st.projection);
+        if (x != nullptr)
+          st.cache(std::move(x));
+      }
+    }
     // Ship slices to connected SINKs.
     st.query.processed += slice->rows();
     ship_results(self);
@@ -253,10 +488,14 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         VAST_DEBUG(self, "got", count, "index hits in [", (select(hits, 1)),
                    ',', (select(hits, -1) + 1), ')');
         st.hits |= hits;
-        VAST_DEBUG(self, "forwards hits to archive");
-        // FIXME: restrict according to configured limit.
-        ++st.query.lookups_issued;
-        self->send(st.archive, std::move(hits));
+        if (st.exceeds_buffer_budget()) {
+          VAST_DEBUG(self, "defers archive lookup until the client drains",
+                     "the cached results");
+          st.deferred_hits |= hits;
+        } else {
+          VAST_DEBUG(self, "forwards hits to archive");
+          forward_hits(self, std::move(hits));
+        }
       }
       return caf::unit;
     },
@@ -269,13 +508,21 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       auto& qs = st.query;
       // Ignore this message until we got all lookup results from the ARCHIVE.
       // Otherwise, we can end up in weirdly interleaved state.
-      if (qs.lookups_issued != qs.lookups_complete)
+      if (qs.lookups_issued != qs.lookups_complete
+          || !st.deferred_hits.empty())
         return caf::skip;
       // Figure out if we're done by bumping the counter for `received` and
       // check whether it reaches `expected`.
       timespan runtime = steady_clock::now() - st.start;
       qs.runtime = runtime;
       qs.received += qs.scheduled;
+      if (has_ordered_option(st.options) && qs.received < qs.expected
+          && prune_ordered_results(self)) {
+        VAST_DEBUG(self, "skips", qs.expected - qs.received,
+                   "partition(s) with events older than all results");
+        self->send(st.index, st.id, uint32_t{0});
+        qs.received = qs.expected;
+      }
       if (qs.received < qs.expected) {
         VAST_DEBUG(self, "received hits from", qs.received, '/', qs.expected,
                    "partitions");
@@ -285,8 +532,11 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
                    "partition(s) in", vast::to_string(runtime));
         if (st.accountant)
           self->send(st.accountant, "exporter.hits.runtime", runtime);
-        if (finished(qs))
+        if (finished(qs)) {
+          if (has_ordered_option(st.options))
+            ship_ordered_results(self);
           shutdown(self);
+        }
       }
       return caf::unit;
     },
@@ -315,6 +565,7 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
       // Configure state to get all remaining partition results.
       qs.requested = max_events;
       ship_results(self);
+      forward_deferred_hits(self);
       request_more_hits(self);
     },
     [=](extract_atom, uint64_t requested_results) {
@@ -336,6 +587,7 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
                  "pending results");
       qs.requested += n;
       ship_results(self);
+      forward_deferred_hits(self);
       request_more_hits(self);
     },
     [=](status_atom) {
@@ -370,26 +622,48 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
           self->send(x, exporter_atom::value, self);
     },
     [=](run_atom) {
-      VAST_INFO(self, "executes query:", to_string(self->state.expr));
-      self->state.start = steady_clock::now();
-      if (!has_historical_option(self->state.options))
+      auto& st = self->state;
+      VAST_INFO(self, "executes query:", to_string(st.expr));
+      st.start = steady_clock::now();
+      st.deadline = deadline(st.budget, system_clock::now());
+      if (st.budget.timeout > duration::zero())
+        self->delayed_send(self, st.budget.timeout, deadline_atom::value);
+      if (!has_historical_option(st.options))
         return;
-      self->request(self->state.index, infinite, self->state.expr).then(
-        [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled) {
-          VAST_DEBUG(self, "got lookup handle", lookup << ", scheduled",
-                     scheduled << '/' << partitions, "partitions");
-          self->state.id = lookup;
-          if (partitions > 0) {
-            self->state.query.expected = partitions;
-            self->state.query.scheduled = scheduled;
-          } else {
-            shutdown(self);
-          }
-        },
-        [=](const error& e) {
-          shutdown(self, e);
+      auto on_lookup = [=](const uuid& lookup, uint32_t partitions,
+                           uint32_t scheduled) {
+        VAST_DEBUG(self, "got lookup handle", lookup << ", scheduled",
+                   scheduled << '/' << partitions, "partitions");
+        self->state.id = lookup;
+        if (partitions > 0) {
+          self->state.query.expected = partitions;
+          self->state.query.scheduled = scheduled;
+        } else {
+          shutdown(self);
         }
-      );
+      };
+      auto on_error = [=](const error& e) { shutdown(self, e); };
+      if (has_ordered_option(st.options)) {
+        self->request(st.index, infinite, timestamp_atom::value, st.expr,
+                      st.budget).then(
+          [=](const uuid& lookup, uint32_t partitions, uint32_t scheduled,
+              std::vector<time>& bounds) {
+            self->state.partition_bounds = std::move(bounds);
+            on_lookup(lookup, partitions, scheduled);
+          },
+          on_error
+        );
+        return;
+      }
+      self->request(st.index, infinite, st.expr, st.budget).then(on_lookup,
+                                                                 on_error);
+    },
+    [=](deadline_atom) {
+      auto& st = self->state;
+      VAST_WARNING(self, "cancels query after exceeding its timeout of",
+                   vast::to_string(st.budget.timeout));
+      shutdown(self, make_error(ec::budget_exceeded, "query timed out after",
+                                vast::to_string(st.budget.timeout)));
     },
     [=](statistics_atom, const actor& statistics_subscriber) {
       VAST_DEBUG(self, "registers statistics subscriber",
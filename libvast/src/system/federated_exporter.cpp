@@ -0,0 +1,276 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/federated_exporter.hpp"
+
+#include "vast/concept/printable/to_string.hpp"
+#include "vast/concept/printable/vast/expression.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/detail/fill_status_map.hpp"
+#include "vast/error.hpp"
+#include "vast/logger.hpp"
+#include "vast/system/archive.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/system/exporter.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/all.hpp>
+
+#include <algorithm>
+
+using namespace caf;
+
+namespace vast::system {
+
+namespace {
+
+using self_ptr = stateful_actor<federated_exporter_state>*;
+
+void ship_results(self_ptr self) {
+  auto& st = self->state;
+  while (st.query.requested > 0 && st.query.cached > 0) {
+    VAST_ASSERT(!st.results.empty());
+    table_slice_ptr slice = nullptr;
+    if (st.results[0]->rows() <= st.query.requested) {
+      slice = std::move(st.results[0]);
+      st.results.erase(st.results.begin());
+    } else {
+      auto [first, second] = split(st.results[0], st.query.requested);
+      VAST_ASSERT(first != nullptr && second != nullptr);
+      slice = std::move(first);
+      st.results[0] = std::move(second);
+    }
+    auto rows = slice->rows();
+    VAST_ASSERT(rows <= st.query.cached);
+    st.query.cached -= rows;
+    st.query.requested -= rows;
+    st.query.shipped += rows;
+    self->send(st.sink, std::move(slice));
+  }
+}
+
+void report_statistics(self_ptr self) {
+  auto& st = self->state;
+  if (st.statistics_subscriber)
+    self->send(st.statistics_subscriber, st.name, st.query);
+}
+
+// Terminates after all nodes completed the query. We never request more
+// results from the nodes than the SINK asked for, so there is nothing left to
+// ship at this point.
+void shutdown_if_done(self_ptr self) {
+  auto& st = self->state;
+  if (st.nodes > 0 && st.exporters.empty()) {
+    VAST_DEBUG(self, "completed the query on", st.nodes, "node(s)");
+    self->send_exit(self, exit_reason::normal);
+  }
+}
+
+// Requests the results that the SINK asked for but that are neither cached
+// nor requested from a node yet, split evenly among all running nodes. Nodes
+// that deliver less than their share either run out of hits and terminate,
+// which hands their share to the other nodes, or get another share with the
+// next extract request.
+void request_results(self_ptr self) {
+  auto& st = self->state;
+  if (st.exporters.empty())
+    return;
+  if (st.query.requested == max_events) {
+    for (auto& [exporter, pending] : st.exporters)
+      if (pending != max_events) {
+        pending = max_events;
+        self->send(exporter, extract_atom::value);
+      }
+    return;
+  }
+  auto outstanding = st.query.cached;
+  for (auto& kvp : st.exporters)
+    outstanding += kvp.second;
+  if (outstanding >= st.query.requested)
+    return;
+  auto demand = st.query.requested - outstanding;
+  auto share = (demand + st.exporters.size() - 1) / st.exporters.size();
+  for (auto& [exporter, pending] : st.exporters) {
+    if (demand == 0)
+      break;
+    auto n = std::min(share, demand);
+    pending += n;
+    demand -= n;
+    self->send(exporter, extract_atom::value, n);
+  }
+}
+
+} // namespace
+
+caf::settings federated_exporter_state::status() {
+  caf::settings result;
+  put(result, "expression", to_string(expr));
+  put(result, "nodes", nodes);
+  put(result, "pending-nodes", exporters.size());
+  put(result, "shipped", query.shipped);
+  return result;
+}
+
+behavior
+federated_exporter(stateful_actor<federated_exporter_state>* self,
+                   tracker_type tracker, expression expr, query_options opts,
+                   query_budget budget, std::vector<std::string> projection) {
+  VAST_ASSERT(!has_continuous_option(opts));
+  self->state.tracker = std::move(tracker);
+  self->state.expr = std::move(expr);
+  self->state.options = opts;
+  self->state.budget = std::move(budget);
+  self->state.projection = std::move(projection);
+  self->set_exit_handler([=](const exit_msg& msg) {
+    VAST_DEBUG(self, "received exit from", msg.source,
+               "with reason:", msg.reason);
+    for (auto& kvp : self->state.exporters)
+      self->send_exit(kvp.first, msg.reason);
+    if (msg.reason != exit_reason::kill)
+      report_statistics(self);
+    self->quit(msg.reason);
+  });
+  self->set_down_handler([=](const down_msg& msg) {
+    auto& st = self->state;
+    if (msg.source == st.sink) {
+      VAST_DEBUG(self, "received DOWN from sink", msg.source);
+      for (auto& kvp : st.exporters)
+        self->send_exit(kvp.first, exit_reason::user_shutdown);
+      report_statistics(self);
+      self->quit(msg.reason);
+      return;
+    }
+    auto i = std::find_if(st.exporters.begin(), st.exporters.end(),
+                          [&](auto& kvp) { return kvp.first == msg.source; });
+    if (i == st.exporters.end())
+      return;
+    VAST_DEBUG(self, "received DOWN from node exporter", msg.source);
+    if (msg.reason)
+      VAST_WARNING(self, "lost a node:", self->system().render(msg.reason));
+    st.exporters.erase(i);
+    // Hand the outstanding share of the node to the others.
+    request_results(self);
+    shutdown_if_done(self);
+  });
+  return {
+    [=](const table_slice_ptr& slice) {
+      auto& st = self->state;
+      VAST_ASSERT(slice != nullptr);
+      auto sender = actor_cast<actor>(self->current_sender());
+      if (auto i = st.exporters.find(sender); i != st.exporters.end()
+                                              && i->second != max_events)
+        i->second -= std::min(i->second, uint64_t{slice->rows()});
+      st.query.cached += slice->rows();
+      st.results.push_back(slice);
+      ship_results(self);
+    },
+    [=](const std::string&, const query_status& qs) {
+      // A node reports its final statistics.
+      auto& st = self->state;
+      st.query.runtime = std::max(st.query.runtime, qs.runtime);
+      st.query.expected += qs.expected;
+      st.query.scheduled += qs.scheduled;
+      st.query.received += qs.received;
+      st.query.lookups_issued += qs.lookups_issued;
+      st.query.lookups_complete += qs.lookups_complete;
+      st.query.processed += qs.processed;
+    },
+    [=](extract_atom) {
+      auto& qs = self->state.query;
+      if (qs.requested == max_events) {
+        VAST_WARNING(self, "ignores extract request, already getting all");
+        return;
+      }
+      qs.requested = max_events;
+      ship_results(self);
+      request_results(self);
+    },
+    [=](extract_atom, uint64_t requested_results) {
+      auto& qs = self->state.query;
+      if (requested_results == 0) {
+        VAST_WARNING(self, "ignores extract request for 0 results");
+        return;
+      }
+      if (qs.requested == max_events) {
+        VAST_WARNING(self, "ignores extract request, already getting all");
+        return;
+      }
+      auto n = std::min(max_events - requested_results, requested_results);
+      qs.requested += n;
+      ship_results(self);
+      request_results(self);
+    },
+    [=](status_atom) {
+      auto result = self->state.status();
+      detail::fill_status_map(result, self);
+      return result;
+    },
+    [=](const archive_type&) {
+      // The node wires every EXPORTER to its local ARCHIVE and INDEX, but we
+      // look up the components of all nodes ourselves when running.
+      VAST_DEBUG(self, "ignores local archive");
+    },
+    [=](index_atom, const actor&) {
+      VAST_DEBUG(self, "ignores local index");
+    },
+    [=](sink_atom, const actor& sink) {
+      VAST_DEBUG(self, "registers sink", sink);
+      self->state.sink = sink;
+      self->monitor(sink);
+    },
+    [=](statistics_atom, const actor& statistics_subscriber) {
+      VAST_DEBUG(self, "registers statistics subscriber",
+                 statistics_subscriber);
+      self->state.statistics_subscriber = statistics_subscriber;
+    },
+    [=](run_atom) {
+      VAST_INFO(self, "executes federated query:",
+                to_string(self->state.expr));
+      self->request(self->state.tracker, infinite, get_atom::value).then(
+        [=](registry& reg) {
+          auto& st = self->state;
+          for (auto& [node, components] : reg.components) {
+            auto archive = components.find("archive");
+            auto index = components.find("index");
+            if (archive == components.end() || index == components.end()) {
+              VAST_DEBUG(self, "skips node without archive and index:", node);
+              continue;
+            }
+            VAST_DEBUG(self, "spawns exporter for node", node);
+            auto exp = self->spawn<monitored>(exporter, st.expr, st.options,
+                                              st.budget, st.projection);
+            self->send(exp, actor_cast<archive_type>(archive->second.actor));
+            self->send(exp, index_atom::value, index->second.actor);
+            self->send(exp, sink_atom::value, actor_cast<actor>(self));
+            self->send(exp, statistics_atom::value, actor_cast<actor>(self));
+            self->send(exp, run_atom::value);
+            st.exporters.emplace(exp, 0);
+          }
+          st.nodes = st.exporters.size();
+          if (st.exporters.empty()) {
+            VAST_WARNING(self, "found no node with an archive and an index");
+            self->send_exit(self, exit_reason::normal);
+            return;
+          }
+          request_results(self);
+        },
+        [=](const error& err) {
+          VAST_ERROR(self, "failed to retrieve the registry:",
+                     self->system().render(err));
+          self->send_exit(self, err);
+        });
+    },
+  };
+}
+
+} // namespace vast::system
@@ -13,6 +13,7 @@
 
 #include "vast/system/index.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
@@ -25,8 +26,10 @@
 #include "vast/detail/fill_status_map.hpp"
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/notifying_stream_manager.hpp"
+#include "vast/detail/thread_pool.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
+#include "vast/filesystem.hpp"
 #include "vast/ids.hpp"
 #include "vast/json.hpp"
 #include "vast/load.hpp"
@@ -44,6 +47,7 @@
 #include <caf/all.hpp>
 #include <caf/detail/unordered_flat_map.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <unordered_set>
@@ -67,12 +71,24 @@ auto make_index_stage(index_state* st) {
 partition_ptr index_state::partition_factory::operator()(const uuid& id) const {
   // The factory must not get called for the active partition nor for
   // partitions that are currently unpersisted.
-  VAST_ASSERT(st_->active == nullptr || id != st_->active->id());
+  VAST_ASSERT(st_->find_active(id) == nullptr);
   VAST_ASSERT(std::none_of(st_->unpersisted.begin(), st_->unpersisted.end(),
                            [&](auto& kvp) { return kvp.first->id() == id; }));
+  auto result = std::make_unique<partition>(st_, id, st_->max_partition_size);
+  // Prefer the state that the loader read ahead, which only blocks if the
+  // loader has not finished reading yet.
+  if (auto i = st_->prefetched.find(id); i != st_->prefetched.end()) {
+    auto snapshot = i->second.get();
+    st_->prefetched.erase(i);
+    if (snapshot) {
+      result->init(std::move(*snapshot));
+      return result;
+    }
+    VAST_WARNING(st_->self, "failed to read ahead partition", id, "-",
+                 st_->self->system().render(snapshot.error()));
+  }
   // Load partition from disk.
   VAST_DEBUG(st_->self, "loads partition", id);
-  auto result = std::make_unique<partition>(st_, id, st_->max_partition_size);
   if (auto err = result->init())
     VAST_ERROR(st_->self, "unable to load partition state from disk:", id);
   return result;
@@ -101,6 +117,34 @@ caf::error index_state::init(const path& dir, size_t max_partition_size,
   this->max_partition_size = max_partition_size;
   this->lru_partitions.size(in_mem_partitions);
   this->taste_partitions = taste_partitions;
+  // Configure routing by event time.
+  namespace sd = defaults::system;
+  auto& cfg = self->system().config();
+  partition_time_window = get_or(cfg, "system.partition-time-window",
+                                 duration{sd::partition_time_window});
+  max_open_partitions = std::max(size_t{1},
+                                 get_or(cfg, "system.max-open-partitions",
+                                        sd::max_open_partitions));
+  auto meta_index_threads = get_or(cfg, "system.meta-index-threads",
+                                  sd::meta_index_threads);
+  if (meta_index_threads > 0)
+    meta_idx.parallelize(
+      std::make_shared<detail::thread_pool>(meta_index_threads));
+  auto loader_threads = get_or(cfg, "system.loader-threads",
+                               sd::loader_threads);
+  if (loader_threads > 0)
+    loader = std::make_unique<detail::thread_pool>(loader_threads);
+  readahead_partitions = get_or(cfg, "system.readahead-partitions",
+                                sd::readahead_partitions);
+  late_data_policy = get_or(cfg, "system.late-data-policy",
+                            sd::late_data_policy);
+  if (late_data_policy != atom("evict") && late_data_policy != atom("nearest"))
+    return make_error(ec::invalid_configuration, "invalid late data policy",
+                      to_string(late_data_policy));
+  if (partition_time_window > duration::zero())
+    VAST_VERBOSE(self, "routes slices to partitions by event time in buckets "
+                       "of",
+                 to_string(partition_time_window));
   if (auto a = self->system().registry().get(accountant_atom::value)) {
     namespace defs = defaults::system;
     this->accountant = actor_cast<accountant_type>(a);
@@ -162,10 +206,13 @@ caf::error index_state::flush_to_disk() {
     // Flush statistics to disk.
     if (auto err = flush_statistics())
       return err;
-    // Flush active partition.
+    // Flush active partitions.
     if (active != nullptr)
       if (auto err = active->flush_to_disk())
         return err;
+    for (auto& [key, bucket] : buckets)
+      if (auto err = bucket.part->flush_to_disk())
+        return err;
     // Flush all unpersisted partitions. This only writes the meta state of
     // each table_indexer. For actually writing the contents of each INDEXER we
     // need to rely on messaging.
@@ -199,6 +246,30 @@ caf::actor index_state::next_worker() {
   return result;
 }
 
+void index_state::dispatch(expression expr, query_map qm, caf::actor client,
+                           time deadline) {
+  auto worker = next_worker();
+  auto& partitions = busy_workers[worker];
+  for (auto& kvp : qm) {
+    partitions.push_back(kvp.first);
+    ++evaluating[kvp.first];
+  }
+  self->send(worker, std::move(expr), std::move(qm), std::move(client),
+             deadline);
+}
+
+void index_state::add_idle_worker(caf::actor worker) {
+  if (auto i = busy_workers.find(worker); i != busy_workers.end()) {
+    for (auto& id : i->second) {
+      auto j = evaluating.find(id);
+      if (j != evaluating.end() && --j->second == 0)
+        evaluating.erase(j);
+    }
+    busy_workers.erase(i);
+  }
+  idle_workers.emplace_back(std::move(worker));
+}
+
 caf::dictionary<caf::config_value> index_state::status() const {
   using caf::put_dictionary;
   using caf::put_list;
@@ -220,6 +291,11 @@ caf::dictionary<caf::config_value> index_state::status() const {
   auto& partitions = put_dictionary(result, "partitions");
   if (active != nullptr)
     partitions.emplace("active", to_string(active->id()));
+  if (!buckets.empty()) {
+    auto& open = put_list(partitions, "open");
+    for (auto& [key, bucket] : buckets)
+      open.emplace_back(to_string(bucket.part->id()));
+  }
   auto& cached = put_list(partitions, "cached");
   for (auto& part : lru_partitions.elements())
     cached.emplace_back(to_string(part->id()));
@@ -264,6 +340,8 @@ void index_state::send_report() {
   };
   if (active)
     append_report(*active);
+  for (auto& [key, bucket] : buckets)
+    append_report(*bucket.part);
   for (auto& p : unpersisted)
     append_report(*p.first);
   if (min.events > 0) {
@@ -285,13 +363,22 @@ void index_state::send_report() {
 void index_state::reset_active_partition() {
   // Persist meta data and the state of all INDEXER actors when the active
   // partition gets replaced becomes full.
-  if (active != nullptr) {
-    if (auto err = active->flush_to_disk())
-      VAST_ERROR(self, "failed to persist active partition");
+  if (active != nullptr)
+    retire_partition(std::move(active), active_partition_indexers);
+  else
+    retire_partition(nullptr, 0);
+  active = make_partition();
+  active_partition_indexers = 0;
+}
+
+void index_state::retire_partition(partition_ptr part, size_t num_indexers) {
+  if (part != nullptr) {
+    if (auto err = part->flush_to_disk())
+      VAST_ERROR(self, "failed to persist partition", part->id());
     // Store this partition as unpersisted to make sure we're not attempting
     // to load it from disk until it is safe to do so.
-    if (active_partition_indexers > 0)
-      unpersisted.emplace_back(std::move(active), active_partition_indexers);
+    if (num_indexers > 0)
+      unpersisted.emplace_back(std::move(part), num_indexers);
   }
   // Persist the current version of the meta_index and statistics to preserve
   // the state and be partially robust against crashes.
@@ -299,8 +386,29 @@ void index_state::reset_active_partition() {
     VAST_ERROR(self, "failed to persist the meta index");
   if (auto err = flush_statistics())
     VAST_ERROR(self, "failed to persist the statistics");
-  active = make_partition();
-  active_partition_indexers = 0;
+}
+
+time index_state::time_bucket_of(const table_slice& slice) const {
+  VAST_ASSERT(partition_time_window > duration::zero());
+  auto& fields = slice.layout().fields;
+  auto has_timestamp = [](auto& field) {
+    return has_attribute(field.type, "timestamp");
+  };
+  auto i = std::find_if(fields.begin(), fields.end(), has_timestamp);
+  if (i == fields.end())
+    return time::min();
+  auto column = static_cast<size_t>(std::distance(fields.begin(), i));
+  // We route entire slices by their earliest event.
+  auto result = time::max();
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    auto x = slice.at(row, column);
+    if (auto ts = caf::get_if<view<time>>(&x))
+      result = std::min(result, *ts);
+  }
+  if (result == time::max())
+    return time::min();
+  auto since_epoch = result.time_since_epoch();
+  return time{since_epoch - since_epoch % partition_time_window};
 }
 
 partition_ptr index_state::make_partition() {
@@ -323,8 +431,14 @@ caf::actor index_state::make_indexer(path dir, type column_type, size_t column,
 }
 
 void index_state::decrement_indexer_count(uuid partition_id) {
-  if (partition_id == active->id())
+  auto is_bucket = [&](auto& kvp) {
+    return kvp.second.part->id() == partition_id;
+  };
+  if (active != nullptr && partition_id == active->id())
     active_partition_indexers--;
+  else if (auto j = std::find_if(buckets.begin(), buckets.end(), is_bucket);
+           j != buckets.end())
+    j->second.indexers--;
   else {
     auto i = std::find_if(unpersisted.begin(), unpersisted.end(),
                           [&](auto& kvp) {
@@ -340,12 +454,104 @@ void index_state::decrement_indexer_count(uuid partition_id) {
   }
 }
 
+ids index_state::erase_older_than(time cutoff) {
+  ids result;
+  size_t dropped = 0;
+  auto has_timestamp = [](const record_type& layout) {
+    return std::any_of(layout.fields.begin(), layout.fields.end(),
+                       [](auto& field) {
+                         return has_attribute(field.type, "timestamp");
+                       });
+  };
+  for (auto& id : meta_idx.lookup_older_than(cutoff)) {
+    // Partitions that still receive or persist data never qualify.
+    if (find_active(id) != nullptr || find_unpersisted(id) != nullptr)
+      continue;
+    // The EVALUATOR actors of running queries still talk to the INDEXER
+    // actors of the partition, so we leave it to a later run.
+    if (evaluating.count(id) > 0) {
+      VAST_DEBUG(self, "defers erasing partition", id,
+                 "until running queries finish");
+      continue;
+    }
+    // Take ownership of the partition, either from the cache or from disk.
+    partition_ptr part;
+    auto& cached = lru_partitions.elements();
+    auto i = std::find_if(cached.begin(), cached.end(), partition_lookup{}(id));
+    if (i != cached.end()) {
+      part = std::move(*i);
+      cached.erase(i);
+    } else {
+      part = partition_factory{this}(id);
+    }
+    // The meta index has no synopses for layouts without any indexable
+    // field, so we double-check that we can age out all layouts. A partition
+    // without layouts failed to load.
+    auto layouts = part->layouts();
+    if (layouts.empty()
+        || !std::all_of(layouts.begin(), layouts.end(), has_timestamp)) {
+      VAST_DEBUG(self, "keeps partition", id, "with untimed layouts");
+      lru_partitions.add(std::move(part));
+      continue;
+    }
+    // Collect the row IDs of all layouts before touching any state, so that
+    // the ARCHIVE drops exactly the events that the INDEX forgets.
+    std::vector<std::pair<std::string, ids>> partition_ids;
+    for (auto& layout : layouts) {
+      auto ti = part->get_or_add(layout);
+      if (!ti)
+        break;
+      partition_ids.emplace_back(layout.name(), ti->first.row_ids());
+    }
+    if (partition_ids.size() < layouts.size()) {
+      VAST_ERROR(self, "failed to load row IDs of partition", id);
+      lru_partitions.add(std::move(part));
+      continue;
+    }
+    for (auto& [name, row_ids] : partition_ids) {
+      result |= row_ids;
+      auto& layout_stats = stats.layouts[name];
+      layout_stats.count -= std::min<uint64_t>(layout_stats.count,
+                                               rank(row_ids));
+    }
+    prefetched.erase(id);
+    for (auto& [query_id, lookup] : pending) {
+      auto& xs = lookup.partitions;
+      xs.erase(std::remove(xs.begin(), xs.end(), id), xs.end());
+    }
+    meta_idx.erase(id);
+    auto part_dir = part->base_dir();
+    part.reset();
+    if (!rm(part_dir))
+      VAST_WARNING(self, "failed to remove partition directory", part_dir);
+    ++dropped;
+  }
+  if (dropped > 0) {
+    VAST_INFO(self, "erased", dropped, "partitions with", rank(result),
+              "events");
+    if (auto err = flush_meta_index())
+      VAST_ERROR(self, "failed to persist the meta index");
+    if (auto err = flush_statistics())
+      VAST_ERROR(self, "failed to persist the statistics");
+  }
+  return result;
+}
+
 partition* index_state::find_unpersisted(const uuid& id) {
   auto i = std::find_if(unpersisted.begin(), unpersisted.end(),
                         [&](auto& kvp) { return kvp.first->id() == id; });
   return i != unpersisted.end() ? i->first.get() : nullptr;
 }
 
+partition* index_state::find_active(const uuid& id) {
+  if (active != nullptr && active->id() == id)
+    return active.get();
+  for (auto& [key, bucket] : buckets)
+    if (bucket.part->id() == id)
+      return bucket.part.get();
+  return nullptr;
+}
+
 using pending_query_map = caf::detail::unordered_flat_map<uuid, evaluation_map>;
 
 pending_query_map
@@ -353,13 +559,19 @@ index_state::build_query_map(lookup_state& lookup, uint32_t num_partitions) {
   VAST_TRACE(VAST_ARG(lookup), VAST_ARG(num_partitions));
   if (num_partitions == 0 || lookup.partitions.empty())
     return {};
-  // Prefer partitions that are already available in RAM.
-  std::partition(lookup.partitions.begin(), lookup.partitions.end(),
-                 [&](const uuid& candidate) {
-                   return (active != nullptr && active->id() == candidate)
-                          || find_unpersisted(candidate) != nullptr
-                          || lru_partitions.contains(candidate);
-                 });
+  // Prefer partitions that are already available in RAM, unless the client
+  // relies on the order of the candidates. The partitioning must be stable
+  // so that we evaluate partitions in the order that we read them ahead.
+  if (!lookup.ordered)
+    std::stable_partition(lookup.partitions.begin(), lookup.partitions.end(),
+                          [&](const uuid& candidate) {
+                            return find_active(candidate) != nullptr
+                                   || find_unpersisted(candidate) != nullptr
+                                   || lru_partitions.contains(candidate);
+                          });
+  // Read the partitions that we evaluate now in parallel, and keep reading
+  // the subsequent ones while they evaluate.
+  prefetch(lookup, num_partitions + readahead_partitions);
   // Maps partition IDs to the EVALUATOR actors we are going to spawn.
   pending_query_map result;
   // Helper function to spin up EVALUATOR actors for a single partition.
@@ -367,8 +579,8 @@ index_state::build_query_map(lookup_state& lookup, uint32_t num_partitions) {
     // We need to first check whether the ID is the active partition or one
     // of our unpersistet ones. Only then can we dispatch to our LRU cache.
     partition* part;
-    if (active != nullptr && active->id() == partition_id)
-      part = active.get();
+    if (auto ptr = find_active(partition_id); ptr != nullptr)
+      part = ptr;
     else if (auto ptr = find_unpersisted(partition_id); ptr != nullptr)
       part = ptr;
     else
@@ -394,6 +606,43 @@ index_state::build_query_map(lookup_state& lookup, uint32_t num_partitions) {
   return result;
 }
 
+void index_state::prefetch(const lookup_state& lookup, size_t num_partitions) {
+  if (loader == nullptr)
+    return;
+  // Forget partitions that no query needs anymore, e.g., because a client
+  // dropped its query before evaluating all candidates.
+  auto max_prefetched = (taste_partitions + readahead_partitions)
+                        * (pending.size() + 1);
+  if (prefetched.size() >= max_prefetched) {
+    std::unordered_set<uuid> needed{lookup.partitions.begin(),
+                                    lookup.partitions.end()};
+    for (auto& kvp : pending)
+      needed.insert(kvp.second.partitions.begin(),
+                    kvp.second.partitions.end());
+    for (auto i = prefetched.begin(); i != prefetched.end();) {
+      if (needed.count(i->first) == 0)
+        i = prefetched.erase(i);
+      else
+        ++i;
+    }
+  }
+  for (auto& id : lookup.partitions) {
+    if (num_partitions == 0)
+      break;
+    if (find_active(id) != nullptr || find_unpersisted(id) != nullptr
+        || lru_partitions.contains(id))
+      continue;
+    --num_partitions;
+    if (prefetched.count(id) > 0)
+      continue;
+    VAST_DEBUG(self, "reads ahead partition", id);
+    prefetched.emplace(id, loader->async([part_dir = dir / to_string(id),
+                                          expr = lookup.expr] {
+      return partition::read(part_dir, expr);
+    }));
+  }
+}
+
 query_map
 index_state::launch_evaluators(pending_query_map pqm, expression expr) {
   query_map result;
@@ -404,6 +653,18 @@ index_state::launch_evaluators(pending_query_map pqm, expression expr) {
   return result;
 }
 
+void index_state::drop_expired_lookups() {
+  time now = std::chrono::system_clock::now();
+  for (auto i = pending.begin(); i != pending.end();) {
+    if (i->second.deadline < now) {
+      VAST_DEBUG(self, "drops expired lookup for query ID", i->first);
+      i = pending.erase(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
 void index_state::add_flush_listener(caf::actor listener) {
   VAST_DEBUG(self, "adds a new 'flush' subscriber:", listener);
   flush_listeners.emplace_back(std::move(listener));
@@ -445,65 +706,108 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
   // We switch between has_worker behavior and the default behavior (which
   // simply waits for a worker).
   self->set_default_handler(caf::skip);
+  auto handle_query = [=](expression& expr, const query_budget& budget,
+                          bool ordered) {
+    auto respond = [&](auto&&... xs) {
+      auto mid = self->current_message_id();
+      unsafe_response(self, self->current_sender(), {}, mid.response_id(),
+                      std::forward<decltype(xs)>(xs)...);
+    };
+    // Ordered queries additionally receive upper bounds for the event
+    // timestamps of all candidate partitions in scheduling order.
+    auto respond_lookup = [&](const uuid& query_id, uint32_t hits,
+                              uint32_t scheduled,
+                              std::vector<time> bounds = {}) {
+      if (ordered)
+        respond(query_id, hits, scheduled, std::move(bounds));
+      else
+        respond(query_id, hits, scheduled);
+    };
+    // Sanity check.
+    if (self->current_sender() == nullptr) {
+      VAST_ERROR(self, "got an anonymous query (ignored)");
+      respond(sec::invalid_argument);
+      return;
+    }
+    auto& st = self->state;
+    st.drop_expired_lookups();
+    auto client = caf::actor_cast<caf::actor>(self->current_sender());
+    // Convenience function for dropping out without producing hits. Makes
+    // sure that clients always receive a 'done' message.
+    auto no_result = [&] {
+      respond_lookup(uuid::nil(), 0, 0);
+      self->send(client, done_atom::value);
+    };
+    // Get all potentially matching partitions.
+    auto candidates = st.meta_idx.lookup(expr);
+    // Report no result if no candidates are found.
+    if (candidates.empty()) {
+      VAST_DEBUG(self, "returns without result: no partitions qualify");
+      no_result();
+      return;
+    }
+    // Ordered queries evaluate the most recent partitions first.
+    std::vector<time> bounds;
+    if (ordered) {
+      std::vector<std::pair<time, uuid>> ranked;
+      ranked.reserve(candidates.size());
+      for (auto& candidate : candidates)
+        ranked.emplace_back(st.meta_idx.max_timestamp(candidate), candidate);
+      std::stable_sort(ranked.begin(), ranked.end(),
+                       [](auto& x, auto& y) { return x.first > y.first; });
+      bounds.reserve(ranked.size());
+      for (size_t i = 0; i < ranked.size(); ++i) {
+        candidates[i] = ranked[i].second;
+        bounds.push_back(ranked[i].first);
+      }
+    }
+    // Allows the client to query further results after initial taste.
+    auto query_id = uuid::random();
+    auto lookup = index_state::lookup_state{
+      expr, std::move(candidates), budget,
+      deadline(budget, std::chrono::system_clock::now()), ordered};
+    // The budget of the query may further restrict the initial taste.
+    auto taste = taste_partitions;
+    if (budget.max_partitions > 0)
+      taste = std::min(taste, budget.max_partitions);
+    auto pqm = st.build_query_map(lookup, detail::narrow<uint32_t>(taste));
+    if (pqm.empty()) {
+      VAST_ASSERT(lookup.partitions.empty());
+      VAST_DEBUG(self, "returns without result: no partitions qualify");
+      no_result();
+      return;
+    }
+    auto hits = pqm.size() + lookup.partitions.size();
+    auto scheduling = std::min(taste, hits);
+    // Notify the client that we don't have more hits.
+    if (scheduling == hits)
+      query_id = uuid::nil();
+    respond_lookup(query_id, detail::narrow<uint32_t>(hits),
+                   detail::narrow<uint32_t>(scheduling), std::move(bounds));
+    auto qm = st.launch_evaluators(pqm, expr);
+    VAST_DEBUG(self, "scheduled", qm.size(), "/", hits,
+               "partitions for query", expr);
+    auto query_deadline = lookup.deadline;
+    if (!lookup.partitions.empty()) {
+      [[maybe_unused]] auto result
+        = st.pending.emplace(query_id, std::move(lookup));
+      VAST_ASSERT(result.second);
+    }
+    // Delegate to query supervisor (uses up this worker) and report
+    // query ID + some stats to the client.
+    st.dispatch(std::move(expr), std::move(qm), client, query_deadline);
+    if (!st.worker_available())
+      self->unbecome();
+  };
   self->state.has_worker.assign(
     [=](expression& expr) {
-      auto respond = [&](auto&&... xs) {
-        auto mid = self->current_message_id();
-        unsafe_response(self, self->current_sender(), {}, mid.response_id(),
-                        std::forward<decltype(xs)>(xs)...);
-      };
-      // Sanity check.
-      if (self->current_sender() == nullptr) {
-        VAST_ERROR(self, "got an anonymous query (ignored)");
-        respond(sec::invalid_argument);
-        return;
-      }
-      auto& st = self->state;
-      auto client = caf::actor_cast<caf::actor>(self->current_sender());
-      // Convenience function for dropping out without producing hits. Makes
-      // sure that clients always receive a 'done' message.
-      auto no_result = [&] {
-        respond(uuid::nil(), uint32_t{0}, uint32_t{0});
-        self->send(client, done_atom::value);
-      };
-      // Get all potentially matching partitions.
-      auto candidates = st.meta_idx.lookup(expr);
-      // Report no result if no candidates are found.
-      if (candidates.empty()) {
-        VAST_DEBUG(self, "returns without result: no partitions qualify");
-        no_result();
-        return;
-      }
-      // Allows the client to query further results after initial taste.
-      auto query_id = uuid::random();
-      auto lookup = index_state::lookup_state{expr, std::move(candidates)};
-      auto pqm = st.build_query_map(lookup, st.taste_partitions);
-      if (pqm.empty()) {
-        VAST_ASSERT(lookup.partitions.empty());
-        VAST_DEBUG(self, "returns without result: no partitions qualify");
-        no_result();
-        return;
-      }
-      auto hits = pqm.size() + lookup.partitions.size();
-      auto scheduling = std::min(taste_partitions, hits);
-      // Notify the client that we don't have more hits.
-      if (scheduling == hits)
-        query_id = uuid::nil();
-      respond(query_id, detail::narrow<uint32_t>(hits),
-              detail::narrow<uint32_t>(scheduling));
-      auto qm = st.launch_evaluators(pqm, expr);
-      VAST_DEBUG(self, "scheduled", qm.size(), "/", hits,
-                 "partitions for query", expr);
-      if (!lookup.partitions.empty()) {
-        [[maybe_unused]] auto result
-          = st.pending.emplace(query_id, std::move(lookup));
-        VAST_ASSERT(result.second);
-      }
-      // Delegate to query supervisor (uses up this worker) and report
-      // query ID + some stats to the client.
-      self->send(st.next_worker(), std::move(expr), std::move(qm), client);
-      if (!st.worker_available())
-        self->unbecome();
+      handle_query(expr, query_budget{}, false);
+    },
+    [=](expression& expr, const query_budget& budget) {
+      handle_query(expr, budget, false);
+    },
+    [=](timestamp_atom, expression& expr, const query_budget& budget) {
+      handle_query(expr, budget, true);
     },
     [=](const uuid& query_id, uint32_t num_partitions) {
       auto& st = self->state;
@@ -513,6 +817,7 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
         st.pending.erase(query_id);
         return;
       }
+      st.drop_expired_lookups();
       // Sanity checks.
       if (self->current_sender() == nullptr) {
         VAST_ERROR(self, "got an anonymous query (ignored)");
@@ -525,6 +830,10 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
         self->send(client, done_atom::value);
         return;
       }
+      auto& budget = iter->second.budget;
+      if (budget.max_partitions > 0)
+        num_partitions = std::min(
+          num_partitions, detail::narrow<uint32_t>(budget.max_partitions));
       auto pqm = st.build_query_map(iter->second, num_partitions);
       if (pqm.empty()) {
         VAST_ASSERT(iter->second.partitions.empty());
@@ -539,13 +848,14 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
       VAST_DEBUG(self, "schedules", qm.size(), "more partition(s) for query",
                  iter->first, "with", iter->second.partitions.size(),
                  "remaining");
-      self->send(st.next_worker(), iter->second.expr, std::move(qm), client);
+      st.dispatch(iter->second.expr, std::move(qm), client,
+                  iter->second.deadline);
       // Cleanup if we exhausted all candidates.
       if (iter->second.partitions.empty())
         st.pending.erase(iter);
     },
     [=](worker_atom, caf::actor& worker) {
-      self->state.idle_workers.emplace_back(std::move(worker));
+      self->state.add_idle_worker(std::move(worker));
     },
     [=](done_atom, uuid partition_id) {
       self->state.decrement_indexer_count(partition_id);
@@ -564,10 +874,13 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
     },
     [=](subscribe_atom, flush_atom, actor& listener) {
       self->state.add_flush_listener(std::move(listener));
+    },
+    [=](erase_atom, time cutoff) {
+      return self->state.erase_older_than(cutoff);
     });
   return {[=](worker_atom, caf::actor& worker) {
             auto& st = self->state;
-            st.idle_workers.emplace_back(std::move(worker));
+            st.add_idle_worker(std::move(worker));
             self->become(keep_behavior, st.has_worker);
           },
           [=](done_atom, uuid partition_id) {
@@ -588,6 +901,9 @@ behavior index(stateful_actor<index_state>* self, const path& dir,
           },
           [=](subscribe_atom, flush_atom, actor& listener) {
             self->state.add_flush_listener(std::move(listener));
+          },
+          [=](erase_atom, time cutoff) {
+            return self->state.erase_older_than(cutoff);
           }};
 }
 
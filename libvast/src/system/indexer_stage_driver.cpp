@@ -28,7 +28,8 @@ namespace vast::system {
 
 bool indexer_stage_selector::operator()(const indexer_stage_filter& f,
                                         const table_slice_ptr& x) const {
-  return f == x->layout();
+  return f.layout == x->layout()
+         && (f.target == nullptr || *f.target == f.partition);
 }
 
 indexer_stage_driver::indexer_stage_driver(downstream_manager_type& dm,
@@ -45,6 +46,8 @@ void indexer_stage_driver::process(downstream_type& out, batch_type& slices) {
   VAST_TRACE(CAF_ARG(slices));
   VAST_ASSERT(!slices.empty());
   auto& st = self_->state;
+  if (st.partition_time_window > duration::zero())
+    return process_by_time(out, slices);
   for (auto& slice : slices) {
     // Spin up an initial partition if needed.
     if (st.active == nullptr)
@@ -70,7 +73,7 @@ void indexer_stage_driver::process(downstream_type& out, batch_type& slices) {
               auto slt = out_.parent()
                            ->add_unchecked_outbound_path<output_type>(x);
               VAST_DEBUG(st.self, "spawned new INDEXER at slot", slt);
-              out_.set_filter(slt, layout);
+              out_.set_filter(slt, {layout, st.active->id()});
               st.active_partition_indexers++;
             }
           }
@@ -99,4 +102,96 @@ void indexer_stage_driver::process(downstream_type& out, batch_type& slices) {
   }
 }
 
+void indexer_stage_driver::process_by_time(downstream_type& out,
+                                           batch_type& slices) {
+  auto& st = self_->state;
+  // Moves all buffered slices to the paths of the current target partition.
+  // We must call this before switching to another target, because the
+  // selector only ships slices to the INDEXER actors of the current target.
+  auto flush = [&] {
+    if (out_.buf().size() != 0)
+      out_.fan_out_flush();
+  };
+  auto close_bucket = [&](index_state::time_bucket_map::iterator i) {
+    auto& bucket = i->second;
+    VAST_DEBUG(st.self, "closes partition", bucket.part->id(), "with",
+               bucket.slots.size(), "slots");
+    flush();
+    out_.force_emit_batches();
+    for (auto slot : bucket.slots)
+      out_.close(slot);
+    st.retire_partition(std::move(bucket.part), bucket.indexers);
+    st.buckets.erase(i);
+  };
+  for (auto& slice : slices) {
+    auto key = st.time_bucket_of(*slice);
+    auto i = st.buckets.find(key);
+    if (i == st.buckets.end()) {
+      // Slices without timestamps never count as late.
+      auto late = key != time::min() && !st.buckets.empty()
+                  && key < st.buckets.begin()->first;
+      if (st.buckets.size() >= st.max_open_partitions) {
+        if (late && st.late_data_policy == caf::atom("nearest")) {
+          i = st.buckets.begin();
+        } else {
+          // Close the least recent bucket to make room for the new one.
+          close_bucket(st.buckets.begin());
+        }
+      }
+      if (i == st.buckets.end()) {
+        if (late)
+          VAST_DEBUG(st.self, "opens a partition for late data at", key);
+        i = st.buckets.emplace(key, index_state::time_bucket{}).first;
+        i->second.part = st.make_partition();
+      }
+    }
+    auto& bucket = i->second;
+    auto& part = *bucket.part;
+    if (st.routing_target != part.id()) {
+      flush();
+      st.routing_target = part.id();
+    }
+    // Update meta index.
+    st.meta_idx.add(part.id(), *slice);
+    // Update statistics.
+    auto& layout = slice->layout();
+    st.stats.layouts[layout.name()].count += slice->rows();
+    // Start new INDEXER actors when needed and add it to the stream.
+    if (auto ti = part.get_or_add(layout)) {
+      auto [meta_x, added] = *ti;
+      if (added) {
+        VAST_DEBUG(st.self, "added a new table_indexer for layout", layout);
+        if (auto err = meta_x.init()) {
+          VAST_ERROR(st.self, "failed to initialize table_indexer for layout",
+                     layout, "-> all incoming logs get dropped!");
+        } else {
+          meta_x.spawn_indexers();
+          for (auto& x : meta_x.indexers()) {
+            // We'll have invalid handles at all fields with skip attribute.
+            if (x) {
+              auto slt = out_.parent()
+                           ->add_unchecked_outbound_path<output_type>(x);
+              VAST_DEBUG(st.self, "spawned new INDEXER at slot", slt);
+              out_.set_filter(slt, {layout, part.id(), &st.routing_target});
+              bucket.slots.push_back(slt);
+              bucket.indexers++;
+            }
+          }
+        }
+      }
+      // Add all rows IDs to the meta indexer.
+      meta_x.add(slice);
+    }
+    // Ship event to the INDEXER actors.
+    auto slice_size = slice->rows();
+    out.push(std::move(slice));
+    // Finalize full partitions.
+    if (part.capacity() <= slice_size)
+      close_bucket(i);
+    else
+      part.reduce_capacity(slice_size);
+  }
+  flush();
+}
+
 } // namespace vast::system
@@ -15,12 +15,15 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/endpoint.hpp"
+#include "vast/concept/parseable/vast/time.hpp"
 #include "vast/concept/printable/stream.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/json.hpp"
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/config.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/ids.hpp"
 #include "vast/json.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/accountant.hpp"
@@ -40,6 +43,7 @@
 #include "vast/system/spawn_sink.hpp"
 #include "vast/system/spawn_source.hpp"
 #include "vast/system/spawn_type_registry.hpp"
+#include "vast/time.hpp"
 
 #include <caf/all.hpp>
 #include <caf/io/all.hpp>
@@ -47,6 +51,7 @@
 #include <chrono>
 #include <csignal>
 #include <fstream>
+#include <functional>
 #include <sstream>
 
 using namespace caf;
@@ -204,6 +209,52 @@ spawn_component(const command::invocation& invocation, spawn_arguments& args) {
   return i->second(self, args);
 }
 
+// Erases all events older than `cutoff` from the INDEX and the ARCHIVE. The
+// INDEX drops entire partitions and reports the IDs of their events, which
+// allows the ARCHIVE to drop all segments that contain only these IDs.
+void erase_older_than(node_actor* self, time cutoff,
+                      std::function<void(caf::error)> done) {
+  auto& st = self->state;
+  if (!st.index || !st.archive) {
+    done(make_error(ec::missing_component, "erase requires INDEX and ARCHIVE"));
+    return;
+  }
+  auto archive = st.archive;
+  self->request(st.index, infinite, erase_atom::value, cutoff).then(
+    [=](const ids& xs) {
+      if (rank(xs) == 0) {
+        VAST_DEBUG(self, "found no events to erase");
+        done(caf::none);
+        return;
+      }
+      VAST_INFO(self, "erases", rank(xs), "events");
+      self->request(archive, infinite, erase_atom::value, xs).then(
+        [=]() { done(caf::none); },
+        [=](caf::error& err) { done(std::move(err)); });
+    },
+    [=](caf::error& err) { done(std::move(err)); });
+}
+
+caf::message
+erase_command(const command::invocation& invocation, caf::actor_system&) {
+  auto older_than = caf::get_if<std::string>(&invocation.options,
+                                             "erase.older-than");
+  if (older_than == nullptr)
+    return make_error_msg(ec::syntax_error, "missing option --older-than");
+  auto age = to<duration>(*older_than);
+  if (!age)
+    return make_error_msg(ec::parse_error, "invalid duration " + *older_than);
+  auto rp = this_node->make_response_promise();
+  erase_older_than(this_node, make_timestamp() - *age,
+                   [rp](caf::error err) mutable {
+                     if (err)
+                       rp.deliver(std::move(err));
+                     else
+                       rp.deliver(ok_atom::value);
+                   });
+  return caf::none;
+}
+
 caf::message
 kill_command(const command::invocation& invocation, caf::actor_system&) {
   auto first = invocation.arguments.begin();
@@ -275,6 +326,7 @@ auto make_command_factory() {
   // When updating this list, remember to update its counterpart in
   // application.cpp as well iff necessary
   return command::factory{
+    {"erase", erase_command},
     {"kill", kill_command},
     {"peer", peer_command},
     {"send", send_command},
@@ -393,6 +445,15 @@ void node_state::init(std::string init_name, path init_dir) {
 
 caf::behavior node(node_actor* self, std::string id, path dir) {
   self->state.init(std::move(id), std::move(dir));
+  // Periodically erase old events if the user configured a retention period.
+  namespace sd = defaults::system;
+  auto& cfg = self->system().config();
+  auto retention_period = get_or(cfg, "system.retention-period",
+                                 duration{sd::retention_period});
+  auto retention_interval = get_or(cfg, "system.retention-interval",
+                                   duration{sd::retention_interval});
+  if (retention_period > duration::zero())
+    self->delayed_send(self, retention_interval, erase_atom::value);
   return {
     [=](const command::invocation& invocation) {
       VAST_DEBUG(self, "got command", invocation.full_name, "with options",
@@ -419,6 +480,17 @@ caf::behavior node(node_actor* self, std::string id, path dir) {
     [=](signal_atom, int signal) {
       VAST_IGNORE_UNUSED(signal);
       VAST_WARNING(self, "got signal", ::strsignal(signal));
+    },
+    [=](erase_atom) {
+      // Skip rounds until the node runs an INDEX and an ARCHIVE.
+      if (self->state.index && self->state.archive)
+        erase_older_than(self, make_timestamp() - retention_period,
+                         [=](caf::error err) {
+                           if (err)
+                             VAST_ERROR(self, "failed to apply retention:",
+                                        self->system().render(err));
+                         });
+      self->delayed_send(self, retention_interval, erase_atom::value);
     }};
 }
 
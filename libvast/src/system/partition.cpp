@@ -22,6 +22,7 @@
 #include "vast/concept/printable/vast/expression.hpp"
 #include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expression_visitors.hpp"
 #include "vast/ids.hpp"
@@ -54,6 +55,25 @@ partition::~partition() noexcept {
 
 // -- persistence --------------------------------------------------------------
 
+caf::expected<partition::snapshot>
+partition::read(const path& dir, const expression& expr) {
+  auto file_path = dir / "meta";
+  if (!exists(file_path))
+    return make_error(ec::no_such_file, file_path.str());
+  snapshot result;
+  if (auto err = load(nullptr, file_path, result.meta))
+    return err;
+  for (auto& [digest, layout] : result.meta.types) {
+    if (resolve(expr, layout).empty())
+      continue;
+    auto x = table_indexer::read(dir / digest);
+    if (!x)
+      return x.error();
+    result.tables.emplace(digest, std::move(*x));
+  }
+  return result;
+}
+
 caf::error partition::init() {
   VAST_TRACE("");
   auto file_path = meta_file();
@@ -66,6 +86,14 @@ caf::error partition::init() {
   return caf::none;
 }
 
+void partition::init(snapshot x) {
+  VAST_TRACE("");
+  meta_data_ = std::move(x.meta);
+  snapshots_ = std::move(x.tables);
+  VAST_DEBUG(state_->self, "adopted partition", id_, "with",
+             meta_data_.types.size(), "layouts");
+}
+
 caf::error partition::flush_to_disk() {
   if (meta_data_.dirty) {
     // Write all layouts to disk.
@@ -159,6 +187,13 @@ evaluation_map partition::eval(const expression& expr) {
     // Skip any layout that we cannot resolve.
     if (resolved.empty())
       continue;
+    // Skip any layout whose zone maps rule out all table slices, so that we
+    // neither load nor query its INDEXER actors.
+    if (auto ti = get_or_add(layout); ti && !ti->first.may_match(expr)) {
+      VAST_DEBUG(state_->self, "skips layout", layout.name(),
+                 "after checking its zone maps");
+      continue;
+    }
     // Add triples (offset, curried predicate, and INDEXER) to evaluation map.
     evaluation_map::mapped_type triples;
     for (auto& kvp: resolved) {
@@ -217,6 +252,14 @@ partition::get_or_add(const record_type& key) {
     return std::pair<table_indexer&, bool>{i->second, false};
   auto digest = to_digest(key);
   add_layout(digest, key);
+  if (auto j = snapshots_.find(digest); j != snapshots_.end()) {
+    auto x = std::move(j->second);
+    snapshots_.erase(j);
+    auto result = table_indexers_.emplace(
+      key, table_indexer::make(this, key, std::move(x)));
+    VAST_ASSERT(result.second == true);
+    return std::pair<table_indexer&, bool>{result.first->second, true};
+  }
   auto ti = table_indexer::make(this, key);
   if (!ti)
     return ti.error();
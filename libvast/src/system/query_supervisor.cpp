@@ -16,12 +16,15 @@
 #include "vast/expression.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/atoms.hpp"
+#include "vast/time.hpp"
 
+#include <caf/duration.hpp>
 #include <caf/event_based_actor.hpp>
 #include <caf/local_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
 #include <algorithm>
+#include <chrono>
 
 namespace vast::system {
 
@@ -47,34 +50,59 @@ query_supervisor(caf::stateful_actor<query_supervisor_state>* self,
                  caf::actor master) {
   // Ask master for initial work.
   self->send(master, worker_atom::value, self);
+  auto run = [=](const query_map& qm, const caf::actor& client,
+                 time deadline) {
+    VAST_DEBUG(self, "got a new query for", qm.size(), "partitions:",
+               get_ids(qm));
+    VAST_ASSERT(!qm.empty());
+    VAST_ASSERT(self->state.open_requests.empty());
+    // Bound the EVALUATOR requests by the deadline of the query.
+    caf::duration timeout = caf::infinite;
+    if (deadline != time::max()) {
+      time now = std::chrono::system_clock::now();
+      timeout = caf::duration{std::max(deadline - now, duration::zero())};
+    }
+    auto complete = [=](const uuid& id) {
+      auto& num_evaluators = self->state.open_requests[id];
+      if (--num_evaluators == 0) {
+        VAST_DEBUG(self, "collected all results for partition", id);
+        self->state.open_requests.erase(id);
+        // Ask master for more work after receiving the last sub
+        // result.
+        if (self->state.open_requests.empty()) {
+          VAST_DEBUG(self, "collected all results for all partitions");
+          self->send(client, done_atom::value);
+          self->send(master, worker_atom::value, self);
+        }
+      }
+    };
+    for (auto& kvp : qm) {
+      auto& id = kvp.first;
+      auto& evaluators = kvp.second;
+      VAST_DEBUG(self, "asks", evaluators.size(),
+                 "EVALUATOR actor(s) for partition", id);
+      self->state.open_requests.emplace(id, evaluators.size());
+      for (auto& evaluator : evaluators)
+        self->request(evaluator, timeout, client)
+          .then([=](done_atom) { complete(id); },
+                [=](const caf::error& err) {
+                  // The EVALUATOR either ran out of time or went down along
+                  // with its client. In both cases, we cancel its work and
+                  // count the partition as done to free this worker.
+                  VAST_DEBUG(self, "cancels EVALUATOR for partition", id,
+                             "after an error:", self->system().render(err));
+                  self->send_exit(evaluator, caf::exit_reason::user_shutdown);
+                  complete(id);
+                });
+    }
+  };
   return {
     [=](const expression&, const query_map& qm, const caf::actor& client) {
-      VAST_DEBUG(self, "got a new query for", qm.size(), "partitions:",
-                 get_ids(qm));
-      VAST_ASSERT(!qm.empty());
-      VAST_ASSERT(self->state.open_requests.empty());
-      for (auto& kvp : qm) {
-        auto& id = kvp.first;
-        auto& evaluators = kvp.second;
-        VAST_DEBUG(self, "asks", evaluators.size(),
-                   "EVALUATOR actor(s) for partition", id);
-        self->state.open_requests.emplace(id, evaluators.size());
-        for (auto& evaluator : evaluators)
-          self->request(evaluator, caf::infinite, client).then([=](done_atom) {
-            auto& num_evaluators = self->state.open_requests[id];
-            if (--num_evaluators == 0) {
-              VAST_DEBUG(self, "collected all results for partition", id);
-              self->state.open_requests.erase(id);
-              // Ask master for more work after receiving the last sub
-              // result.
-              if (self->state.open_requests.empty()) {
-                VAST_DEBUG(self, "collected all results for all partitions");
-                self->send(client, done_atom::value);
-                self->send(master, worker_atom::value, self);
-              }
-            }
-          });
-      }
+      run(qm, client, time::max());
+    },
+    [=](const expression&, const query_map& qm, const caf::actor& client,
+        time deadline) {
+      run(qm, client, deadline);
     }};
 }
 
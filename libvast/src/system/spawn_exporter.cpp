@@ -20,12 +20,18 @@
 
 #include "vast/defaults.hpp"
 #include "vast/detail/unbox_var.hpp"
+#include "vast/error.hpp"
 #include "vast/logger.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/exporter.hpp"
+#include "vast/system/federated_exporter.hpp"
+#include "vast/si_literals.hpp"
 #include "vast/system/node.hpp"
+#include "vast/system/query_budget.hpp"
 #include "vast/system/spawn_arguments.hpp"
 
+using namespace vast::binary_byte_literals;
+
 namespace vast::system {
 
 maybe_actor spawn_exporter(node_actor* self, spawn_arguments& args) {
@@ -41,7 +47,39 @@ maybe_actor spawn_exporter(node_actor* self, spawn_arguments& args) {
   // Default to historical if no options provided.
   if (query_opts == no_query_options)
     query_opts = historical;
-  auto exp = self->spawn(exporter, std::move(expr), query_opts);
+  if (get_or(args.invocation.options, "export.latest", false)) {
+    if (has_continuous_option(query_opts))
+      return make_error(ec::invalid_configuration,
+                        "cannot order the results of a continuous query");
+    query_opts = query_opts + ordered;
+  }
+  // Parse the resource limits of the query.
+  auto& opts = args.invocation.options;
+  query_budget budget;
+  budget.max_buffered_bytes
+    = get_or(opts, "export.max-buffer", defaults::export_::max_buffer) * 1_MiB;
+  budget.max_partitions = get_or(opts, "export.max-partitions",
+                                 defaults::export_::max_partitions);
+  budget.timeout = get_or(opts, "export.timeout", duration::zero());
+  // Parse the fields to include in the results.
+  std::vector<std::string> projection;
+  if (auto fields = caf::get_if<std::vector<std::string>>(&opts,
+                                                          "export.fields"))
+    projection = *fields;
+  caf::actor exp;
+  if (get_or(opts, "export.federated", false)) {
+    if (has_continuous_option(query_opts))
+      return make_error(ec::invalid_configuration,
+                        "cannot federate a continuous query");
+    if (has_ordered_option(query_opts))
+      return make_error(ec::invalid_configuration,
+                        "cannot order the results of a federated query");
+    exp = self->spawn(federated_exporter, self->state.tracker, std::move(expr),
+                      query_opts, budget, std::move(projection));
+  } else {
+    exp = self->spawn(exporter, std::move(expr), query_opts, budget,
+                      std::move(projection));
+  }
   // Setting max-events to 0 means infinite.
   auto max_events = get_or(args.invocation.options, "export.max-events",
                            defaults::export_::max_events);
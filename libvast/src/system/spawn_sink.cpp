@@ -47,7 +47,9 @@ maybe_actor spawn_generic_sink(caf::local_actor* self, spawn_arguments& args) {
   std::string category = Defaults::category;
   VAST_UNBOX_VAR(out,
                  detail::make_output_stream<Defaults>(args.invocation.options));
-  return self->spawn(sink<Writer>, Writer{std::move(out)}, 0u);
+  Writer writer{std::move(out)};
+  format::parallelize(writer, args.invocation.options, category);
+  return self->spawn(sink<Writer>, std::move(writer), 0u);
 }
 
 } // namespace <anonymous>
@@ -77,6 +79,7 @@ maybe_actor spawn_zeek_sink(caf::local_actor* self, spawn_arguments& args) {
     return unexpected_arguments(args);
   format::zeek::writer writer{
     get_or(args.invocation.options, category + ".write", defaults_t::write)};
+  format::parallelize(writer, args.invocation.options, category);
   return self->spawn(sink<format::zeek::writer>, std::move(writer), 0u);
 }
 
@@ -13,6 +13,8 @@
 
 #include "vast/system/table_indexer.hpp"
 
+#include <algorithm>
+
 #include "vast/detail/overload.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/expression_visitors.hpp"
@@ -27,6 +29,14 @@
 
 namespace vast::system {
 
+namespace {
+
+constexpr const char* row_ids_filename = "row_ids";
+
+constexpr const char* zone_maps_filename = "zone_maps";
+
+} // namespace <anonymous>
+
 // -- constructors, destructors, and assignment operators ----------------------
 
 table_indexer::table_indexer(partition* parent, const record_type& layout)
@@ -62,18 +72,43 @@ caf::expected<table_indexer> table_indexer::make(partition* parent,
   return ret;
 }
 
+table_indexer table_indexer::make(partition* parent, const record_type& layout,
+                                  snapshot x) {
+  VAST_ASSERT(parent != nullptr);
+  auto ret = table_indexer{parent, layout};
+  ret.init(std::move(x));
+  return ret;
+}
+
 // -- persistence --------------------------------------------------------------
 
+caf::expected<table_indexer::snapshot>
+table_indexer::read(const path& dir) {
+  snapshot result;
+  if (auto filename = dir / row_ids_filename; exists(filename))
+    if (auto err = load(nullptr, filename, result.row_ids))
+      return err;
+  if (auto filename = dir / zone_maps_filename; exists(filename))
+    if (auto err = load(nullptr, filename, result.zone_maps))
+      return err;
+  return result;
+}
+
 caf::error table_indexer::init() {
   VAST_TRACE("");
-  auto filename = row_ids_file();
-  if (exists(filename))
-    if (auto err = load(nullptr, filename, row_ids_))
-      return err;
-  set_clean();
+  auto x = read(base_dir());
+  if (!x)
+    return x.error();
+  init(std::move(*x));
   return caf::none;
 }
 
+void table_indexer::init(snapshot x) {
+  row_ids_ = std::move(x.row_ids);
+  zone_maps_ = std::move(x.zone_maps);
+  set_clean();
+}
+
 caf::error table_indexer::flush_to_disk() {
   // Unless `add` was called at least once there's nothing to flush.
   VAST_TRACE("");
@@ -81,6 +116,8 @@ caf::error table_indexer::flush_to_disk() {
     return caf::none;
   if (auto err = save(nullptr, row_ids_file(), row_ids_))
     return err;
+  if (auto err = save(nullptr, zone_maps_file(), zone_maps_))
+    return err;
   set_clean();
   return caf::none;
 }
@@ -108,7 +145,19 @@ caf::actor& table_indexer::indexer_at(size_t column) {
 }
 
 path table_indexer::row_ids_file() const {
-  return base_dir() / "row_ids";
+  return base_dir() / row_ids_filename;
+}
+
+path table_indexer::zone_maps_file() const {
+  return base_dir() / zone_maps_filename;
+}
+
+bool table_indexer::may_match(const expression& expr) const {
+  // Tables of partitions that predate zone maps cannot rule out anything.
+  if (zone_maps_.empty())
+    return true;
+  return std::any_of(zone_maps_.begin(), zone_maps_.end(),
+                     [&](auto& zones) { return zones.lookup(expr, layout()); });
 }
 
 void table_indexer::spawn_indexers() {
@@ -155,6 +204,7 @@ void table_indexer::add(const table_slice_ptr& x) {
   VAST_ASSERT(first >= row_ids_.size());
   row_ids_.append_bits(false, first - row_ids_.size());
   row_ids_.append_bits(true, last - first);
+  zone_maps_.push_back(zone_map::make(*x));
 }
 
 } // namespace vast::system
@@ -13,6 +13,7 @@
 
 #include "vast/table_slice.hpp"
 
+#include <algorithm>
 #include <unordered_map>
 
 #include <caf/actor_system.hpp>
@@ -95,6 +96,27 @@ record_type table_slice::layout(size_type first_column,
   return record_type{std::move(sub_records)};
 }
 
+table_slice_ptr table_slice::copy_rows(size_type first_row,
+                                       size_type num_rows) const {
+  VAST_ASSERT(num_rows > 0);
+  VAST_ASSERT(first_row + num_rows <= rows());
+  auto impl = implementation_id();
+  auto builder = factory<table_slice_builder>::make(impl, layout());
+  if (builder == nullptr) {
+    VAST_ERROR(__func__, "failed to get a table slice builder for", impl);
+    return nullptr;
+  }
+  builder->reserve(num_rows);
+  if (!builder->add_rows(*this, first_row, num_rows)) {
+    VAST_ERROR(__func__, "failed to copy rows to the builder");
+    return nullptr;
+  }
+  auto result = builder->finish();
+  if (result != nullptr)
+    result.unshared().offset(offset() + first_row);
+  return result;
+}
+
 table_slice::row_view table_slice::row(size_t index) const {
   VAST_ASSERT(index < rows());
   return {*this, index};
@@ -165,46 +187,29 @@ void select(std::vector<table_slice_ptr>& result, const table_slice_ptr& xs,
     result.emplace_back(xs);
     return;
   }
-  // Start slicing and dicing.
-  auto impl = xs->implementation_id();
-  auto builder = factory<table_slice_builder>::make(impl, xs->layout());
-  if (builder == nullptr) {
-    VAST_ERROR(__func__, "failed to get a table slice builder for", impl);
-    return;
-  }
-  id last_offset = xs->offset();
+  // Start slicing and dicing. Every run of consecutive IDs becomes one slice
+  // that we copy in bulk.
+  id first_id = 0;
+  id num_ids = 0;
   auto push_slice = [&] {
-    if (builder->rows() == 0)
+    if (num_ids == 0)
       return;
-    auto slice = builder->finish();
+    VAST_ASSERT(first_id >= xs->offset());
+    auto slice = xs->copy_rows(first_id - xs->offset(), num_ids);
     if (slice == nullptr) {
       VAST_WARNING(__func__, "got an empty slice");
       return;
     }
-    slice.unshared().offset(last_offset);
     result.emplace_back(std::move(slice));
   };
-  auto last_id = last_offset - 1;
   for (auto id : select(intersection)) {
     // Finish last slice when hitting non-consecutive IDs.
-    if (last_id + 1 != id) {
+    if (first_id + num_ids != id) {
       push_slice();
-      last_offset = id;
-      last_id = id;
-    } else {
-      ++last_id;
-    }
-    VAST_ASSERT(id >= xs->offset());
-    auto row = id - xs->offset();
-    VAST_ASSERT(row < xs->rows());
-    for (size_t column = 0; column < xs->columns(); ++column) {
-      auto cell_value = xs->at(row, column);
-      if (!builder->add(cell_value)) {
-        VAST_ERROR(__func__, "failed to add data at column", column, "in row",
-                   row, "to the builder:", cell_value);
-        return;
-      }
+      first_id = id;
+      num_ids = 0;
     }
+    ++num_ids;
   }
   push_slice();
 }
@@ -258,6 +263,82 @@ std::pair<table_slice_ptr, table_slice_ptr> split(const table_slice_ptr& slice,
   return {std::move(xs.front()), std::move(xs.back())};
 }
 
+namespace {
+
+// Selects the given columns of `slice`, as returned by `project_columns`.
+table_slice_ptr select_columns(const table_slice_ptr& slice,
+                               const std::vector<size_t>& columns) {
+  VAST_ASSERT(slice != nullptr);
+  auto& layout = slice->layout();
+  if (columns.empty())
+    return nullptr;
+  if (columns.size() == slice->columns())
+    return slice;
+  std::vector<record_field> projected_fields;
+  projected_fields.reserve(columns.size());
+  for (auto column : columns)
+    projected_fields.emplace_back(layout.fields[column]);
+  auto projected_layout = record_type{std::move(projected_fields)}
+                            .name(layout.name())
+                            .attributes(layout.attributes());
+  auto impl = slice->implementation_id();
+  auto builder = factory<table_slice_builder>::make(impl, projected_layout);
+  if (builder == nullptr) {
+    VAST_ERROR(__func__, "failed to get a table slice builder for", impl);
+    return nullptr;
+  }
+  builder->reserve(slice->rows());
+  for (size_t row = 0; row < slice->rows(); ++row)
+    for (auto column : columns)
+      if (!builder->add(slice->at(row, column))) {
+        VAST_ERROR(__func__, "failed to add value to the builder");
+        return nullptr;
+      }
+  auto result = builder->finish();
+  if (result != nullptr)
+    result.unshared().offset(slice->offset());
+  return result;
+}
+
+} // namespace <anonymous>
+
+table_slice_ptr project(const table_slice_ptr& slice,
+                        const std::vector<std::string>& fields) {
+  VAST_ASSERT(slice != nullptr);
+  return select_columns(slice, project_columns(slice->layout(), fields));
+}
+
+std::vector<size_t> project_columns(const record_type& layout,
+                                    const std::vector<std::string>& fields) {
+  // Table slice layouts are flat, i.e., every offset refers to a column.
+  std::vector<size_t> result;
+  for (auto& field : fields)
+    for (auto& offset : layout.find_suffix(field))
+      if (offset.size() == 1)
+        result.push_back(offset[0]);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+projection_cache::projection_cache(std::vector<std::string> fields)
+  : fields_{std::move(fields)} {
+  // nop
+}
+
+const std::vector<size_t>&
+projection_cache::columns(const record_type& layout) {
+  auto i = columns_.find(layout);
+  if (i == columns_.end())
+    i = columns_.emplace(layout, project_columns(layout, fields_)).first;
+  return i->second;
+}
+
+table_slice_ptr projection_cache::operator()(const table_slice_ptr& slice) {
+  VAST_ASSERT(slice != nullptr);
+  return select_columns(slice, columns(slice->layout()));
+}
+
 bool operator==(const table_slice& x, const table_slice& y) {
   if (&x == &y)
     return true;
@@ -16,7 +16,9 @@
 #include <algorithm>
 
 #include "vast/data.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/table_slice.hpp"
 
 namespace vast {
 
@@ -43,6 +45,33 @@ bool table_slice_builder::recursive_add(const data& x, const type& t) {
                     x, t);
 }
 
+bool table_slice_builder::add_rows(const table_slice& xs, size_t first_row,
+                                   size_t num_rows) {
+  VAST_ASSERT(first_row + num_rows <= xs.rows());
+  if (xs.layout() != layout_)
+    return false;
+  track_first_value();
+  return add_rows_impl(xs, first_row, num_rows);
+}
+
+table_slice_ptr table_slice_builder::finish() {
+  has_values_ = false;
+  return finish_impl();
+}
+
+bool table_slice_builder::add_rows_impl(const table_slice& xs,
+                                        size_t first_row, size_t num_rows) {
+  for (auto row = first_row; row < first_row + num_rows; ++row)
+    for (size_t column = 0; column < xs.columns(); ++column)
+      if (!add(xs.at(row, column)))
+        return false;
+  return true;
+}
+
+bool table_slice_builder::add_owned_impl(data&& x) {
+  return add_impl(make_view(x));
+}
+
 void table_slice_builder::reserve(size_t) {
   // nop
 }
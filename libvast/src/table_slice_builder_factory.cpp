@@ -15,12 +15,15 @@
 
 #include "vast/default_table_slice.hpp"
 #include "vast/default_table_slice_builder.hpp"
+#include "vast/dictionary_table_slice.hpp"
+#include "vast/dictionary_table_slice_builder.hpp"
 
 namespace vast {
 
 void factory_traits<table_slice_builder>::initialize() {
   using f = factory<table_slice_builder>;
   f::add<default_table_slice_builder>(default_table_slice::class_id);
+  f::add<dictionary_table_slice_builder>(dictionary_table_slice::class_id);
 }
 
 } // namespace vast
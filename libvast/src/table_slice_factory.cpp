@@ -17,12 +17,14 @@
 
 #include "vast/chunk.hpp"
 #include "vast/default_table_slice.hpp"
+#include "vast/dictionary_table_slice.hpp"
 #include "vast/logger.hpp"
 
 namespace vast {
 
 void factory_traits<table_slice>::initialize() {
   factory<table_slice>::add<default_table_slice>();
+  factory<table_slice>::add<dictionary_table_slice>();
 }
 
 table_slice_ptr factory_traits<table_slice>::make(chunk_ptr chunk) {
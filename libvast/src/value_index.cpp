@@ -19,6 +19,7 @@
 #include <caf/settings.hpp>
 
 #include <cmath>
+#include <string_view>
 
 namespace vast {
 
@@ -149,6 +150,68 @@ caf::error inspect(caf::deserializer& source, value_index_ptr& x) {
   return x->deserialize(source);
 }
 
+namespace detail {
+
+ids combine_hits(ids::size_type offset, relational_operator op,
+                 const std::vector<ids>& hits) {
+  VAST_ASSERT(op == in || op == not_in);
+  ids result{offset, false};
+  if (!hits.empty())
+    result |= nary_or(hits.begin(), hits.end());
+  if (op == not_in)
+    result.flip();
+  return result;
+}
+
+namespace {
+
+/// Walks a sorted range of unique keys like a trie, such that keys sharing a
+/// prefix also share the bitmap operations for that prefix.
+/// @param first The beginning of the key range.
+/// @param last The end of the key range.
+/// @param depth The length of the prefix that all keys in the range share.
+/// @param prefix The IDs matching the shared prefix.
+/// @param lookup Retrieves the IDs for a byte at a given position.
+/// @param leaf Receives each key with the IDs matching all of its bytes.
+template <class Iterator, class Lookup, class Leaf>
+void prefix_lookup(Iterator first, Iterator last, size_t depth,
+                   const ids& prefix, Lookup& lookup, Leaf& leaf) {
+  // Because the range is sorted, a key that ends here comes first.
+  if (first != last && first->size() == depth)
+    leaf(*first++, prefix);
+  while (first != last) {
+    auto byte = (*first)[depth];
+    auto next = std::find_if(first, last,
+                             [&](auto& key) { return key[depth] != byte; });
+    auto result = prefix & lookup(depth, static_cast<uint8_t>(byte));
+    if (!all<0>(result))
+      prefix_lookup(first, next, depth + 1, result, lookup, leaf);
+    first = next;
+  }
+}
+
+/// Applies a set lookup if all elements of a container have type `T`, and
+/// falls back to individual lookups per element otherwise.
+template <class T, class Index, class Container, class F>
+caf::expected<ids> dispatch_set_lookup(const Index& idx, relational_operator op,
+                                       Container xs, F f) {
+  if (!(op == in || op == not_in))
+    return make_error(ec::unsupported_operator, op);
+  std::vector<view<T>> elements;
+  elements.reserve(xs->size());
+  for (auto x : *xs) {
+    auto element = caf::get_if<view<T>>(&x);
+    if (!element)
+      return container_lookup(idx, op, xs);
+    elements.push_back(*element);
+  }
+  return f(std::move(elements));
+}
+
+} // namespace
+
+} // namespace detail
+
 // -- string_index -------------------------------------------------------------
 
 string_index::string_index(vast::type t, caf::settings opts)
@@ -189,6 +252,10 @@ bool string_index::append_impl(data_view x, id pos) {
 
 caf::expected<ids>
 string_index::lookup_impl(relational_operator op, data_view x) const {
+  auto lookup_container = [&](auto xs) {
+    auto f = [&](auto strs) { return lookup_set(op, std::move(strs)); };
+    return detail::dispatch_set_lookup<std::string>(*this, op, xs, f);
+  };
   return caf::visit(
     detail::overload(
       [&](auto x) -> caf::expected<ids> {
@@ -252,11 +319,37 @@ string_index::lookup_impl(relational_operator op, data_view x) const {
           }
         }
       },
-      [&](view<vector> xs) { return detail::container_lookup(*this, op, xs); },
-      [&](view<set> xs) { return detail::container_lookup(*this, op, xs); }),
+      [&](view<vector> xs) { return lookup_container(xs); },
+      [&](view<set> xs) { return lookup_container(xs); }),
     x);
 }
 
+caf::expected<ids>
+string_index::lookup_set(relational_operator op,
+                         std::vector<std::string_view> xs) const {
+  // Strings are indexed only up to the maximum length.
+  for (auto& x : xs)
+    if (x.size() > max_length_)
+      x = x.substr(0, max_length_);
+  std::sort(xs.begin(), xs.end());
+  xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+  // Strings longer than all indexed strings cannot match.
+  auto last = std::remove_if(xs.begin(), xs.end(), [&](auto x) {
+    return x.size() > chars_.size();
+  });
+  std::vector<ids> hits;
+  auto lookup = [&](size_t i, uint8_t c) { return chars_[i].lookup(equal, c); };
+  auto leaf = [&](std::string_view x, const ids& prefix) {
+    if (x.empty())
+      hits.push_back(length_.lookup(equal, 0));
+    else
+      hits.push_back(prefix & length_.lookup(less_equal, x.size()));
+  };
+  detail::prefix_lookup(xs.begin(), last, 0, ids{offset(), true}, lookup,
+                        leaf);
+  return detail::combine_hits(offset(), op, hits);
+}
+
 // -- enumeration_index --------------------------------------------------------
 
 enumeration_index::enumeration_index(vast::type t, caf::settings opts)
@@ -334,6 +427,10 @@ bool address_index::append_impl(data_view x, id pos) {
 
 caf::expected<ids>
 address_index::lookup_impl(relational_operator op, data_view d) const {
+  auto lookup_container = [&](auto xs) {
+    auto f = [&](const auto& addrs) { return lookup_set(op, addrs); };
+    return detail::dispatch_set_lookup<address>(*this, op, xs, f);
+  };
   return caf::visit(
     detail::overload(
       [&](auto x) -> caf::expected<ids> {
@@ -379,11 +476,39 @@ address_index::lookup_impl(relational_operator op, data_view d) const {
           result.flip();
         return result;
       },
-      [&](view<vector> xs) { return detail::container_lookup(*this, op, xs); },
-      [&](view<set> xs) { return detail::container_lookup(*this, op, xs); }),
+      [&](view<vector> xs) { return lookup_container(xs); },
+      [&](view<set> xs) { return lookup_container(xs); }),
     d);
 }
 
+caf::expected<ids>
+address_index::lookup_set(relational_operator op,
+                          const std::vector<address>& xs) const {
+  std::vector<ids> hits;
+  auto leaf = [&](std::string_view, const ids& x) { hits.push_back(x); };
+  // IPv4 addresses share the v4-mapped prefix, so we walk them separately
+  // over their last four bytes only.
+  auto walk = [&](size_t first_byte, ids prefix, bool v4) {
+    std::vector<std::string_view> keys;
+    for (auto& x : xs)
+      if (x.is_v4() == v4)
+        keys.emplace_back(reinterpret_cast<const char*>(x.data().data())
+                            + first_byte,
+                          16 - first_byte);
+    if (keys.empty())
+      return;
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    auto lookup = [&](size_t i, uint8_t byte) {
+      return bytes_[first_byte + i].lookup(equal, byte);
+    };
+    detail::prefix_lookup(keys.begin(), keys.end(), 0, prefix, lookup, leaf);
+  };
+  walk(12, v4_.coder().storage(), true);
+  walk(0, ids{offset(), true}, false);
+  return detail::combine_hits(offset(), op, hits);
+}
+
 // -- subnet_index -------------------------------------------------------------
 
 subnet_index::subnet_index(vast::type x, caf::settings opts)
@@ -393,20 +518,54 @@ subnet_index::subnet_index(vast::type x, caf::settings opts)
   // nop
 }
 
+namespace {
+
+// Computes the radix tree key for the first `length` bits of an address. The
+// key consists of one character per bit, preceded by the address family. This
+// way, a subnet contains an address exactly if its key is a prefix of the
+// address key.
+std::string prefix_key(const address& addr, size_t length) {
+  std::string result;
+  result.reserve(length + 1);
+  result += addr.is_v4() ? '4' : '6';
+  auto first = addr.is_v4() ? 96u : 0u;
+  auto& bytes = addr.data();
+  for (auto i = first; i < first + length; ++i)
+    result += (bytes[i / 8] >> (7 - i % 8)) & 1 ? '1' : '0';
+  return result;
+}
+
+} // namespace
+
 caf::error subnet_index::serialize(caf::serializer& sink) const {
+  std::vector<std::pair<std::string, ids>> prefixes;
+  prefixes.reserve(prefixes_.size());
+  for (auto& [key, rows] : prefixes_)
+    prefixes.emplace_back(key, rows);
   return caf::error::eval([&] { return value_index::serialize(sink); },
-                          [&] { return sink(network_, length_); });
+                          [&] { return sink(network_, length_, prefixes); });
 }
 
 caf::error subnet_index::deserialize(caf::deserializer& source) {
-  return caf::error::eval([&] { return value_index::deserialize(source); },
-                          [&] { return source(network_, length_); });
+  std::vector<std::pair<std::string, ids>> prefixes;
+  auto err = caf::error::eval(
+    [&] { return value_index::deserialize(source); },
+    [&] { return source(network_, length_, prefixes); });
+  if (err)
+    return err;
+  prefixes_.clear();
+  for (auto& [key, rows] : prefixes)
+    prefixes_.insert({std::move(key), std::move(rows)});
+  return caf::none;
 }
 
 bool subnet_index::append_impl(data_view x, id pos) {
   if (auto sn = caf::get_if<view<subnet>>(&x)) {
     length_.skip(pos - length_.size());
     length_.append(sn->length());
+    auto& rows = prefixes_[prefix_key(sn->network(), sn->length())];
+    rows.append_bits(false, pos - rows.size());
+    rows.append_bit(true);
     return static_cast<bool>(network_.append(sn->network(), pos));
   }
   return false;
@@ -423,17 +582,9 @@ subnet_index::lookup_impl(relational_operator op, data_view d) const {
         if (!(op == ni || op == not_ni))
           return make_error(ec::unsupported_operator, op);
         auto result = ids{offset(), false};
-        uint8_t bits = x.is_v4() ? 32 : 128;
-        for (uint8_t i = 0; i <= bits; ++i) { // not an off-by-one
-          auto masked = x;
-          masked.mask(128 - bits + i);
-          ids len = length_.lookup(equal, i);
-          auto net = network_.lookup(equal, masked);
-          if (!net)
-            return net;
-          len &= *net;
-          result |= len;
-        }
+        auto key = prefix_key(x, x.is_v4() ? 32 : 128);
+        for (auto& i : prefixes_.prefix_of(key))
+          result |= i->second;
         if (op == not_ni)
           result.flip();
         return result;
@@ -471,14 +622,10 @@ subnet_index::lookup_impl(relational_operator op, data_view d) const {
             // For a subnet index U and subnet x, the ni operator signifies a
             // subset relationship such that `U ni x` translates to U ⊇ x, i.e.,
             // the lookup returns all subnets in U that include x.
-            ids result;
-            for (auto i = uint8_t{1}; i <= x.length(); ++i) {
-              auto xs = network_.lookup(in, subnet{x.network(), i});
-              if (!xs)
-                return xs;
-              *xs &= length_.lookup(equal, i);
-              result |= *xs;
-            }
+            auto result = ids{offset(), false};
+            auto key = prefix_key(x.network(), x.length());
+            for (auto& i : prefixes_.prefix_of(key))
+              result |= i->second;
             if (op == not_ni)
               result.flip();
             return result;
@@ -622,4 +769,66 @@ sequence_index::lookup_impl(relational_operator op, data_view x) const {
   return result;
 }
 
+// -- membership_index ---------------------------------------------------------
+
+membership_index::membership_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  // nop
+}
+
+caf::error membership_index::serialize(caf::serializer& sink) const {
+  std::vector<std::pair<data, ids>> postings(postings_.begin(),
+                                             postings_.end());
+  return caf::error::eval([&] { return value_index::serialize(sink); },
+                          [&] { return sink(postings); });
+}
+
+caf::error membership_index::deserialize(caf::deserializer& source) {
+  std::vector<std::pair<data, ids>> postings;
+  auto err = caf::error::eval(
+    [&] { return value_index::deserialize(source); },
+    [&] { return source(postings); });
+  if (err)
+    return err;
+  postings_.clear();
+  postings_.reserve(postings.size());
+  for (auto& [x, bm] : postings)
+    postings_.emplace(std::move(x), std::move(bm));
+  return caf::none;
+}
+
+bool membership_index::append_impl(data_view x, id pos) {
+  auto f = [&](const auto& v) {
+    using view_type = std::decay_t<decltype(v)>;
+    if constexpr (detail::is_any_v<view_type, view<vector>, view<set>>) {
+      for (auto element : *v) {
+        auto i = postings_.find(element);
+        if (i == postings_.end())
+          i = postings_.emplace(materialize(element), ids{}).first;
+        auto& bm = i.value();
+        // Vectors may contain the same element multiple times.
+        if (bm.size() > pos)
+          continue;
+        bm.append_bits(false, pos - bm.size());
+        bm.append_bit(true);
+      }
+      return true;
+    }
+    return false;
+  };
+  return caf::visit(f, x);
+}
+
+caf::expected<ids>
+membership_index::lookup_impl(relational_operator op, data_view x) const {
+  if (!(op == ni || op == not_ni))
+    return make_error(ec::unsupported_operator, op);
+  auto i = postings_.find(x);
+  auto result = i != postings_.end() ? i->second : ids{};
+  result.append_bits(false, offset() - result.size());
+  if (op == not_ni)
+    result.flip();
+  return result;
+}
+
 } // namespace vast
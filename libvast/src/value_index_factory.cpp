@@ -56,7 +56,15 @@ value_index_ptr make(type x, caf::settings opts) {
     }
   }
   if (auto a = find_attribute(x, "index")) {
-    if (auto value = a->value)
+    if (auto value = a->value) {
+      if (*value == "membership"sv) {
+        if constexpr (std::is_same_v<T, sequence_index>)
+          return std::make_unique<membership_index>(std::move(x),
+                                                    std::move(opts));
+        else
+          VAST_WARNING_ANON(__func__, "ignoring membership index for",
+                            "non-container type");
+      }
       if (*value == "hash"sv) {
         auto i = opts.find("cardinality");
         if (i == opts.end())
@@ -112,6 +120,7 @@ value_index_ptr make(type x, caf::settings opts) {
             return std::make_unique<hash_index<8>>(std::move(x));
         }
       }
+    }
   }
   return std::make_unique<T>(std::move(x), std::move(opts));
 }
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/zone_map.hpp"
+
+#include <algorithm>
+
+#include <caf/optional.hpp>
+
+#include "vast/detail/overload.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/expression.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
+
+namespace vast {
+
+namespace {
+
+template <class T>
+zone_map::range make_range(const table_slice& slice, size_t col) {
+  caf::optional<T> min;
+  caf::optional<T> max;
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    auto x = slice.at(row, col);
+    auto y = caf::get_if<view<T>>(&x);
+    if (y == nullptr)
+      continue;
+    if (!min || *y < *min)
+      min = *y;
+    if (!max || *max < *y)
+      max = *y;
+  }
+  if (!min)
+    return {};
+  return {data{*min}, data{*max}};
+}
+
+// Tests whether a column with values in `r` may contain a value `x` such that
+// `x op rhs` holds.
+bool may_match(const zone_map::range& r, relational_operator op,
+               const data& rhs) {
+  // Without a range or when comparing values of different types, we cannot
+  // rule out anything.
+  auto& lo = r.min;
+  auto& hi = r.max;
+  if (caf::holds_alternative<caf::none_t>(lo))
+    return true;
+  auto comparable = [&](const data& x) {
+    return lo.get_data().index() == x.get_data().index();
+  };
+  auto contains = [&](const data& x) {
+    return !comparable(x) || (!(x < lo) && !(hi < x));
+  };
+  switch (op) {
+    default:
+      return true;
+    case equal:
+      return contains(rhs);
+    case less:
+      return !comparable(rhs) || lo < rhs;
+    case less_equal:
+      return !comparable(rhs) || !(rhs < lo);
+    case greater:
+      return !comparable(rhs) || rhs < hi;
+    case greater_equal:
+      return !comparable(rhs) || !(hi < rhs);
+    case in: {
+      if (auto sn = caf::get_if<subnet>(&rhs)) {
+        auto x = caf::get_if<address>(&lo);
+        auto y = caf::get_if<address>(&hi);
+        if (x == nullptr || y == nullptr)
+          return true;
+        // A subnet is a contiguous range of addresses, so it overlaps with
+        // [x, y] if it contains either bound or lies between them.
+        auto& network = sn->network();
+        return sn->contains(*x) || sn->contains(*y)
+               || (*x < network && network < *y);
+      }
+      if (auto xs = caf::get_if<vector>(&rhs))
+        return std::any_of(xs->begin(), xs->end(), contains);
+      if (auto xs = caf::get_if<set>(&rhs))
+        return std::any_of(xs->begin(), xs->end(), contains);
+      return true;
+    }
+  }
+}
+
+} // namespace
+
+zone_map zone_map::make(const table_slice& slice) {
+  zone_map result;
+  auto& fields = slice.layout().fields;
+  result.ranges_.reserve(fields.size());
+  for (size_t col = 0; col < fields.size(); ++col) {
+    auto f = detail::overload(
+      [&](const count_type&) { return make_range<count>(slice, col); },
+      [&](const integer_type&) { return make_range<integer>(slice, col); },
+      [&](const time_type&) { return make_range<time>(slice, col); },
+      [&](const duration_type&) { return make_range<duration>(slice, col); },
+      [&](const address_type&) { return make_range<address>(slice, col); },
+      [](const auto&) { return range{}; });
+    result.ranges_.push_back(caf::visit(f, fields[col].type));
+  }
+  return result;
+}
+
+bool zone_map::lookup(const expression& expr,
+                      const record_type& layout) const {
+  if (ranges_.size() != layout.fields.size())
+    return true;
+  auto f = detail::overload(
+    [&](const conjunction& xs) {
+      return std::all_of(xs.begin(), xs.end(),
+                         [&](auto& x) { return lookup(x, layout); });
+    },
+    [&](const disjunction& xs) {
+      return std::any_of(xs.begin(), xs.end(),
+                         [&](auto& x) { return lookup(x, layout); });
+    },
+    [](const negation&) {
+      // The ranges only bound the values of a column, so we cannot tell
+      // whether a row exists that does not match.
+      return true;
+    },
+    [&](const predicate& x) { return lookup(x, layout); },
+    [](caf::none_t) { return true; });
+  return caf::visit(f, expr);
+}
+
+bool zone_map::lookup(const predicate& pred, const record_type& layout) const {
+  auto rhs = caf::get_if<data>(&pred.rhs);
+  if (rhs == nullptr)
+    return true;
+  auto& fields = layout.fields;
+  // Checks all columns that a field predicate selects. Predicates that do not
+  // apply to any column of the layout are left to later stages.
+  auto search = [&](auto match) {
+    auto found = false;
+    for (size_t col = 0; col < fields.size(); ++col) {
+      if (!match(fields[col]))
+        continue;
+      if (may_match(ranges_[col], pred.op, *rhs))
+        return true;
+      found = true;
+    }
+    return !found;
+  };
+  auto f = detail::overload(
+    [&](const attribute_extractor& lhs) {
+      if (lhs.attr == system::type_atom::value)
+        return evaluate(layout.name(), pred.op, *rhs);
+      if (lhs.attr == system::timestamp_atom::value)
+        return search([](const record_field& field) {
+          return caf::holds_alternative<time_type>(field.type)
+                 && has_attribute(field.type, "timestamp");
+        });
+      return true;
+    },
+    [&](const key_extractor& lhs) {
+      return search([&](const record_field& field) {
+        return detail::ends_with(field.name, lhs.key);
+      });
+    },
+    [&](const type_extractor& lhs) {
+      return search(
+        [&](const record_field& field) { return field.type == lhs.type; });
+    },
+    [&](const data_extractor& lhs) {
+      auto t = caf::get_if<record_type>(&lhs.type);
+      if (t == nullptr || *t != layout)
+        return true;
+      auto col = layout.flat_index_at(lhs.offset);
+      if (!col || *col >= ranges_.size())
+        return true;
+      return may_match(ranges_[*col], pred.op, *rhs);
+    },
+    [](const auto&) { return true; });
+  return caf::visit(f, pred.lhs);
+}
+
+} // namespace vast
@@ -22,6 +22,8 @@
 #include "vast/save.hpp"
 #include "vast/span.hpp"
 
+#include <caf/binary_deserializer.hpp>
+
 using namespace vast;
 
 TEST(deleter) {
@@ -66,6 +68,28 @@ TEST(serialization) {
   CHECK(std::equal(x->begin(), x->end(), y->begin(), y->end()));
 }
 
+TEST(shared deserialization) {
+  std::string_view str = "foobarbaz";
+  auto x = chunk::make(as_bytes(span{str.data(), str.size()}));
+  std::vector<char> buf;
+  REQUIRE_EQUAL(save(nullptr, buf, std::string{"qux"}, x), caf::none);
+  auto input = chunk::make(std::move(buf));
+  caf::binary_deserializer source{nullptr, input->data(), input->size()};
+  std::string prefix;
+  chunk_ptr y;
+  {
+    chunk_sharing_guard guard{input, source};
+    REQUIRE_EQUAL(source(prefix, y), caf::none);
+  }
+  CHECK_EQUAL(prefix, "qux");
+  REQUIRE_NOT_EQUAL(y, nullptr);
+  MESSAGE("the deserialized chunk refers to the input");
+  CHECK(y->begin() >= input->begin() && y->end() <= input->end());
+  MESSAGE("the deserialized chunk keeps the input alive");
+  input = nullptr;
+  CHECK(std::equal(x->begin(), x->end(), y->begin(), y->end()));
+}
+
 TEST(as_bytes) {
   std::string_view str = "foobarbaz";
   auto bytes = as_bytes(span{str.data(), str.size()});
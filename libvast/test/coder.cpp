@@ -519,6 +519,40 @@ TEST(serialization multi-level coder) {
   CHECK_DECODE(not_equal, 13, "11111");
 }
 
+TEST(serialization lazy bitmap decoding) {
+  equality_coder<null_bitmap> x{10}, c, y;
+  fill(x, 8, 9, 0, 1, 4);
+  std::string buf;
+  CHECK_EQUAL(save(nullptr, buf, x), caf::none);
+  CHECK_EQUAL(load(nullptr, buf, c), caf::none);
+  // Decode a single bitmap and append to it before all others.
+  CHECK_DECODE(equal, 4, "00001");
+  c.encode(4);
+  x.encode(4);
+  CHECK_DECODE(equal, 4, "000011");
+  CHECK_DECODE(equal, 8, "100000");
+  // Serializing a partially decoded coder must retain all bitmaps.
+  buf.clear();
+  CHECK_EQUAL(save(nullptr, buf, c), caf::none);
+  CHECK_EQUAL(load(nullptr, buf, y), caf::none);
+  CHECK_EQUAL(to_string(y.decode(less_equal, 4)), "001111");
+  CHECK_EQUAL(x, y);
+  CHECK_EQUAL(x, c);
+}
+
+TEST(serialization lazy bitslice decoding) {
+  bitslice_coder<null_bitmap> x{8}, c;
+  fill(x, 0, 1, 3, 9, 10, 77, 99, 100, 128);
+  std::string buf;
+  CHECK_EQUAL(save(nullptr, buf, x), caf::none);
+  CHECK_EQUAL(load(nullptr, buf, c), caf::none);
+  // Each lookup decodes only the bitslices it touches.
+  CHECK_DECODE(in, 1, "011101100");
+  CHECK_DECODE(equal, 9, "000100000");
+  CHECK_DECODE(less, 10, "111100000");
+  CHECK_EQUAL(x, c);
+}
+
 TEST(printable) {
   equality_coder<null_bitmap> c{5};
   fill(c, 1, 2, 1, 0, 4);
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE slice_size_controller
+
+#include "vast/detail/slice_size_controller.hpp"
+
+#include "vast/test/test.hpp"
+
+using namespace vast;
+using namespace std::chrono_literals;
+
+TEST(adapts to the event rate) {
+  detail::slice_size_controller ctrl{100ms, 10, 1000};
+  CHECK_EQUAL(ctrl.slice_size(), 1000u);
+  // 10 events per second yield the minimum.
+  ctrl.observe(10, 1s);
+  CHECK_EQUAL(ctrl.slice_size(), 10u);
+  // A burst ramps up towards the maximum.
+  for (auto i = 0; i < 20; ++i)
+    ctrl.observe(100'000, 1s);
+  CHECK_EQUAL(ctrl.slice_size(), 1000u);
+  // 1'000 events per second settle at 100 events per slice.
+  for (auto i = 0; i < 100; ++i)
+    ctrl.observe(1'000, 1s);
+  CHECK_EQUAL(ctrl.slice_size(), 100u);
+}
+
+TEST(includes idle time in the event rate) {
+  detail::slice_size_controller ctrl{100ms, 10, 1000};
+  // 10'000 events after 9 idle seconds arrive at 1'000 events per second.
+  ctrl.observe(0, 9s);
+  CHECK_EQUAL(ctrl.slice_size(), 1000u);
+  ctrl.observe(10'000, 1s);
+  CHECK_EQUAL(ctrl.slice_size(), 100u);
+}
+
+TEST(latency percentiles) {
+  detail::slice_size_controller ctrl{100ms, 10, 1000};
+  CHECK_EQUAL(ctrl.summarize().samples, 0u);
+  for (auto i = 1; i <= 100; ++i)
+    ctrl.record(i * 1ms);
+  auto s = ctrl.summarize();
+  CHECK_EQUAL(s.samples, 100u);
+  CHECK_EQUAL(s.p50, 50ms);
+  CHECK_EQUAL(s.p90, 90ms);
+  CHECK_EQUAL(s.p99, 99ms);
+  CHECK_EQUAL(s.max, 100ms);
+  // Summarizing resets the samples.
+  CHECK_EQUAL(ctrl.summarize().samples, 0u);
+}
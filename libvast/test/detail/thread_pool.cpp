@@ -0,0 +1,43 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE thread_pool
+
+#include "vast/detail/thread_pool.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace vast;
+
+TEST(futures) {
+  detail::thread_pool pool{4};
+  CHECK_EQUAL(pool.size(), 4u);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i)
+    results.push_back(pool.async([i] { return i * i; }));
+  for (int i = 0; i < 100; ++i)
+    CHECK_EQUAL(results[i].get(), i * i);
+}
+
+TEST(drain on destruction) {
+  std::atomic<size_t> counter = 0;
+  {
+    detail::thread_pool pool{2};
+    for (size_t i = 0; i < 1000; ++i)
+      pool.post([&] { ++counter; });
+  }
+  CHECK_EQUAL(counter.load(), 1000u);
+}
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE dictionary_table_slice
+
+#include "vast/dictionary_table_slice.hpp"
+
+#include "vast/test/fixtures/table_slices.hpp"
+#include "vast/test/test.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/dictionary_table_slice_builder.hpp"
+#include "vast/expression.hpp"
+#include "vast/expression_visitors.hpp"
+#include "vast/ids.hpp"
+#include "vast/to_events.hpp"
+
+using namespace vast;
+using namespace std::string_literals;
+
+namespace {
+
+table_slice_ptr encode(const table_slice& xs) {
+  dictionary_table_slice_builder builder{xs.layout()};
+  if (!builder.add_rows(xs, 0, xs.rows()))
+    FAIL("builder failed to add rows");
+  auto result = builder.finish();
+  if (result == nullptr)
+    FAIL("builder failed to produce a table slice");
+  result.unshared().offset(xs.offset());
+  return result;
+}
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(dictionary_table_slice_tests, fixtures::table_slices)
+
+TEST_TABLE_SLICE(dictionary_table_slice)
+
+TEST(dictionary encoding) {
+  record_type layout{{"proto", string_type{}}, {"n", count_type{}}};
+  dictionary_table_slice_builder builder{layout};
+  REQUIRE(builder.add("tcp"s, count{1}, "udp"s, count{2}, "tcp"s, count{3},
+                      caf::none, count{4}));
+  auto slice = builder.finish();
+  REQUIRE_NOT_EQUAL(slice, nullptr);
+  REQUIRE_EQUAL(slice->rows(), 4u);
+  auto& xs = static_cast<const dictionary_table_slice&>(*slice).container();
+  REQUIRE_EQUAL(xs.size(), 2u);
+  CHECK(xs[0].encoded);
+  CHECK(!xs[1].encoded);
+  CHECK_EQUAL(xs[0].dictionary, (std::vector<std::string>{"tcp", "udp"}));
+  auto null = dictionary_table_slice::null_code;
+  CHECK_EQUAL(xs[0].codes,
+              (std::vector<dictionary_table_slice::code_type>{0, 1, 0, null}));
+  CHECK_EQUAL(materialize(slice->at(2, 0)), data{"tcp"});
+  CHECK_EQUAL(materialize(slice->at(3, 0)), data{caf::none});
+  CHECK_EQUAL(materialize(slice->at(3, 1)), data{count{4}});
+  MESSAGE("reject values of the wrong type");
+  CHECK(!builder.add(count{42}));
+}
+
+TEST(plain encoding for high cardinality) {
+  record_type layout{{"uid", string_type{}}, {"proto", string_type{}}};
+  dictionary_table_slice_builder builder{layout};
+  REQUIRE(builder.add("a"s, "tcp"s, "b"s, "tcp"s, "c"s, "udp"s, "d"s, "tcp"s));
+  auto slice = builder.finish();
+  REQUIRE_NOT_EQUAL(slice, nullptr);
+  auto& xs = static_cast<const dictionary_table_slice&>(*slice).container();
+  REQUIRE_EQUAL(xs.size(), 2u);
+  CHECK(!xs[0].encoded);
+  CHECK(xs[0].dictionary.empty());
+  CHECK(xs[1].encoded);
+  CHECK_EQUAL(materialize(slice->at(2, 0)), data{"c"});
+  CHECK_EQUAL(materialize(slice->at(2, 1)), data{"udp"});
+}
+
+TEST(copy rows) {
+  auto sut = encode(*zeek_full_conn_log_slices.front());
+  auto xs = sut->copy_rows(10, 20);
+  REQUIRE_NOT_EQUAL(xs, nullptr);
+  CHECK_EQUAL(xs->implementation_id(), dictionary_table_slice::class_id);
+  CHECK_EQUAL(xs->rows(), 20u);
+  CHECK_EQUAL(to_events(*xs), to_events(*sut, 10, 20));
+  MESSAGE("copies keep only the dictionary entries of their rows");
+  record_type layout{{"proto", string_type{}}};
+  dictionary_table_slice_builder builder{layout};
+  REQUIRE(builder.add("tcp"s, "udp"s, "tcp"s, "icmp"s, "udp"s, "tcp"s));
+  auto ys = builder.finish()->copy_rows(3, 2);
+  auto& cols = static_cast<const dictionary_table_slice&>(*ys).container();
+  CHECK_EQUAL(cols[0].dictionary,
+              (std::vector<std::string>{"icmp", "udp"}));
+  CHECK_EQUAL(materialize(ys->at(1, 0)), data{"udp"});
+}
+
+TEST(evaluation over dictionary entries) {
+  auto& plain = zeek_full_conn_log_slices.front();
+  auto sut = encode(*plain);
+  CHECK_EQUAL(*sut, *plain);
+  auto queries = {
+    "service == \"dns\""s,
+    "proto != \"tcp\" && conn_state == \"S0\""s,
+    "! (service == \"http\") || orig_pkts > 5"s,
+    "service in [\"dns\", \"http\"]"s,
+    "id.orig_h == 192.168.1.103"s,
+  };
+  for (auto& query : queries) {
+    MESSAGE("evaluate " << query);
+    auto expr = unbox(tailor(unbox(to<expression>(query)), plain->layout()));
+    auto expected = evaluate(*plain, expr);
+    CHECK_EQUAL(evaluate(*sut, expr), expected);
+  }
+}
+
+FIXTURE_SCOPE_END()
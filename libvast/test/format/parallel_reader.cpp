@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/format/parallel_reader.hpp"
+
+#define SUITE format
+
+#include "vast/test/data.hpp"
+#include "vast/test/fixtures/actor_system.hpp"
+#include "vast/test/test.hpp"
+
+#include "vast/detail/line_chunker.hpp"
+#include "vast/detail/make_io_stream.hpp"
+#include "vast/format/zeek.hpp"
+
+#include <limits>
+#include <sstream>
+
+using namespace vast;
+using namespace std::string_literals;
+
+namespace {
+
+std::string_view two_logs = R"__(#separator \x09
+#set_separator	,
+#fields	a	b
+#types	count	string
+1	foo
+2	bar
+3	baz
+#close	2019-06-07-14-31-01
+#separator \x09
+#set_separator	,
+#fields	c
+#types	count
+4
+#close	2019-06-07-14-31-01)__";
+
+struct fixture : fixtures::deterministic_actor_system {
+  using reader_type = format::zeek::reader;
+
+  std::unique_ptr<format::reader> make_reader(size_t num_workers,
+                                              size_t chunk_size,
+                                              bool ordered = true) {
+    auto in = detail::make_input_stream(artifacts::logs::zeek::conn, false);
+    REQUIRE(in);
+    auto factory = [](std::unique_ptr<std::istream> input) {
+      return std::make_unique<reader_type>(defaults::system::table_slice_type,
+                                           caf::settings{}, std::move(input));
+    };
+    return std::make_unique<format::parallel_reader>(
+      defaults::system::table_slice_type, std::move(*in),
+      reader_type::chunking_policy(), std::move(factory), num_workers,
+      chunk_size, ordered);
+  }
+
+  std::vector<table_slice_ptr>
+  read(format::reader& reader, size_t slice_size,
+       size_t max_events = std::numeric_limits<size_t>::max()) {
+    std::vector<table_slice_ptr> slices;
+    auto add_slice = [&](table_slice_ptr ptr) {
+      slices.emplace_back(std::move(ptr));
+    };
+    auto [err, num] = reader.read(max_events, slice_size, add_slice);
+    if (err && err != ec::end_of_input)
+      FAIL("reader failed: " << sys.render(err));
+    MESSAGE("read " << num << " events in " << slices.size() << " slices");
+    return slices;
+  }
+
+  std::vector<table_slice_ptr> read_sequential(size_t slice_size) {
+    auto in = detail::make_input_stream(artifacts::logs::zeek::conn, false);
+    REQUIRE(in);
+    reader_type reader{defaults::system::table_slice_type, caf::settings{},
+                       std::move(*in)};
+    return read(reader, slice_size);
+  }
+
+  static size_t rows(const std::vector<table_slice_ptr>& slices) {
+    size_t result = 0;
+    for (auto& slice : slices)
+      result += slice->rows();
+    return result;
+  }
+};
+
+} // namespace
+
+FIXTURE_SCOPE(parallel_reader_tests, fixture)
+
+TEST(line chunker - zeek headers) {
+  std::istringstream in{std::string{two_logs}};
+  detail::line_chunker chunker{in, format::zeek::reader::chunking_policy()};
+  auto header = "#separator \\x09\n#set_separator\t,\n"s;
+  CHECK_EQUAL(chunker.next(2),
+              header + "#fields\ta\tb\n#types\tcount\tstring\n1\tfoo\n2\tbar\n");
+  CHECK_EQUAL(chunker.next(2),
+              header + "#fields\ta\tb\n#types\tcount\tstring\n3\tbaz\n");
+  CHECK_EQUAL(chunker.next(2), header + "#fields\tc\n#types\tcount\n4\n");
+  CHECK_EQUAL(chunker.next(2), "");
+  CHECK(chunker.done());
+}
+
+TEST(line chunker - csv header) {
+  std::istringstream in{"a,b\n1,2\n3,4\n5,6\n"};
+  detail::line_chunker chunker{in, detail::line_chunker::policy{1, "", ""}};
+  CHECK_EQUAL(chunker.next(2), "a,b\n1,2\n3,4\n");
+  CHECK_EQUAL(chunker.next(2), "a,b\n5,6\n");
+  CHECK_EQUAL(chunker.next(2), "");
+}
+
+TEST(parallel zeek reader - ordered) {
+  auto expected = read_sequential(100);
+  auto reader = make_reader(4, 100);
+  CHECK_EQUAL(reader->name(), "zeek-reader"s);
+  auto slices = read(*reader, 100);
+  REQUIRE_EQUAL(slices.size(), expected.size());
+  for (size_t i = 0; i < slices.size(); ++i)
+    CHECK(*slices[i] == *expected[i]);
+}
+
+TEST(parallel zeek reader - unordered) {
+  auto expected = read_sequential(100);
+  auto reader = make_reader(4, 100, false);
+  auto slices = read(*reader, 100);
+  CHECK_EQUAL(rows(slices), rows(expected));
+}
+
+TEST(parallel zeek reader - event limit) {
+  auto reader = make_reader(2, 1000);
+  auto slices = read(*reader, 100, 250);
+  CHECK_EQUAL(rows(slices), 250u);
+  // The remainder of a split slice must not get lost.
+  slices = read(*reader, 100, 50);
+  CHECK_EQUAL(rows(slices), 50u);
+  auto expected = read_sequential(100);
+  auto rest = read(*reader, 100);
+  CHECK_EQUAL(rows(rest), rows(expected) - 300);
+}
+
+FIXTURE_SCOPE_END()
@@ -27,6 +27,9 @@
 #include "vast/filesystem.hpp"
 #include "vast/to_events.hpp"
 
+#include <array>
+#include <vector>
+
 using namespace vast;
 
 namespace {
@@ -58,6 +61,55 @@ std::string_view community_ids[] = {
   "1:zjGM746aZkpYb2mVIlsgLrUG59k=", "1:zjGM746aZkpYb2mVIlsgLrUG59k=",
 };
 
+// Writes a trace of UDP packets with 32 bytes of payload each, where
+// `flow_of(i)` selects the flow of the i-th packet. If `truncate_every` is
+// non-zero, every such packet gets cut off within its IPv4 header.
+template <class F>
+void write_synthetic_trace(const std::string& filename, size_t num_packets,
+                           size_t packets_per_second, F flow_of,
+                           size_t truncate_every = 0) {
+  auto pcap = ::pcap_open_dead(DLT_EN10MB, 65535);
+  REQUIRE(pcap != nullptr);
+  auto dumper = ::pcap_dump_open(pcap, filename.c_str());
+  REQUIRE(dumper != nullptr);
+  std::array<u_char, 14 + 20 + 8 + 32> packet{};
+  packet[12] = 0x08; // EtherType IPv4
+  packet[14] = 0x45; // IPv4 with a 20-byte header
+  packet[17] = 20 + 8 + 32;
+  packet[22] = 64; // TTL
+  packet[23] = 17; // UDP
+  packet[26] = 10; // 10.0.0.1 -> 10.x.y.z
+  packet[29] = 1;
+  packet[30] = 10;
+  packet[34] = 0xc0; // 49152 -> 53
+  packet[37] = 53;
+  ::pcap_pkthdr header{};
+  header.len = packet.size();
+  for (size_t i = 0; i < num_packets; ++i) {
+    auto truncated = truncate_every > 0 && i % truncate_every == 0;
+    header.caplen = truncated ? 14 + 10 : packet.size();
+    size_t flow = flow_of(i);
+    packet[31] = (flow >> 16) & 0xff;
+    packet[32] = (flow >> 8) & 0xff;
+    packet[33] = flow & 0xff;
+    header.ts.tv_sec = i / packets_per_second;
+    header.ts.tv_usec = i % packets_per_second * 1'000'000 / packets_per_second;
+    ::pcap_dump(reinterpret_cast<u_char*>(dumper), &header, packet.data());
+  }
+  ::pcap_dump_close(dumper);
+  ::pcap_close(pcap);
+}
+
+size_t read_synthetic_trace(caf::settings settings) {
+  format::pcap::reader reader{defaults::system::table_slice_type,
+                              std::move(settings)};
+  auto [err, produced] = reader.read(std::numeric_limits<size_t>::max(),
+                                     defaults::system::table_slice_size,
+                                     [](const table_slice_ptr&) {});
+  CHECK_EQUAL(err, ec::end_of_input);
+  return produced;
+}
+
 } // namespace
 
 // Technically, we don't need the actor system. However, we do need to
@@ -133,4 +185,128 @@ TEST(PCAP read/write 2) {
   REQUIRE_EQUAL(writer.write(*slice), caf::none);
 }
 
+TEST(PCAP batches) {
+  // Packets arrive in batches of at most the slice size, so small slices
+  // exercise the batch boundaries.
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", artifacts::traces::nmap_vsn);
+  caf::put(settings, "import.pcap.cutoff", static_cast<uint64_t>(-1));
+  format::pcap::reader reader{defaults::system::table_slice_type,
+                              std::move(settings)};
+  std::vector<table_slice_ptr> slices;
+  auto add_slice = [&](const table_slice_ptr& x) { slices.push_back(x); };
+  auto [err, produced] = reader.read(std::numeric_limits<size_t>::max(), 7,
+                                     add_slice);
+  CHECK_EQUAL(err, ec::end_of_input);
+  REQUIRE_EQUAL(produced, 44u);
+  REQUIRE_EQUAL(slices.size(), 7u);
+  size_t row = 0;
+  for (auto& slice : slices) {
+    CHECK_LESS_EQUAL(slice->rows(), 7u);
+    auto community_id_column = unbox(slice->column("community_id"));
+    for (size_t i = 0; i < slice->rows(); ++i)
+      CHECK_VARIANT_EQUAL(community_id_column[i], community_ids[row++]);
+  }
+  CHECK_EQUAL(row, 44u);
+}
+
+TEST(PCAP flow table) {
+  constexpr size_t num_packets = 20'000;
+  constexpr size_t num_flows = 2'000;
+  auto file = "vast-unit-test-synthetic.pcap";
+  auto deleter = caf::detail::make_scope_guard([&] { rm(file); });
+  // Every flow sends a packet every two seconds.
+  write_synthetic_trace(file, num_packets, 1'000,
+                        [&](size_t i) { return i % num_flows; });
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", file);
+  caf::put(settings, "import.pcap.cutoff", static_cast<uint64_t>(32));
+  MESSAGE("cut off all but the first packet of each flow");
+  caf::put(settings, "import.pcap.max-flows", num_flows);
+  CHECK_EQUAL(read_synthetic_trace(settings), num_flows);
+  MESSAGE("evict the oldest flows when exceeding the flow table size");
+  caf::put(settings, "import.pcap.max-flows", num_flows / 2);
+  CHECK_EQUAL(read_synthetic_trace(settings), num_packets);
+  MESSAGE("evict flows after one second of inactivity");
+  caf::put(settings, "import.pcap.max-flows", num_flows);
+  caf::put(settings, "import.pcap.max-flow-age", size_t{1});
+  caf::put(settings, "import.pcap.flow-expiry", size_t{0});
+  CHECK_EQUAL(read_synthetic_trace(settings), num_packets);
+}
+
+TEST(PCAP flow table evicts the least recently active flows) {
+  constexpr size_t num_packets = 4'000;
+  auto file = "vast-unit-test-synthetic-lru.pcap";
+  auto deleter = caf::detail::make_scope_guard([&] { rm(file); });
+  // Every other packet belongs to the first flow, all others start a new flow.
+  write_synthetic_trace(file, num_packets, 1,
+                        [](size_t i) { return i % 2 == 0 ? 0 : i / 2 + 1; });
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", file);
+  caf::put(settings, "import.pcap.cutoff", static_cast<uint64_t>(32));
+  caf::put(settings, "import.pcap.max-flows", size_t{100});
+  caf::put(settings, "import.pcap.max-flow-age", size_t{1'000'000});
+  MESSAGE("the first flow stays in the table and yields only one packet");
+  CHECK_EQUAL(read_synthetic_trace(settings), num_packets / 2 + 1);
+}
+
+TEST(PCAP skips malformed packets) {
+  constexpr size_t num_packets = 1'000;
+  auto file = "vast-unit-test-synthetic-malformed.pcap";
+  auto deleter = caf::detail::make_scope_guard([&] { rm(file); });
+  write_synthetic_trace(
+    file, num_packets, 100, [](size_t i) { return i % 10; }, 10);
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", file);
+  caf::put(settings, "import.pcap.cutoff", static_cast<uint64_t>(-1));
+  CHECK_EQUAL(read_synthetic_trace(settings), num_packets - num_packets / 10);
+}
+
+TEST(PCAP IPv6 flows) {
+  auto file = "vast-unit-test-synthetic-ipv6.pcap";
+  auto deleter = caf::detail::make_scope_guard([&] { rm(file); });
+  auto pcap = ::pcap_open_dead(DLT_EN10MB, 65535);
+  REQUIRE(pcap != nullptr);
+  auto dumper = ::pcap_dump_open(pcap, file);
+  REQUIRE(dumper != nullptr);
+  std::array<u_char, 14 + 40 + 8 + 32> packet{};
+  packet[12] = 0x86; // EtherType IPv6
+  packet[13] = 0xdd;
+  packet[14] = 0x60; // IPv6
+  packet[19] = 8 + 32;
+  packet[20] = 17; // UDP
+  packet[21] = 64; // hop limit
+  packet[22] = 0x20; // 2001:db8::1 -> 2001:db8::2
+  packet[23] = 0x01;
+  packet[24] = 0x0d;
+  packet[25] = 0xb8;
+  packet[37] = 1;
+  std::copy(packet.begin() + 22, packet.begin() + 38, packet.begin() + 38);
+  packet[53] = 2;
+  packet[54] = 0xc0; // 49152 -> 53
+  packet[57] = 53;
+  ::pcap_pkthdr header{};
+  header.caplen = header.len = packet.size();
+  ::pcap_dump(reinterpret_cast<u_char*>(dumper), &header, packet.data());
+  ::pcap_dump_close(dumper);
+  ::pcap_close(pcap);
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", file);
+  format::pcap::reader reader{defaults::system::table_slice_type,
+                              std::move(settings)};
+  table_slice_ptr slice;
+  auto [err, produced] = reader.read(
+    std::numeric_limits<size_t>::max(), defaults::system::table_slice_size,
+    [&](const table_slice_ptr& x) { slice = x; });
+  CHECK_EQUAL(err, ec::end_of_input);
+  REQUIRE_EQUAL(produced, 1u);
+  auto src_field = slice->at(0, 1);
+  auto dst_field = slice->at(0, 2);
+  auto src = unbox(caf::get_if<view<address>>(&src_field));
+  auto dst = unbox(caf::get_if<view<address>>(&dst_field));
+  CHECK(src.is_v6());
+  CHECK_EQUAL(src, unbox(to<address>("2001:db8::1")));
+  CHECK_EQUAL(dst, unbox(to<address>("2001:db8::2")));
+}
+
 FIXTURE_SCOPE_END()
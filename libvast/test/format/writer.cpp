@@ -12,11 +12,14 @@
  ******************************************************************************/
 
 #include "vast/detail/string.hpp"
+#include "vast/detail/thread_pool.hpp"
 
 #include "vast/format/ascii.hpp"
 #include "vast/format/csv.hpp"
 #include "vast/format/json.hpp"
 
+#include <algorithm>
+
 #define SUITE format
 #include "vast/test/test.hpp"
 #include "vast/test/fixtures/events.hpp"
@@ -43,11 +46,14 @@ auto first_zeek_conn_log_line = R"__({"ts": 1258531221.486539, "uid": "Pii6cUUq1
 // clang-format on
 
 template <class Writer>
-std::vector<std::string> generate(const std::vector<table_slice_ptr>& xs) {
+std::vector<std::string>
+generate(const std::vector<table_slice_ptr>& xs,
+         std::shared_ptr<detail::thread_pool> pool = nullptr) {
   std::string str;
   caf::containerbuf<std::string> sb{str};
   auto out = std::make_unique<std::ostream>(&sb);
   Writer writer{std::move(out)};
+  writer.parallelize(std::move(pool));
   for (auto& x : xs)
     if (auto err = writer.write(*x))
       FAIL("failed to write event");
@@ -84,4 +90,24 @@ TEST(JSON writer) {
   CHECK_EQUAL(lines.front(), first_zeek_conn_log_line);
 }
 
+TEST(parallel writers) {
+  auto pool = std::make_shared<detail::thread_pool>(4);
+  auto mixed = zeek_conn_log_slices;
+  mixed.insert(mixed.end(), zeek_http_log_slices.begin(),
+               zeek_http_log_slices.end());
+  mixed.insert(mixed.end(), zeek_conn_log_slices.begin(),
+               zeek_conn_log_slices.end());
+  MESSAGE("ascii");
+  CHECK_EQUAL(generate<format::ascii::writer>(mixed, pool),
+              generate<format::ascii::writer>(mixed));
+  MESSAGE("csv");
+  auto csv_lines = generate<format::csv::writer>(mixed, pool);
+  CHECK_EQUAL(csv_lines, generate<format::csv::writer>(mixed));
+  auto is_header = [](auto& line) { return detail::starts_with(line, "type"); };
+  CHECK_EQUAL(std::count_if(csv_lines.begin(), csv_lines.end(), is_header), 3);
+  MESSAGE("json");
+  CHECK_EQUAL(generate<format::json::writer>(mixed, pool),
+              generate<format::json::writer>(mixed));
+}
+
 FIXTURE_SCOPE_END()
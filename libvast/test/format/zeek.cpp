@@ -26,7 +26,10 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/detail/fdinbuf.hpp"
+#include "vast/detail/string.hpp"
+#include "vast/detail/thread_pool.hpp"
 #include "vast/event.hpp"
+#include "vast/filesystem.hpp"
 
 using namespace vast;
 using namespace std::string_literals;
@@ -315,4 +318,40 @@ TEST(zeek writer) {
   CHECK(exists(dir / zeek_http_log[0].type().name() + ".log"));
 }
 
+TEST(parallel zeek writer) {
+  auto write = [&](const path& dir, std::shared_ptr<detail::thread_pool> pool) {
+    format::zeek::writer writer{dir};
+    writer.parallelize(std::move(pool));
+    for (auto& slice : zeek_conn_log_slices)
+      REQUIRE_EQUAL(writer.write(*slice), caf::none);
+    for (auto& slice : zeek_http_log_slices)
+      REQUIRE_EQUAL(writer.write(*slice), caf::none);
+  };
+  // The #open and #close lines contain timestamps, so we skip them.
+  auto load = [](const path& filename) {
+    auto contents = load_contents(filename);
+    REQUIRE(contents);
+    std::vector<std::string> result;
+    for (auto& line : detail::split(*contents, "\n"))
+      if (!detail::starts_with(line, "#open")
+          && !detail::starts_with(line, "#close"))
+        result.emplace_back(line);
+    return result;
+  };
+  auto sequential = path{"vast-unit-test-zeek-sequential"};
+  auto parallel = path{"vast-unit-test-zeek-parallel"};
+  auto guard = caf::detail::make_scope_guard([&] {
+    rm(sequential);
+    rm(parallel);
+  });
+  write(sequential, nullptr);
+  write(parallel, std::make_shared<detail::thread_pool>(4));
+  for (std::string name : {"zeek.conn.log", "zeek.http.log"}) {
+    MESSAGE(name);
+    auto xs = load(sequential / name);
+    CHECK_GREATER(xs.size(), 7u);
+    CHECK_EQUAL(load(parallel / name), xs);
+  }
+}
+
 FIXTURE_SCOPE_END()
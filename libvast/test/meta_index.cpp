@@ -30,6 +30,7 @@
 #include "vast/concept/parseable/vast/expression.hpp"
 
 #include "vast/detail/overload.hpp"
+#include "vast/detail/thread_pool.hpp"
 
 using namespace vast;
 
@@ -216,6 +217,65 @@ TEST(attribute extractor - type) {
   CHECK_EQUAL(lookup("#type !~ /x/"), ids);
 }
 
+TEST(older than) {
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch), empty());
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch + 24s), empty());
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch + 25s), slice(0));
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch + 74s), slice(0, 2));
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch + 100s), ids);
+  MESSAGE("erased partitions no longer qualify");
+  meta_idx.erase(ids[0]);
+  CHECK_EQUAL(meta_idx.lookup_older_than(epoch + 100s), slice(1, 4));
+  CHECK_EQUAL(attr_time_query("00:00:00"), empty());
+}
+
+TEST(max timestamp) {
+  CHECK_EQUAL(meta_idx.max_timestamp(ids[0]), epoch + 24s);
+  CHECK_EQUAL(meta_idx.max_timestamp(ids[1]), epoch + 49s);
+  CHECK_EQUAL(meta_idx.max_timestamp(ids[2]), epoch + 74s);
+  CHECK_EQUAL(meta_idx.max_timestamp(ids[3]), epoch + 99s);
+  MESSAGE("unknown partitions have no bound");
+  CHECK_EQUAL(meta_idx.max_timestamp(uuid::random()), vast::time::max());
+}
+
+TEST(erased partitions) {
+  meta_idx.erase(ids[1]);
+  CHECK_EQUAL(attr_time_query("00:00:25"), empty());
+  CHECK_EQUAL(lookup("#type == \"foobar\""), slice(3));
+  meta_idx.erase(ids[3]);
+  CHECK_EQUAL(lookup("#type == \"foobar\""), empty());
+  CHECK_EQUAL(attr_time_query("00:00:00", "00:01:39"),
+              (std::vector<uuid>{ids[0], ids[2]}));
+}
+
+TEST(parallel scan) {
+  MESSAGE("add enough partitions to split the scan across threads");
+  meta_index sequential;
+  meta_index parallel;
+  parallel.parallelize(std::make_shared<detail::thread_pool>(3));
+  generator g{"foo", 0};
+  for (size_t i = 0; i < 40'000; ++i) {
+    auto id = uuid::random();
+    auto slice = g(1);
+    sequential.add(id, *slice);
+    parallel.add(id, *slice);
+  }
+  MESSAGE("compare sequential and parallel lookups");
+  auto lookup = [&](meta_index& idx, std::string_view expr) {
+    return idx.lookup(unbox(to<expression>(expr)));
+  };
+  auto check = [&](std::string_view expr, size_t expected) {
+    auto xs = lookup(sequential, expr);
+    CHECK_EQUAL(xs.size(), expected);
+    CHECK_EQUAL(xs, lookup(parallel, expr));
+  };
+  check("#timestamp == 1970-01-01+05:00:00.0", 1);
+  check("#timestamp < 1970-01-01+00:00:10.0", 10);
+  check("#timestamp >= 1970-01-01+10:00:00.0", 4'000);
+  check("#timestamp != 1970-01-01+00:00:00.0", 39'999);
+  check("#timestamp > 1970-01-01+23:00:00.0", 0);
+}
+
 FIXTURE_SCOPE_END()
 
 FIXTURE_SCOPE(metaidx_serialization_tests, fixtures::deterministic_actor_system)
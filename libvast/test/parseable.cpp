@@ -23,6 +23,7 @@
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/offset.hpp"
+#include "vast/concept/parseable/vast/port.hpp"
 #include "vast/concept/parseable/vast/si.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/si_literals.hpp"
@@ -30,7 +31,9 @@
 #include <caf/test/dsl.hpp>
 
 #include <array>
+#include <chrono>
 #include <map>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -770,6 +773,101 @@ TEST(si int) {
   CHECK_EQUAL(to_int("-10Ei"), -10_Ei);
 }
 
+// -- fast paths --------------------------------------------------------------
+
+namespace {
+
+// Reference implementation of the digit loop in integral_parser.
+template <class T>
+size_t accumulate_slowly(std::string_view str, int max_digits, T& x) {
+  x = 0;
+  size_t i = 0;
+  for (; i < str.size() && static_cast<int>(i) < max_digits
+         && str[i] >= '0' && str[i] <= '9';
+       ++i) {
+    x *= 10;
+    x += str[i] - '0';
+  }
+  return i;
+}
+
+std::vector<std::string>
+random_strings(size_t n, std::string (*gen)(std::mt19937&)) {
+  std::mt19937 rng{42};
+  std::vector<std::string> result(n);
+  for (auto& x : result)
+    x = gen(rng);
+  return result;
+}
+
+} // namespace
+
+TEST(fast path - digits) {
+  auto digits = [](std::mt19937& rng) {
+    std::string result;
+    auto n = rng() % 30;
+    for (size_t i = 0; i < n; ++i)
+      result += rng() % 23 == 0 ? 'x' : static_cast<char>('0' + rng() % 10);
+    return result;
+  };
+  for (auto& str : random_strings(10'000, digits)) {
+    auto check = [&](auto x, auto p, int max_digits) {
+      auto expected = x;
+      auto n = accumulate_slowly(str, max_digits, expected);
+      auto f = str.begin();
+      auto l = str.end();
+      REQUIRE_EQUAL(p.parse(f, l, x), n > 0);
+      if (n > 0) {
+        CHECK_EQUAL(x, expected);
+        CHECK_EQUAL(static_cast<size_t>(f - str.begin()), n);
+      }
+    };
+    check(uint64_t{0}, parsers::u64, 20);
+    check(uint16_t{0}, parsers::u16, 5);
+    check(int64_t{0}, integral_parser<int64_t, 18>{}, 18);
+  }
+}
+
+TEST(fast path - real) {
+  auto p = make_parser<double>{};
+  double x;
+  CHECK(p("1258531221.486539", x));
+  CHECK_EQUAL(x, 1258531221.0 + 486539.0 / std::pow(10.0, 6));
+  CHECK(p("-0.000001", x));
+  CHECK_EQUAL(x, -1e-6);
+  MESSAGE("more digits than a double represents exactly");
+  double integral;
+  accumulate_slowly("12345678901234567890", 20, integral);
+  CHECK(p("12345678901234567890.5", x));
+  CHECK_EQUAL(x, integral + 0.5);
+}
+
+TEST(fast path - IPv4) {
+  auto v4 = address_parser::make_v4();
+  for (auto str : {"1.2.3.4"s, "255.255.255.255"s, "010.0.0.1:80"s,
+                   "256.1.1.1"s, "1.2.3"s, "1.2.3.4567"s, "1..2.3"s}) {
+    MESSAGE("parsing " << str);
+    address x;
+    auto f = str.begin();
+    auto result = parsers::addr.parse(f, str.end(), x);
+    auto g = str.begin();
+    uint16_t a, b, c, d;
+    REQUIRE_EQUAL(result, v4(g, str.end(), a, b, c, d));
+    if (result) {
+      CHECK(x.is_v4());
+      CHECK(f == g);
+      auto& bytes = x.data();
+      CHECK_EQUAL(bytes[12], a);
+      CHECK_EQUAL(bytes[13], b);
+      CHECK_EQUAL(bytes[14], c);
+      CHECK_EQUAL(bytes[15], d);
+    }
+  }
+  address x;
+  CHECK(parsers::addr("::ffff:1.2.3.4", x));
+  CHECK_EQUAL(x, *to<address>("1.2.3.4"));
+}
+
 // -- API ---------------------------------------------------------------------
 
 TEST(stream) {
@@ -22,6 +22,8 @@
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 
+#include "vast/column_encoding.hpp"
+#include "vast/expression.hpp"
 #include "vast/ids.hpp"
 #include "vast/load.hpp"
 #include "vast/table_slice.hpp"
@@ -68,4 +70,84 @@ TEST(serialization) {
                    z->chunk()->begin(), z->chunk()->end()));
 }
 
+TEST(selective column decoding) {
+  segment_builder builder;
+  for (auto& slice : zeek_conn_log_slices)
+    REQUIRE(!builder.add(slice));
+  auto x = builder.finish();
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  auto& meta = x->meta();
+  REQUIRE_EQUAL(meta.columns.size(), meta.slices.size());
+  auto& layout = zeek_conn_log_slices[0]->layout();
+  REQUIRE_EQUAL(meta.columns[0].size(), layout.fields.size());
+  CHECK(meta.columns[0][0].encoding == column_encoding::delta);
+  CHECK(meta.columns[0][1].encoding == column_encoding::dictionary);
+  MESSAGE("decode only the originator address and port");
+  auto xs = unbox(x->lookup(make_ids({0, 6, 19, 21}),
+                            {"id.orig_h", "id.orig_p"}, expression{}));
+  REQUIRE_EQUAL(xs.size(), 2u);
+  CHECK_EQUAL(xs[0]->offset(), zeek_conn_log_slices[0]->offset());
+  CHECK_EQUAL(xs[0]->layout().name(), layout.name());
+  REQUIRE_EQUAL(xs[0]->columns(), 2u);
+  for (size_t row = 0; row < xs[0]->rows(); ++row) {
+    CHECK_EQUAL(xs[0]->at(row, 0), zeek_conn_log_slices[0]->at(row, 2));
+    CHECK_EQUAL(xs[0]->at(row, 1), zeek_conn_log_slices[0]->at(row, 3));
+  }
+  MESSAGE("skip slices without matching columns");
+  CHECK(unbox(x->lookup(make_ids({0}), {"nonexistent"}, expression{}))
+          .empty());
+}
+
+TEST(zone maps) {
+  segment_builder builder;
+  for (auto& slice : zeek_conn_log_slices)
+    REQUIRE(!builder.add(slice));
+  auto x = builder.finish();
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  auto& meta = x->meta();
+  REQUIRE_EQUAL(meta.zones.size(), meta.slices.size());
+  auto& layout = zeek_conn_log_slices[0]->layout();
+  auto& ts = meta.zones[0].ranges()[0];
+  CHECK_NOT_EQUAL(ts.min, data{caf::none});
+  auto query = [&](relational_operator op) {
+    return expression{
+      predicate{data_extractor{layout, offset{0}}, op, ts.min}};
+  };
+  MESSAGE("skip slices whose zone maps rule out the query");
+  CHECK(unbox(x->lookup(make_ids({0}), {}, query(less))).empty());
+  CHECK_EQUAL(unbox(x->lookup(make_ids({0}), {}, query(less_equal))).size(),
+              1u);
+}
+
+TEST(version 1 segments) {
+  // Version 1 segments store every slice as a whole and have no column
+  // directory in their meta data.
+  std::vector<char> payload;
+  segment::meta_data meta;
+  for (auto& slice : zeek_conn_log_slices) {
+    auto before = payload.size();
+    caf::binary_serializer sink{nullptr, payload};
+    REQUIRE_EQUAL(sink(slice), caf::none);
+    meta.slices.push_back({static_cast<int64_t>(before),
+                           static_cast<int64_t>(payload.size()),
+                           slice->offset(), slice->rows()});
+  }
+  segment_header header{segment::magic, 1, uuid::random(), 0};
+  auto payload_chunk = chunk::make(std::move(payload));
+  std::vector<char> buf;
+  caf::binary_serializer sink{nullptr, buf};
+  REQUIRE_EQUAL(sink(header, meta.slices, payload_chunk), caf::none);
+  auto x = segment::make(chunk::make(std::move(buf)));
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  CHECK(x->meta().columns.empty());
+  auto xs = unbox(x->lookup(make_ids({0, 6, 19, 21})));
+  REQUIRE_EQUAL(xs.size(), 2u);
+  CHECK_EQUAL(*xs[0], *zeek_conn_log_slices[0]);
+  CHECK_EQUAL(*xs[1], *zeek_conn_log_slices[2]);
+  MESSAGE("project slices of version 1 segments");
+  auto ys = unbox(x->lookup(make_ids({0}), {"id.orig_h"}, expression{}));
+  REQUIRE_EQUAL(ys.size(), 1u);
+  CHECK_EQUAL(ys[0]->columns(), 1u);
+}
+
 FIXTURE_SCOPE_END()
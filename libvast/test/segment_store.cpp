@@ -301,4 +301,33 @@ TEST(erase slice part from persisted segment) {
   CHECK_SLICE(slices[3], 2, 0);
 }
 
+TEST(compact persisted segments) {
+  for (auto& slice : zeek_conn_log_slices)
+    put_cold({slice});
+  CHECK_EQUAL(segment_files().size(), 3u);
+  MESSAGE("segments above the threshold remain untouched");
+  CHECK_EQUAL(unbox(store->compact(0, 10)), 0u);
+  CHECK_EQUAL(segment_files().size(), 3u);
+  MESSAGE("merge all small segments into one");
+  CHECK_EQUAL(unbox(store->compact(512_KiB, 10)), 2u);
+  CHECK(deep_compare(zeek_conn_log_slices, get(everything)));
+  auto slices = get(make_ids({{10, 14}}));
+  REQUIRE_EQUAL(slices.size(), 1u);
+  CHECK_SLICE(slices[0], 1, 0);
+  store = nullptr;
+  CHECK_EQUAL(segment_files().size(), 1u);
+  MESSAGE("reload the store from its meta data");
+  store = segment_store::make(directory / "segments", 512_KiB, 2);
+  REQUIRE(store != nullptr);
+  CHECK(deep_compare(zeek_conn_log_slices, get(everything)));
+}
+
+TEST(compact skips the active segment) {
+  put_cold({zeek_conn_log_slices[0]});
+  put({zeek_conn_log_slices[1], zeek_conn_log_slices[2]});
+  CHECK_EQUAL(unbox(store->compact(512_KiB, 10)), 0u);
+  CHECK_EQUAL(store->dirty(), true);
+  CHECK(deep_compare(zeek_conn_log_slices, get(everything)));
+}
+
 FIXTURE_SCOPE_END()
@@ -176,6 +176,11 @@ TEST(splitting) {
   CHECK_EQUAL(s[2], "b");
   CHECK_EQUAL(s[3], "-");
   CHECK_EQUAL(s[4], "c*-d");
+  MESSAGE("split into an existing vector");
+  split(s, "x,y", ",");
+  REQUIRE(s.size() == 2);
+  CHECK_EQUAL(s[0], "x");
+  CHECK_EQUAL(s[1], "y");
 }
 
 TEST(join) {
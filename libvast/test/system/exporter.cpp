@@ -21,12 +21,16 @@
 
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/default_table_slice.hpp"
 #include "vast/detail/spawn_container_source.hpp"
 #include "vast/query_options.hpp"
 #include "vast/system/archive.hpp"
 #include "vast/system/dummy_consensus.hpp"
+#include "vast/system/federated_exporter.hpp"
 #include "vast/system/importer.hpp"
 #include "vast/system/index.hpp"
+#include "vast/system/query_status.hpp"
+#include "vast/system/tracker.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/to_events.hpp"
 
@@ -35,6 +39,7 @@ using namespace vast;
 
 using std::string;
 using std::chrono_literals::operator""ms;
+using std::chrono_literals::operator""s;
 
 namespace {
 
@@ -76,8 +81,10 @@ struct fixture : fixture_base {
     consensus = self->spawn(system::dummy_consensus, directory / "consensus");
   }
 
-  void spawn_exporter(query_options opts) {
-    exporter = self->spawn(system::exporter, expr, opts);
+  void spawn_exporter(query_options opts, system::query_budget budget = {},
+                      std::vector<std::string> projection = {}) {
+    exporter = self->spawn(system::exporter, expr, opts, budget,
+                           std::move(projection));
   }
 
   void importer_setup() {
@@ -94,8 +101,9 @@ struct fixture : fixture_base {
     run();
   }
 
-  void exporter_setup(query_options opts) {
-    spawn_exporter(opts);
+  void exporter_setup(query_options opts, system::query_budget budget = {},
+                      std::vector<std::string> projection = {}) {
+    spawn_exporter(opts, budget, std::move(projection));
     send(exporter, archive);
     send(exporter, system::index_atom::value, index);
     send(exporter, system::sink_atom::value, self);
@@ -104,6 +112,40 @@ struct fixture : fixture_base {
     run();
   }
 
+  /// Spawns a second node, ingests conn.log into both nodes, and registers
+  /// the components of both nodes at a TRACKER.
+  void federation_setup() {
+    spawn_index();
+    spawn_archive();
+    peer_index = self->spawn(system::index, directory / "peer" / "index",
+                             10000, 5, 5, 1);
+    peer_archive = self->spawn(system::archive,
+                               directory / "peer" / "archive", 1, 1024);
+    run();
+    vast::detail::spawn_container_source(sys, zeek_conn_log_slices, index,
+                                         archive);
+    vast::detail::spawn_container_source(sys, zeek_conn_log_slices,
+                                         peer_index, peer_archive);
+    run();
+    tracker = self->spawn(system::tracker, "local");
+    auto put = [&](auto node, auto type, auto hdl) {
+      send(tracker, system::put_atom::value, std::string{node},
+           std::string{type}, actor_cast<actor>(hdl), std::string{type});
+    };
+    put("local", "archive", archive);
+    put("local", "index", index);
+    put("peer", "archive", peer_archive);
+    put("peer", "index", peer_index);
+    run();
+  }
+
+  void federation_teardown() {
+    for (auto& hdl : {peer_index, actor_cast<actor>(peer_archive),
+                      actor_cast<actor>(tracker)})
+      self->send_exit(hdl, exit_reason::user_shutdown);
+    run();
+  }
+
   template <class Hdl, class... Ts>
   void send(Hdl hdl, Ts&&... xs) {
     self->send(hdl, std::forward<Ts>(xs)...);
@@ -130,6 +172,9 @@ struct fixture : fixture_base {
   actor importer;
   actor exporter;
   system::consensus_type consensus;
+  actor peer_index;
+  system::archive_type peer_archive;
+  system::tracker_type tracker;
   expression expr;
 };
 
@@ -176,6 +221,210 @@ TEST(historical query with importer) {
   CHECK_EQUAL(results.back().id(), 19u);
 }
 
+TEST(historical query with budget) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log_slices, index,
+                                       archive);
+  run();
+  MESSAGE("spawn exporter that evaluates one partition at a time and defers "
+          "archive lookups while it caches any results");
+  system::query_budget budget;
+  budget.max_buffered_bytes = 1;
+  budget.max_partitions = 1;
+  exporter_setup(historical, budget);
+  MESSAGE("fetch results");
+  auto results = fetch_results();
+  REQUIRE_EQUAL(results.size(), 5u);
+  std::sort(results.begin(), results.end());
+  CHECK_EQUAL(results.front().id(), 10u);
+  CHECK_EQUAL(results.back().id(), 19u);
+}
+
+TEST(historical query with projection) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log_slices, index,
+                                       archive);
+  run();
+  MESSAGE("spawn exporter that only ships the responder address");
+  expr = unbox(to<expression>("id.orig_h == 192.168.1.103"));
+  exporter_setup(historical, {}, {"id.resp_h"});
+  MESSAGE("fetch results");
+  std::vector<table_slice_ptr> slices;
+  bool running = true;
+  self->receive_while(running)(
+    [&](table_slice_ptr slice) { slices.emplace_back(std::move(slice)); },
+    error_handler(), after(0ms) >> [&] { running = false; });
+  size_t rows = 0;
+  for (auto& slice : slices) {
+    REQUIRE_EQUAL(slice->columns(), 1u);
+    CHECK_EQUAL(slice->column_name(0), "id.resp_h");
+    CHECK_EQUAL(slice->layout().name(), "zeek.conn");
+    rows += slice->rows();
+  }
+  CHECK_EQUAL(rows, 5u);
+}
+
+TEST(historical query for the latest events) {
+  MESSAGE("spawn index and archive");
+  spawn_index();
+  spawn_archive();
+  run();
+  MESSAGE("ingest conn.log into archive and index");
+  vast::detail::spawn_container_source(sys, zeek_conn_log_slices, index,
+                                       archive);
+  run();
+  MESSAGE("spawn exporter for the three most recent results");
+  expr = unbox(to<expression>("id.orig_h == 192.168.1.103"));
+  spawn_exporter(historical + ordered);
+  send(exporter, archive);
+  send(exporter, system::index_atom::value, index);
+  send(exporter, system::sink_atom::value, self);
+  send(exporter, system::extract_atom::value, uint64_t{3});
+  send(exporter, system::run_atom::value);
+  run();
+  MESSAGE("fetch results");
+  auto results = fetch_results();
+  REQUIRE_EQUAL(results.size(), 3u);
+  CHECK_EQUAL(results[0].id(), 7u);
+  CHECK_EQUAL(results[1].id(), 14u);
+  CHECK_EQUAL(results[2].id(), 16u);
+}
+
+TEST(historical query for the latest events skips older partitions) {
+  MESSAGE("spawn an index that puts every slice into its own partition");
+  index = self->spawn(system::index, directory / "index", 1, 10, 5, 1);
+  spawn_archive();
+  run();
+  MESSAGE("ingest one event per day, with the newest events first");
+  auto layout = record_type{{"ts", time_type{}.attributes({{"timestamp"}})},
+                            {"x", count_type{}}}
+                  .name("daily");
+  std::vector<table_slice_ptr> slices;
+  for (int day = 1; day <= 6; ++day) {
+    auto ts = vast::time{std::chrono::hours{24 * day}};
+    std::vector<vector> rows{vector{ts, count{1}}};
+    auto slice = default_table_slice::make(layout, rows);
+    slice.unshared().offset(6 - day);
+    slices.push_back(std::move(slice));
+  }
+  vast::detail::spawn_container_source(sys, std::move(slices), index,
+                                       archive);
+  run();
+  MESSAGE("spawn exporter for the two most recent results");
+  expr = unbox(to<expression>("x == 1"));
+  spawn_exporter(historical + ordered);
+  send(exporter, archive);
+  send(exporter, system::index_atom::value, index);
+  send(exporter, system::sink_atom::value, self);
+  send(exporter, system::statistics_atom::value, self);
+  send(exporter, system::extract_atom::value, uint64_t{2});
+  send(exporter, system::run_atom::value);
+  run();
+  MESSAGE("fetch results and statistics");
+  std::vector<event> results;
+  caf::optional<system::query_status> status;
+  bool running = true;
+  self->receive_while(running)(
+    [&](table_slice_ptr slice) { to_events(results, *slice); },
+    [&](const std::string&, const system::query_status& qs) { status = qs; },
+    error_handler(), after(0ms) >> [&] { running = false; });
+  MESSAGE("the results are sorted by time rather than by ID");
+  REQUIRE_EQUAL(results.size(), 2u);
+  CHECK_EQUAL(results[0].id(), 1u);
+  CHECK_EQUAL(results[1].id(), 0u);
+  MESSAGE("the exporter never evaluated the four oldest partitions");
+  REQUIRE(status);
+  CHECK_EQUAL(status->expected, 6u);
+  CHECK_EQUAL(status->processed, 2u);
+}
+
+TEST(federated historical query) {
+  MESSAGE("spawn and fill two nodes");
+  federation_setup();
+  MESSAGE("spawn federated exporter for seven results");
+  exporter = self->spawn(system::federated_exporter, tracker, expr,
+                         historical, system::query_budget{},
+                         std::vector<std::string>{});
+  send(exporter, system::sink_atom::value, self);
+  send(exporter, system::extract_atom::value, uint64_t{7});
+  send(exporter, system::run_atom::value);
+  run();
+  MESSAGE("fetch results");
+  CHECK_EQUAL(fetch_results().size(), 7u);
+  MESSAGE("extract the remaining results of both nodes");
+  send(exporter, system::extract_atom::value);
+  run();
+  CHECK_EQUAL(fetch_results().size(), 3u);
+  federation_teardown();
+}
+
+TEST(federated historical query stops with its sink) {
+  MESSAGE("spawn and fill two nodes");
+  federation_setup();
+  MESSAGE("spawn federated exporter for two results");
+  auto sink = sys.spawn([]() -> behavior {
+    return {
+      [](const table_slice_ptr&) {
+        // nop
+      },
+    };
+  });
+  exporter = self->spawn(system::federated_exporter, tracker, expr,
+                         historical, system::query_budget{},
+                         std::vector<std::string>{});
+  self->monitor(exporter);
+  send(exporter, system::sink_atom::value, sink);
+  send(exporter, system::extract_atom::value, uint64_t{2});
+  send(exporter, system::run_atom::value);
+  run();
+  MESSAGE("terminate the sink");
+  self->send_exit(sink, exit_reason::user_shutdown);
+  run();
+  auto terminated = false;
+  self->receive(
+    [&](const down_msg& x) {
+      CHECK_EQUAL(x.source, exporter);
+      terminated = true;
+    },
+    after(0s) >> [] {
+      // nop
+    });
+  CHECK(terminated);
+  federation_teardown();
+}
+
+TEST(query timeout) {
+  MESSAGE("prepare exporter for continuous query with a timeout");
+  system::query_budget budget;
+  budget.timeout = 10s;
+  spawn_exporter(continuous, budget);
+  self->monitor(exporter);
+  send(exporter, system::sink_atom::value, self);
+  send(exporter, system::run_atom::value);
+  run();
+  MESSAGE("exceed the deadline");
+  sched.trigger_timeouts();
+  run();
+  auto cancelled = false;
+  self->receive(
+    [&](const down_msg& x) {
+      CHECK(x.reason == ec::budget_exceeded);
+      cancelled = true;
+    },
+    after(0s) >> [] {
+      // nop
+    });
+  CHECK(cancelled);
+}
+
 TEST(continuous query with exporter only) {
   MESSAGE("prepare exporter for continuous query");
   spawn_exporter(continuous);
@@ -127,6 +127,38 @@ struct fixture : fixtures::deterministic_actor_system_and_events {
     return xs;
   }
 
+  /// Makes a slice with a single timestamped event on the given day.
+  table_slice_ptr make_daily_slice(int day, id offset) {
+    auto layout = record_type{{"ts", time_type{}.attributes({{"timestamp"}})},
+                              {"x", count_type{}}}
+                    .name("daily");
+    auto ts = time{hours{24 * day}};
+    std::vector<vector> rows{vector{ts, count{1}}};
+    auto slice = default_table_slice::make(layout, rows);
+    slice.unshared().offset(offset);
+    return slice;
+  }
+
+  void ingest(std::vector<table_slice_ptr> slices) {
+    detail::spawn_container_source(sys, std::move(slices), index);
+    run();
+  }
+
+  /// Routes the slices by day into at most two open partitions.
+  void enable_daily_buckets(caf::atom_value late_data_policy) {
+    state().partition_time_window = hours{24};
+    state().max_open_partitions = 2;
+    state().late_data_policy = late_data_policy;
+  }
+
+  // Returns the start times of all open time buckets.
+  std::vector<time> open_buckets() {
+    std::vector<time> result;
+    for (auto& kvp : state().buckets)
+      result.push_back(kvp.first);
+    return result;
+  }
+
   // Handle to the INDEX actor.
   caf::actor index;
 };
@@ -221,4 +253,85 @@ TEST(iterable zeek conn log query result) {
   }
 }
 
+TEST(time partitioned zeek conn log query result) {
+  state().partition_time_window = hours{24};
+  MESSAGE("ingest conn.log slices");
+  detail::spawn_container_source(sys, zeek_conn_log_slices, index);
+  run();
+  MESSAGE("all slices fall into the same day");
+  auto bucket = state().time_bucket_of(*zeek_conn_log_slices.front());
+  CHECK_NOT_EQUAL(bucket, time::min());
+  for (auto& slice : zeek_conn_log_slices)
+    CHECK_EQUAL(state().time_bucket_of(*slice), bucket);
+  REQUIRE_EQUAL(state().buckets.size(), 1u);
+  CHECK_EQUAL(state().buckets.begin()->first, bucket);
+  MESSAGE("query the time bucket partition");
+  auto [query_id, hits, scheduled] = query("service == \"dns\"");
+  auto result = receive_result(query_id, hits, scheduled);
+  CHECK_EQUAL(rank(result), 11u);
+}
+
+TEST(time partitions evict the oldest bucket when reaching the limit) {
+  enable_daily_buckets(caf::atom("evict"));
+  ingest({make_daily_slice(1, 0), make_daily_slice(2, 1)});
+  REQUIRE_EQUAL(open_buckets(), (std::vector<time>{time{hours{24}},
+                                                   time{hours{48}}}));
+  auto first = state().buckets.begin()->second.part->id();
+  MESSAGE("a third day closes the partition of the first day");
+  ingest({make_daily_slice(3, 2)});
+  CHECK_EQUAL(open_buckets(), (std::vector<time>{time{hours{48}},
+                                                 time{hours{72}}}));
+  CHECK_EQUAL(state().find_active(first), nullptr);
+  MESSAGE("the closed partition remains queryable");
+  auto [query_id, hits, scheduled] = query("x == 1");
+  CHECK_EQUAL(rank(receive_result(query_id, hits, scheduled)), 3u);
+}
+
+TEST(late data opens a new bucket under the evict policy) {
+  enable_daily_buckets(caf::atom("evict"));
+  ingest({make_daily_slice(2, 0), make_daily_slice(3, 1)});
+  auto evicted = state().buckets.begin()->second.part->id();
+  MESSAGE("late data evicts the oldest bucket and gets its own partition");
+  ingest({make_daily_slice(1, 2)});
+  CHECK_EQUAL(open_buckets(), (std::vector<time>{time{hours{24}},
+                                                 time{hours{72}}}));
+  CHECK_EQUAL(state().find_active(evicted), nullptr);
+  CHECK_NOT_EQUAL(state().buckets.begin()->second.part->id(), evicted);
+  auto [query_id, hits, scheduled] = query("x == 1");
+  CHECK_EQUAL(rank(receive_result(query_id, hits, scheduled)), 3u);
+}
+
+TEST(late data joins the oldest bucket under the nearest policy) {
+  enable_daily_buckets(caf::atom("nearest"));
+  ingest({make_daily_slice(2, 0), make_daily_slice(3, 1)});
+  auto& oldest = *state().buckets.begin()->second.part;
+  auto oldest_id = oldest.id();
+  auto capacity = oldest.capacity();
+  MESSAGE("late data keeps all buckets open");
+  ingest({make_daily_slice(1, 2)});
+  CHECK_EQUAL(open_buckets(), (std::vector<time>{time{hours{48}},
+                                                 time{hours{72}}}));
+  auto& nearest = *state().buckets.begin()->second.part;
+  CHECK_EQUAL(nearest.id(), oldest_id);
+  CHECK_EQUAL(nearest.capacity(), capacity - 1);
+  auto [query_id, hits, scheduled] = query("x == 1");
+  CHECK_EQUAL(rank(receive_result(query_id, hits, scheduled)), 3u);
+}
+
+TEST(erasing old partitions waits for running queries) {
+  enable_daily_buckets(caf::atom("evict"));
+  ingest({make_daily_slice(1, 0), make_daily_slice(2, 1)});
+  auto first = state().buckets.begin()->second.part->id();
+  ingest({make_daily_slice(3, 2)});
+  REQUIRE_EQUAL(state().find_unpersisted(first), nullptr);
+  MESSAGE("a running query keeps the partition of the first day");
+  state().evaluating[first] = 1;
+  CHECK_EQUAL(rank(state().erase_older_than(time{hours{48}})), 0u);
+  MESSAGE("the next run erases the partition once the query finished");
+  state().evaluating.clear();
+  CHECK_EQUAL(rank(state().erase_older_than(time{hours{48}})), 1u);
+  auto [query_id, hits, scheduled] = query("x == 1");
+  CHECK_EQUAL(rank(receive_result(query_id, hits, scheduled)), 2u);
+}
+
 FIXTURE_SCOPE_END()
@@ -24,6 +24,7 @@
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/type.hpp"
+#include "vast/concept/printable/vast/uuid.hpp"
 #include "vast/default_table_slice.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/detail/spawn_container_source.hpp"
@@ -223,6 +224,43 @@ TEST(eager initialization) {
   });
 }
 
+TEST(initialization from snapshot) {
+  MESSAGE("create new partition");
+  uuid id;
+  record_type layout{{"value", integer_type{}}};
+  record_type other{{"other", integer_type{}}};
+  auto rows = make_rows(1, 2, 3);
+  run_in_index([&] {
+    make_partition();
+    id = put->id();
+    ingest(default_table_slice::make(layout, rows));
+    ingest(default_table_slice::make(other, rows));
+    reset_partition();
+  });
+  run();
+  MESSAGE("read the layouts of a query without accessing the INDEX");
+  auto expr = unbox(to<expression>("value == 1"));
+  auto x = partition::read(idx_state->dir / to_string(id), expr);
+  REQUIRE(x);
+  CHECK_EQUAL(x->meta.types.size(), 2u);
+  CHECK_EQUAL(x->tables.size(), 1u);
+  MESSAGE("materialize partition from the snapshot");
+  run_in_index([&] {
+    make_partition(id);
+    put->init(std::move(*x));
+    CHECK_EQUAL(put->dirty(), false);
+    CHECK_EQUAL(sorted_strings(put->layouts()),
+                sorted_strings(std::vector{layout, other}));
+    auto& tbl = unbox(put->get_or_add(layout)).first;
+    CHECK_EQUAL(rank(tbl.row_ids()), rows.size());
+    MESSAGE("layouts outside of the snapshot load on first access");
+    auto& other_tbl = unbox(put->get_or_add(other)).first;
+    CHECK_EQUAL(rank(other_tbl.row_ids()), rows.size());
+    CHECK_EQUAL(running_indexers(), 0u);
+    reset_partition();
+  });
+}
+
 TEST(zeek conn log http slices) {
   use_real_indexer_actors();
   MESSAGE("scrutinize each zeek conn log slice individually");
@@ -64,8 +64,8 @@ public:
     return caf::make_counted<rebranded_table_slice_builder>(std::move(layout));
   }
 
-  table_slice_ptr finish() override {
-    auto result = super::finish();
+  table_slice_ptr finish_impl() override {
+    auto result = super::finish_impl();
     eager_init();
     return result;
   }
@@ -196,6 +196,97 @@ TEST(select suffix) {
   CHECK_EQUAL(to_events(*xs[0]), to_events(*sut, 50, 50));
 }
 
+TEST(copy rows) {
+  auto sut = zeek_full_conn_log_slices.front();
+  sut.unshared().offset(100);
+  auto xs = sut->copy_rows(10, 20);
+  REQUIRE_NOT_EQUAL(xs, nullptr);
+  CHECK_EQUAL(xs->implementation_id(), sut->implementation_id());
+  CHECK_EQUAL(xs->offset(), 110u);
+  CHECK_EQUAL(xs->rows(), 20u);
+  CHECK_EQUAL(to_events(*xs), to_events(*sut, 10, 20));
+  MESSAGE("append rows of two slices to a builder");
+  default_table_slice_builder builder{sut->layout()};
+  REQUIRE(builder.add_rows(*sut, 0, 5));
+  REQUIRE(builder.add_rows(*xs, 0, 20));
+  auto ys = builder.finish();
+  REQUIRE_NOT_EQUAL(ys, nullptr);
+  REQUIRE_EQUAL(ys->rows(), 25u);
+  for (size_t row = 0; row < ys->rows(); ++row) {
+    auto source_row = row < 5 ? row : row + 5;
+    for (size_t column = 0; column < ys->columns(); ++column)
+      CHECK_EQUAL(ys->at(row, column), sut->at(source_row, column));
+  }
+  MESSAGE("reject rows of a different layout");
+  CHECK(!builder.add_rows(*bgpdump_txt_slices.front(), 0, 1));
+}
+
+TEST(add owned values) {
+  using namespace std::string_literals;
+  record_type layout{{"s", string_type{}}, {"n", count_type{}}};
+  default_table_slice_builder builder{layout};
+  auto str = data{"a string that exceeds the small buffer optimization"s};
+  REQUIRE(builder.add(std::move(str)));
+  REQUIRE(builder.add(data{count{42}}));
+  MESSAGE("reject owned values of the wrong type");
+  CHECK(!builder.add(data{count{42}}));
+  REQUIRE(builder.add(data{"foo"s}));
+  REQUIRE(builder.add(data{caf::none}));
+  auto slice = builder.finish();
+  REQUIRE_NOT_EQUAL(slice, nullptr);
+  REQUIRE_EQUAL(slice->rows(), 2u);
+  CHECK_EQUAL(materialize(slice->at(0, 0)),
+              data{"a string that exceeds the small buffer optimization"s});
+  CHECK_EQUAL(materialize(slice->at(0, 1)), data{count{42}});
+  CHECK_EQUAL(materialize(slice->at(1, 1)), data{caf::none});
+}
+
+TEST(first value time) {
+  record_type layout{{"n", count_type{}}};
+  default_table_slice_builder builder{layout};
+  auto before = std::chrono::steady_clock::now();
+  REQUIRE(builder.add(count{1}));
+  auto first = builder.first_value_time();
+  CHECK(first >= before);
+  REQUIRE(builder.add(count{2}));
+  CHECK(builder.first_value_time() == first);
+  MESSAGE("the next slice starts with its own first value");
+  REQUIRE_NOT_EQUAL(builder.finish(), nullptr);
+  auto after = std::chrono::steady_clock::now();
+  REQUIRE(builder.add(count{3}));
+  CHECK(builder.first_value_time() >= after);
+}
+
+TEST(project) {
+  auto sut = zeek_conn_log_slices.front();
+  sut.unshared().offset(100);
+  auto xs = project(sut, {"id.resp_h", "uid", "orig_h"});
+  REQUIRE_NOT_EQUAL(xs, nullptr);
+  CHECK_EQUAL(xs->implementation_id(), sut->implementation_id());
+  CHECK_EQUAL(xs->layout().name(), sut->layout().name());
+  CHECK_EQUAL(xs->offset(), 100u);
+  REQUIRE_EQUAL(xs->rows(), sut->rows());
+  REQUIRE_EQUAL(xs->columns(), 3u);
+  CHECK_EQUAL(xs->column_name(0), "uid");
+  CHECK_EQUAL(xs->column_name(1), "id.orig_h");
+  CHECK_EQUAL(xs->column_name(2), "id.resp_h");
+  for (size_t row = 0; row < xs->rows(); ++row) {
+    CHECK_EQUAL(xs->at(row, 0), sut->at(row, 1));
+    CHECK_EQUAL(xs->at(row, 1), sut->at(row, 2));
+    CHECK_EQUAL(xs->at(row, 2), sut->at(row, 4));
+  }
+  MESSAGE("project onto all or no columns");
+  CHECK_EQUAL(project(sut, {"*"}), sut);
+  CHECK_EQUAL(project(sut, {"nonexistent"}), nullptr);
+  MESSAGE("reuse the resolved columns for slices of the same layout");
+  projection_cache projection{{"id.resp_h", "uid", "orig_h"}};
+  CHECK_EQUAL(projection.columns(sut->layout()),
+              (std::vector<size_t>{1, 2, 4}));
+  CHECK_EQUAL(*projection(sut), *xs);
+  CHECK_EQUAL(*projection(zeek_conn_log_slices[1]),
+              *project(zeek_conn_log_slices[1], projection.fields()));
+}
+
 TEST(truncate) {
   auto sut = zeek_conn_log_slices.front();
   REQUIRE_EQUAL(sut->rows(), 8u);
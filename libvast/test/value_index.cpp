@@ -401,6 +401,30 @@ TEST(subnet) {
   CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
   bm = idx2.lookup(not_equal, make_data_view(s1));
   CHECK_EQUAL(to_string(unbox(bm)), "101111");
+  bm = idx2.lookup(ni, make_data_view(a));
+  CHECK_EQUAL(to_string(unbox(bm)), "000011");
+}
+
+TEST(subnet containment) {
+  subnet_index idx{subnet_type{}};
+  for (auto x : {"0.0.0.0/0", "10.0.0.0/8", "10.1.0.0/16", "10.1.2.0/23",
+                 "10.1.3.7/32", "::/0", "2001:db8::/32", "10.2.0.0/16"})
+    REQUIRE(idx.append(make_data_view(unbox(to<subnet>(x)))));
+  auto contains = [&](auto x) {
+    auto result = idx.lookup(ni, make_data_view(unbox(to<data>(x))));
+    return to_string(unbox(result));
+  };
+  CHECK_EQUAL(contains("10.1.3.7"), "11111000");
+  CHECK_EQUAL(contains("10.1.3.8"), "11110000");
+  CHECK_EQUAL(contains("10.1.4.1"), "11100000");
+  CHECK_EQUAL(contains("10.2.0.1"), "11000001");
+  CHECK_EQUAL(contains("192.168.0.1"), "10000000");
+  CHECK_EQUAL(contains("2001:db8::1"), "00000110");
+  CHECK_EQUAL(contains("2001:db9::1"), "00000100");
+  CHECK_EQUAL(contains("10.1.2.0/24"), "11110000");
+  CHECK_EQUAL(contains("10.0.0.0/7"), "10000000");
+  auto result = idx.lookup(not_ni, make_data_view(unbox(to<data>("10.1.4.1"))));
+  CHECK_EQUAL(to_string(unbox(result)), "00011111");
 }
 
 TEST(port) {
@@ -489,6 +513,44 @@ TEST(set) {
   CHECK_EQUAL(to_string(*idx2->lookup(ni, make_data_view(42))), "1001");
 }
 
+TEST(membership) {
+  auto t = vector_type{string_type{}}.attributes({{"index", "membership"}});
+  auto idx = factory<value_index>::make(t, caf::settings{});
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  REQUIRE(dynamic_cast<membership_index*>(idx.get()) != nullptr);
+  MESSAGE("append");
+  vector xs{"foo", "bar", "foo"};
+  REQUIRE(idx->append(make_data_view(xs)));
+  xs = {"qux", "foo", "baz", "corge"};
+  REQUIRE(idx->append(make_data_view(xs)));
+  xs = {};
+  REQUIRE(idx->append(make_data_view(xs)));
+  REQUIRE(idx->append(make_data_view(caf::none)));
+  xs = {"bar"};
+  REQUIRE(idx->append(make_data_view(xs), 6));
+  MESSAGE("lookup");
+  auto x = "foo"s;
+  CHECK_EQUAL(to_string(*idx->lookup(ni, make_data_view(x))), "1100000");
+  CHECK_EQUAL(to_string(*idx->lookup(not_ni, make_data_view(x))), "0010001");
+  x = "bar";
+  CHECK_EQUAL(to_string(*idx->lookup(ni, make_data_view(x))), "1000001");
+  x = "corge";
+  CHECK_EQUAL(to_string(*idx->lookup(ni, make_data_view(x))), "0100000");
+  x = "not";
+  CHECK_EQUAL(to_string(*idx->lookup(ni, make_data_view(x))), "0000000");
+  CHECK_EQUAL(to_string(*idx->lookup(not_ni, make_data_view(x))), "1110001");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(nullptr, buf, idx), caf::none);
+  value_index_ptr idx2;
+  CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
+  REQUIRE_NOT_EQUAL(idx2, nullptr);
+  x = "foo";
+  CHECK_EQUAL(to_string(*idx2->lookup(ni, make_data_view(x))), "1100000");
+  x = "corge";
+  CHECK_EQUAL(to_string(*idx2->lookup(ni, make_data_view(x))), "0100000");
+}
+
 TEST(none values - string) {
   auto idx = factory<value_index>::make(string_type{}, caf::settings{});
   REQUIRE_NOT_EQUAL(idx, nullptr);
@@ -539,6 +601,47 @@ TEST(none values - arithmetic) {
   CHECK_EQUAL(to_string(unbox(bm)), "00100");
 }
 
+TEST(bulk set membership) {
+  address_index hosts{address_type{}};
+  string_index services{string_type{}};
+  vector host_set{*to<address>("::1"), *to<address>("10.0.0.254")};
+  set service_set{"foo", ""};
+  size_t row_id = 0;
+  for (auto& slice : zeek_full_conn_log_slices) {
+    for (size_t row = 0; row < slice->rows(); ++row, ++row_id) {
+      // Column 2 is orig_h and column 7 is service.
+      auto host = slice->at(row, 2);
+      auto service = slice->at(row, 7);
+      REQUIRE(hosts.append(host, row_id));
+      REQUIRE(services.append(service, row_id));
+      if (row_id % 7 == 0) {
+        host_set.push_back(materialize(host));
+        if (!caf::holds_alternative<caf::none_t>(service))
+          service_set.insert(materialize(service));
+      }
+    }
+  }
+  // The set lookup must yield the same IDs as individual equality lookups.
+  auto expected = [](auto& idx, auto& xs) {
+    ids result{idx.offset(), false};
+    for (auto& x : xs)
+      result |= unbox(idx.lookup(equal, make_data_view(x)));
+    return result;
+  };
+  MESSAGE("addresses");
+  auto result = unbox(hosts.lookup(in, make_data_view(host_set)));
+  auto expected_hosts = expected(hosts, host_set);
+  CHECK(result == expected_hosts);
+  result = unbox(hosts.lookup(not_in, make_data_view(host_set)));
+  CHECK(result == ~expected_hosts);
+  MESSAGE("strings");
+  result = unbox(services.lookup(in, make_data_view(service_set)));
+  auto expected_services = expected(services, service_set);
+  CHECK(result == expected_services);
+  result = unbox(services.lookup(not_in, make_data_view(service_set)));
+  CHECK(result == ~expected_services);
+}
+
 // This test uncovered a regression that ocurred when computing the rank of a
 // bitmap representing conn.log events. The culprit was the EWAH bitmap
 // encoding, because swapping out ewah_bitmap for null_bitmap in address_index
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE zone_map
+
+#include "vast/zone_map.hpp"
+
+#include "vast/test/test.hpp"
+
+#include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+#include "vast/concept/parseable/vast/expression.hpp"
+#include "vast/default_table_slice_builder.hpp"
+#include "vast/expression.hpp"
+#include "vast/table_slice.hpp"
+
+using namespace vast;
+using namespace std::string_literals;
+
+namespace {
+
+struct fixture {
+  fixture() {
+    layout = record_type{{"ts", time_type{}.attributes({{"timestamp"}})},
+                         {"n", count_type{}},
+                         {"addr", address_type{}},
+                         {"s", string_type{}}};
+    default_table_slice_builder builder{layout};
+    auto at = [](int secs) { return vast::time{std::chrono::seconds{secs}}; };
+    auto addr = [](const char* str) { return unbox(to<address>(str)); };
+    REQUIRE(builder.add(at(10), count{5}, addr("10.0.0.1"), "foo"s));
+    REQUIRE(builder.add(at(20), caf::none, addr("10.0.0.9"), "bar"s));
+    REQUIRE(builder.add(at(30), count{42}, addr("10.0.0.5"), "baz"s));
+    auto slice = builder.finish();
+    REQUIRE_NOT_EQUAL(slice, nullptr);
+    zones = zone_map::make(*slice);
+  }
+
+  bool lookup(std::string_view expr) {
+    return zones.lookup(unbox(to<expression>(expr)), layout);
+  }
+
+  record_type layout;
+  zone_map zones;
+};
+
+} // namespace <anonymous>
+
+FIXTURE_SCOPE(zone_map_tests, fixture)
+
+TEST(ranges) {
+  auto& xs = zones.ranges();
+  REQUIRE_EQUAL(xs.size(), 4u);
+  CHECK_EQUAL(xs[1].min, data{count{5}});
+  CHECK_EQUAL(xs[1].max, data{count{42}});
+  CHECK_EQUAL(xs[2].min, data{unbox(to<address>("10.0.0.1"))});
+  CHECK_EQUAL(xs[2].max, data{unbox(to<address>("10.0.0.9"))});
+  MESSAGE("strings have no range");
+  CHECK_EQUAL(xs[3].min, data{caf::none});
+}
+
+TEST(predicates) {
+  CHECK(lookup("n == 42"));
+  CHECK(!lookup("n == 43"));
+  CHECK(lookup("n < 6"));
+  CHECK(!lookup("n < 5"));
+  CHECK(lookup("n >= 42"));
+  CHECK(!lookup("n > 42"));
+  CHECK(lookup("n in {1, 2, 5}"));
+  CHECK(!lookup("n in {1, 2, 3}"));
+  CHECK(lookup("addr in 10.0.0.0/29"));
+  CHECK(!lookup("addr in 10.0.1.0/24"));
+  CHECK(lookup("addr in 10.0.0.8/31"));
+  CHECK(!lookup("#timestamp > 1970-01-01+00:00:30.0"));
+  CHECK(lookup("#timestamp > 1970-01-01+00:00:29.0"));
+  MESSAGE("unsupported columns and operators never rule out anything");
+  CHECK(lookup("s == \"qux\""));
+  CHECK(lookup("n != 5"));
+  CHECK(lookup("x.y == 1"));
+}
+
+TEST(connectives) {
+  CHECK(!lookup("n == 42 && addr == 10.0.0.2"));
+  CHECK(lookup("n == 42 && addr == 10.0.0.5"));
+  CHECK(lookup("n == 43 || addr == 10.0.0.5"));
+  CHECK(!lookup("n == 43 || addr == 10.0.1.5"));
+  CHECK(lookup("! (n == 43)"));
+}
+
+FIXTURE_SCOPE_END()
@@ -63,6 +63,10 @@ public:
 
   arrow_table_slice* copy() const override;
 
+  /// Shares the column buffers of this slice instead of copying any values.
+  vast::table_slice_ptr
+  copy_rows(size_type first_row, size_type num_rows) const override;
+
   caf::error serialize(caf::serializer& sink) const override;
 
   caf::error deserialize(caf::deserializer& source) override;
@@ -86,13 +86,13 @@ public:
 
   // -- properties -------------------------------------------------------------
 
-  vast::table_slice_ptr finish() override;
-
   size_t rows() const noexcept override;
 
   caf::atom_value implementation_id() const noexcept override;
 
 protected:
+  vast::table_slice_ptr finish_impl() override;
+
   bool add_impl(vast::data_view x) override;
 
 private:
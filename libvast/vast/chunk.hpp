@@ -131,7 +131,7 @@ public:
   /// @param length The length of the slice, beginning at *start*. If 0, the
   ///               slice ranges from *start* to the end of the chunk.
   /// @returns A new chunk over the subset.
-  /// @pre `start + length < size()`
+  /// @pre `start < size() && start + length <= size()`
   chunk_ptr slice(size_type start, size_type length = 0) const;
 
   /// Adds an additional step for deleting this chunk.
@@ -166,4 +166,26 @@ private:
   deleter_type deleter_;
 };
 
+/// Lets a deserializer share the bytes of the chunk it reads from. While the
+/// guard lives, every `chunk_ptr` that *source* deserializes becomes a slice of
+/// *chk* instead of a copy, and thereby keeps *chk* alive.
+/// @pre *source* is a `caf::binary_deserializer` that reads all of *chk*.
+class chunk_sharing_guard {
+public:
+  /// Starts sharing the bytes of *chk* with the chunks that *source* reads.
+  /// @param chk The chunk that *source* reads from.
+  /// @param source The deserializer that reads *chk*.
+  chunk_sharing_guard(chunk_ptr chk, caf::deserializer& source);
+
+  /// Restores the previous guard of the current thread, if any.
+  ~chunk_sharing_guard();
+
+  chunk_sharing_guard(const chunk_sharing_guard&) = delete;
+  chunk_sharing_guard& operator=(const chunk_sharing_guard&) = delete;
+
+private:
+  chunk_ptr previous_chunk_;
+  caf::deserializer* previous_source_;
+};
+
 } // namespace vast
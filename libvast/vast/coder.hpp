@@ -19,10 +19,15 @@
 #include <vector>
 #include <type_traits>
 
+#include <caf/binary_deserializer.hpp>
+#include <caf/binary_serializer.hpp>
 #include <caf/meta/load_callback.hpp>
 #include <caf/meta/save_callback.hpp>
 
 #include "vast/base.hpp"
+#include "vast/chunk.hpp"
+#include "vast/die.hpp"
+#include "vast/error.hpp"
 #include "vast/operator.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/operators.hpp"
@@ -174,21 +179,65 @@ public:
   }
 
   auto& storage() const {
+    materialize();
     return bitmaps_;
   }
 
   friend bool operator==(const vector_coder& x, const vector_coder& y) {
+    x.materialize();
+    y.materialize();
     return x.size_ == y.size_ && x.bitmaps_ == y.bitmaps_;
   }
 
+  /// The serialized form consists of a table of contents with the byte
+  /// offsets of all bitmaps, followed by a single buffer that holds the
+  /// serialized bitmaps back to back. Deserialization keeps each bitmap as a
+  /// slice of the buffer and defers decoding it until its first access. The
+  /// buffer itself is a slice of the input when deserializing under a
+  /// `chunk_sharing_guard`.
   template <class Inspector>
   friend auto inspect(Inspector& f, vector_coder& ec) {
-    return f(ec.size_, ec.bitmaps_);
+    if constexpr (Inspector::reads_state) {
+      std::vector<uint64_t> offsets;
+      auto buffer = ec.encode_bitmaps(offsets);
+      return f(ec.size_, offsets, buffer);
+    } else {
+      std::vector<uint64_t> offsets;
+      chunk_ptr buffer;
+      auto load = [&] { return ec.assign_encoded(offsets, buffer); };
+      return f(ec.size_, offsets, buffer, caf::meta::load_callback(load));
+    }
   }
 
 protected:
+  /// Decodes the bitmap at `index` if it exists only in serialized form.
+  void materialize(size_t index) const {
+    if (index >= encoded_.size() || encoded_[index] == nullptr)
+      return;
+    auto& x = encoded_[index];
+    caf::binary_deserializer source{nullptr, x->data(), x->size()};
+    if (auto err = source(bitmaps_[index]))
+      die("failed to decode bitmap of value index");
+    x = nullptr;
+  }
+
+  /// Decodes the bitmaps in `[first, last)` that exist only in serialized
+  /// form.
+  void materialize(size_t first, size_t last) const {
+    for (auto i = first; i < last; ++i)
+      materialize(i);
+  }
+
+  /// Decodes all bitmaps that exist only in serialized form.
+  void materialize() const {
+    materialize(0, encoded_.size());
+    encoded_.clear();
+  }
+
   void append(const vector_coder& other, bool bit) {
     VAST_ASSERT(bitmaps_.size() == other.bitmaps_.size());
+    materialize();
+    other.materialize();
     for (auto i = 0u; i < bitmaps_.size(); ++i) {
       bitmaps_[i].append_bits(bit, this->size() - bitmaps_[i].size());
       bitmaps_[i].append(other.bitmaps_[i]);
@@ -198,6 +247,48 @@ protected:
 
   size_type size_;
   mutable std::vector<Bitmap> bitmaps_;
+
+  /// Stores the serialized form of bitmaps that were not accessed since
+  /// deserialization. Either empty or of the same size as `bitmaps_`, with
+  /// `nullptr` for every decoded bitmap.
+  mutable std::vector<chunk_ptr> encoded_;
+
+private:
+  chunk_ptr encode_bitmaps(std::vector<uint64_t>& offsets) const {
+    std::vector<char> buffer;
+    offsets.reserve(bitmaps_.size() + 1);
+    for (size_t i = 0; i < bitmaps_.size(); ++i) {
+      offsets.push_back(buffer.size());
+      if (i < encoded_.size() && encoded_[i] != nullptr) {
+        // Bitmaps that we never touched keep their serialized form.
+        buffer.insert(buffer.end(), encoded_[i]->begin(), encoded_[i]->end());
+      } else {
+        caf::binary_serializer sink{nullptr, buffer};
+        if (auto err = sink(bitmaps_[i]))
+          die("failed to encode bitmap of value index");
+      }
+    }
+    offsets.push_back(buffer.size());
+    if (buffer.empty())
+      return nullptr;
+    return chunk::make(std::move(buffer));
+  }
+
+  caf::error assign_encoded(const std::vector<uint64_t>& offsets,
+                            const chunk_ptr& buffer) {
+    auto buffer_size = buffer != nullptr ? buffer->size() : 0;
+    if (offsets.empty() || offsets.front() != 0
+        || offsets.back() != buffer_size
+        || !std::is_sorted(offsets.begin(), offsets.end()))
+      return make_error(ec::format_error, "invalid bitmap offsets");
+    auto n = offsets.size() - 1;
+    bitmaps_.assign(n, Bitmap{});
+    encoded_.assign(n, nullptr);
+    for (size_t i = 0; i < n; ++i)
+      if (auto length = offsets[i + 1] - offsets[i]; length > 0)
+        encoded_[i] = buffer->slice(offsets[i], length);
+    return caf::none;
+  }
 };
 
 /// Encodes each value in its own bitmap.
@@ -213,6 +304,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
+    this->materialize(index);
     auto& result = this->bitmaps_[index];
     result.append_bits(false, this->size_ - result.size());
     return result;
@@ -243,12 +335,14 @@ public:
       case less: {
         if (x == 0)
           return Bitmap{this->size_, false};
+        this->materialize(0, x);
         auto f = this->bitmaps_.begin();
         auto result = nary_or(f, f + x);
         result.append_bits(false, this->size_ - result.size());
         return result;
       }
       case less_equal: {
+        this->materialize(0, x + 1);
         auto f = this->bitmaps_.begin();
         auto result = nary_or(f, f + x + 1);
         result.append_bits(false, this->size_ - result.size());
@@ -262,6 +356,7 @@ public:
         return result;
       }
       case greater_equal: {
+        this->materialize(x, this->bitmaps_.size());
         auto result = nary_or(this->bitmaps_.begin() + x, this->bitmaps_.end());
         result.append_bits(false, this->size_ - result.size());
         return result;
@@ -269,6 +364,7 @@ public:
       case greater: {
         if (x >= this->bitmaps_.size() - 1)
           return Bitmap{this->size_, false};
+        this->materialize(x + 1, this->bitmaps_.size());
         auto f = this->bitmaps_.begin();
         auto l = this->bitmaps_.end();
         auto result = nary_or(f + x + 1, l);
@@ -301,6 +397,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
+    this->materialize(index);
     auto& result = this->bitmaps_[index];
     result.append_bits(true, this->size_ - result.size());
     return result;
@@ -387,6 +484,7 @@ public:
   using super::super;
 
   bitmap_type& lazy_bitmap_at(size_t index) const {
+    this->materialize(index);
     auto& result = this->bitmaps_[index];
     result.append_bits(false, this->size_ - result.size());
     return result;
@@ -409,6 +507,11 @@ public:
 
   // RangeEval-Opt for the special case with uniform base 2.
   Bitmap decode(relational_operator op, value_type x) const {
+    // Decode only the bitslices that the lookup touches.
+    auto slice = [this](size_t i) -> const Bitmap& {
+      this->materialize(i);
+      return this->bitmaps_[i];
+    };
     switch (op) {
       default:
         break;
@@ -424,12 +527,12 @@ public:
         } else if (op == less || op == greater_equal) {
           --x;
         }
-        auto result = x & 1 ? Bitmap{this->size_, true} : this->bitmaps_[0];
+        auto result = x & 1 ? Bitmap{this->size_, true} : slice(0);
         for (auto i = 1u; i < this->bitmaps_.size(); ++i)
           if ((x >> i) & 1)
-            result |= this->bitmaps_[i];
+            result |= slice(i);
           else
-            result &= this->bitmaps_[i];
+            result &= slice(i);
         if (op == greater || op == greater_equal || op == not_equal)
           result.flip();
         return result;
@@ -438,7 +541,7 @@ public:
       case not_equal: {
         auto result = Bitmap{this->size_, true};
         for (auto i = 0u; i < this->bitmaps_.size(); ++i) {
-          auto& bm = this->bitmaps_[i];
+          auto& bm = slice(i);
           result &= (((x >> i) & 1) ? ~bm : bm);
         }
         if (op == not_equal)
@@ -453,7 +556,7 @@ public:
         auto result = Bitmap{this->size_, false};
         for (auto i = 0u; i < this->bitmaps_.size(); ++i)
           if (((x >> i) & 1) == 0)
-            result |= this->bitmaps_[i];
+            result |= slice(i);
         if (op == in)
           result.flip();
         return result;
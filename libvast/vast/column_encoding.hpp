@@ -0,0 +1,66 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <caf/expected.hpp>
+
+#include "vast/fwd.hpp"
+
+namespace vast {
+
+/// The encoding of a single column of a table slice in a columnar segment.
+enum class column_encoding : uint8_t {
+  plain,      ///< Serialized values.
+  delta,      ///< Variable-length deltas of consecutive values.
+  dictionary, ///< Distinct values plus bit-packed codes per row.
+  bitpacked,  ///< Values packed into as few bits as the largest one needs.
+};
+
+/// Selects the encoding for a column of a given type: delta encoding for
+/// integral and time values, dictionary encoding for strings, bit-packing for
+/// booleans and ports, and plain encoding for everything else.
+/// @param t The type of the column.
+/// @relates column_encoding
+column_encoding encoding_for(const type& t);
+
+/// Encodes a column of a table slice and appends the result to a buffer.
+/// Falls back to plain encoding if a value does not fit the encoding of the
+/// column type.
+/// @param buf The buffer to append to.
+/// @param slice The table slice to encode.
+/// @param col The column to encode.
+/// @returns the encoding of the appended column or an error if serializing
+///          the values failed.
+/// @pre `col < slice.columns()`
+/// @relates column_encoding
+caf::expected<column_encoding>
+encode_column(std::vector<char>& buf, const table_slice& slice, size_t col);
+
+/// Decodes a column that `encode_column` produced.
+/// @param buffer The beginning of the encoded column.
+/// @param size The number of bytes of the encoded column.
+/// @param t The type of the column.
+/// @param encoding The encoding of the column.
+/// @param rows The number of rows of the column.
+/// @returns one value per row or an error if the column is malformed.
+/// @relates column_encoding
+caf::expected<std::vector<data>>
+decode_column(const char* buffer, size_t size, const type& t,
+              column_encoding encoding, size_t rows);
+
+} // namespace vast
@@ -0,0 +1,115 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "vast/detail/byte_swap.hpp"
+#include "vast/detail/endian.hpp"
+
+namespace vast {
+namespace detail {
+
+/// Checks whether `Iterator` traverses a contiguous range of characters, which
+/// allows for reading multiple characters at once.
+template <class Iterator>
+constexpr bool is_contiguous_char_iterator_v
+  = std::is_same_v<Iterator, const char*> || std::is_same_v<Iterator, char*>
+    || std::is_same_v<Iterator, std::string::const_iterator>
+    || std::is_same_v<Iterator, std::string::iterator>
+    || std::is_same_v<Iterator, std::vector<char>::const_iterator>
+    || std::is_same_v<Iterator, std::vector<char>::iterator>;
+
+/// Checks whether all 8 bytes of `x` are ASCII digits.
+inline bool is_eight_digits(uint64_t x) {
+  return (((x & 0xF0F0F0F0F0F0F0F0)
+           | (((x + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+          == 0x3333333333333333);
+}
+
+/// Converts 8 ASCII digits, loaded in little-endian order, to their value.
+/// @pre `is_eight_digits(x)`
+inline uint64_t parse_eight_digits(uint64_t x) {
+  constexpr uint64_t mask = 0x000000FF000000FF;
+  constexpr uint64_t mul1 = 0x000F424000000064; // 100 + (1000000 << 32)
+  constexpr uint64_t mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+  x -= 0x3030303030303030;
+  x = (x * 10) + (x >> 8);
+  return (((x & mask) * mul1) + (((x >> 16) & mask) * mul2)) >> 32;
+}
+
+/// Accumulates up to `max_digits` decimal digits into `x`, such that the
+/// result equals repeatedly computing `x = x * 10 + digit` modulo 2^64.
+/// Contiguous input gets consumed 8 digits at a time.
+/// @param f The beginning of the input.
+/// @param l The end of the input.
+/// @param x The value to accumulate into.
+/// @param max_digits The maximum number of digits to consume.
+/// @returns The number of consumed digits.
+template <class Iterator>
+int accumulate_digits(Iterator& f, const Iterator& l, uint64_t& x,
+                      int max_digits) {
+  int digits = 0;
+  if constexpr (is_contiguous_char_iterator_v<Iterator>) {
+    while (max_digits - digits >= 8 && l - f >= 8) {
+      uint64_t chunk;
+      std::memcpy(&chunk, &*f, sizeof(chunk));
+      chunk = swap<host_endian, little_endian>(chunk);
+      if (!is_eight_digits(chunk))
+        break;
+      x = x * 100000000 + parse_eight_digits(chunk);
+      f += 8;
+      digits += 8;
+    }
+  }
+  for (; digits < max_digits && f != l && *f >= '0' && *f <= '9';
+       ++f, ++digits)
+    x = x * 10 + static_cast<uint64_t>(*f - '0');
+  return digits;
+}
+
+/// Parses a dotted-quad IPv4 address with 1-3 digits per octet, without
+/// consuming input on failure.
+/// @param f The beginning of the input.
+/// @param l The end of the input.
+/// @param bytes The destination for the 4 octets in network byte order.
+/// @returns `true` on success.
+template <class Iterator>
+bool parse_ipv4(Iterator& f, const Iterator& l, uint8_t* bytes) {
+  auto i = f;
+  for (int octet = 0; octet < 4; ++octet) {
+    if (octet > 0) {
+      if (i == l || *i != '.')
+        return false;
+      ++i;
+    }
+    unsigned value = 0;
+    int digits = 0;
+    for (; digits < 3 && i != l && *i >= '0' && *i <= '9'; ++i, ++digits)
+      value = value * 10 + static_cast<unsigned>(*i - '0');
+    if (digits == 0 || value > 255)
+      return false;
+    bytes[octet] = static_cast<uint8_t>(value);
+  }
+  f = i;
+  return true;
+}
+
+} // namespace detail
+} // namespace vast
@@ -13,9 +13,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <type_traits>
 
 #include "vast/concept/parseable/core/parser.hpp"
+#include "vast/concept/parseable/detail/fast_path.hpp"
 
 namespace vast {
 namespace detail {
@@ -68,10 +71,30 @@ struct integral_parser
 
   template <class Iterator, class Attribute>
   static auto parse_pos(Iterator& f, const Iterator& l, Attribute& a) {
-    return accumulate(f, l, a, [](auto& n, auto x) {
-      n *= Radix;
-      n += x;
-    });
+    if constexpr (std::is_arithmetic_v<Attribute>
+                  && !std::is_same_v<Attribute, bool>) {
+      // Fast path: accumulate in a 64-bit integer, which yields the same
+      // result as the generic loop below. Floating point attributes are exact
+      // only up to 15 digits, after which we continue digit by digit.
+      if (f == l)
+        return false;
+      constexpr int fast_digits
+        = std::is_floating_point_v<Attribute> ? std::min(MaxDigits, 15)
+                                              : MaxDigits;
+      uint64_t x = 0;
+      auto digits = detail::accumulate_digits(f, l, x, fast_digits);
+      a = static_cast<Attribute>(x);
+      for (; digits < MaxDigits && f != l && isdigit(*f); ++f, ++digits) {
+        a *= Radix;
+        a += *f - '0';
+      }
+      return digits >= MinDigits;
+    } else {
+      return accumulate(f, l, a, [](auto& n, auto x) {
+        n *= Radix;
+        n += x;
+      });
+    }
   }
 
   template <class Iterator>
@@ -23,6 +23,7 @@
 #include "vast/detail/assert.hpp"
 
 #include "vast/concept/parseable/core.hpp"
+#include "vast/concept/parseable/detail/fast_path.hpp"
 #include "vast/concept/parseable/numeric/integral.hpp"
 #include "vast/concept/parseable/string/char_class.hpp"
 
@@ -123,9 +124,10 @@ struct access::parser<address> : vast::parser<access::parser<address>> {
 
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, address& a) const {
-    static auto const v4 = address_parser::make_v4();
+    // Hand-written IPv4 parser that accepts exactly the inputs of
+    // `address_parser::make_v4`, but avoids the combinator overhead.
     auto begin = f;
-    if (v4(f, l, a.bytes_[12], a.bytes_[13], a.bytes_[14], a.bytes_[15])) {
+    if (detail::parse_ipv4(f, l, &a.bytes_[12])) {
       std::copy(address::v4_mapped_prefix.begin(),
                 address::v4_mapped_prefix.end(), a.bytes_.begin());
       return true;
@@ -42,10 +42,21 @@ public:
   static table_slice_ptr make(record_type layout,
                               const std::vector<vector>& rows);
 
+  /// Constructs a slice from values in column-major order without checking
+  /// their types.
+  /// @param header The header of the slice.
+  /// @param columns One vector with `header.rows` values per layout field.
+  /// @pre The values in `columns` conform to the types of `header.layout`.
+  static table_slice_ptr make(table_slice_header header,
+                              std::vector<vector> columns);
+
   // -- factory functions ------------------------------------------------------
 
   default_table_slice* copy() const final;
 
+  table_slice_ptr copy_rows(size_type first_row,
+                            size_type num_rows) const override;
+
   // -- persistence ------------------------------------------------------------
 
   caf::error serialize(caf::serializer& sink) const final;
@@ -42,8 +42,6 @@ public:
 
   bool append(data x);
 
-  table_slice_ptr finish() override;
-
   size_t rows() const noexcept override;
 
   void reserve(size_t num_rows) override;
@@ -53,8 +51,15 @@ public:
 protected:
   // -- utility functions ------------------------------------------------------
 
+  table_slice_ptr finish_impl() override;
+
   bool add_impl(data_view x) override;
 
+  bool add_owned_impl(data&& x) override;
+
+  bool add_rows_impl(const table_slice& xs, size_t first_row,
+                     size_t num_rows) override;
+
   /// Allocates `slice_` and resets related state if necessary.
   void lazy_init();
 
@@ -63,6 +68,11 @@ protected:
   std::vector<data> row_;
   size_t col_;
   std::unique_ptr<default_table_slice> slice_;
+
+  /// The number of rows of the previously finished slice. Readers produce
+  /// slices of the same size in a row, so we allocate the row storage of the
+  /// next slice for that many rows up front instead of growing it row by row.
+  size_t last_rows_ = 0;
 };
 
 } // namespace vast
@@ -44,6 +44,13 @@ caf::atom_value table_slice_type(const caf::actor_system& sys,
 /// Maximum number of results.
 constexpr size_t max_events = 0;
 
+/// Number of parser threads for line-based formats, where 0 disables parallel
+/// parsing.
+constexpr size_t parallel = 0;
+
+/// Number of records that a parser thread processes at once.
+constexpr size_t parallel_chunk_size = 16'384;
+
 /// Contains settings for the zeek subcommand.
 struct zeek {
   /// Nested category in config files for this subcommand.
@@ -187,6 +194,16 @@ constexpr std::string_view read = "-";
 /// Maximum number of results.
 constexpr size_t max_events = 0;
 
+/// Number of threads for rendering results, or 0 to render on the sink.
+constexpr size_t parallel = 0;
+
+/// Maximum size of cached query results in MiB, or 0 for no limit.
+constexpr size_t max_buffer = 0;
+
+/// Maximum number of partitions that a query evaluates at once, or 0 for no
+/// limit beyond the scheduling defaults of INDEX and EXPORTER.
+constexpr size_t max_partitions = 0;
+
 /// Contains settings for the zeek subcommand.
 struct zeek {
   /// Nested category in config files for this subcommand.
@@ -326,9 +343,41 @@ constexpr caf::atom_value table_slice_type = caf::atom("default");
 /// Maximum size for sources that generate table slices.
 constexpr size_t table_slice_size = 100;
 
+/// Time within which sources should fill a table slice, where zero always
+/// fills slices up to the table slice size.
+constexpr std::chrono::nanoseconds latency_target
+  = std::chrono::nanoseconds::zero();
+
+/// Lower bound for the table slice size when targeting a latency.
+constexpr size_t min_table_slice_size = 16;
+
 /// Maximum number of events per INDEX partition.
 constexpr size_t max_partition_size = 1'048'576; // 1_Mi
 
+/// Width of the event-time buckets for routing slices to INDEX partitions,
+/// where zero routes slices in arrival order.
+constexpr std::chrono::nanoseconds partition_time_window
+  = std::chrono::nanoseconds::zero();
+
+/// Maximum number of concurrently open INDEX partitions when routing slices
+/// by event time.
+constexpr size_t max_open_partitions = 8;
+
+/// Placement of late slices when routing by event time (evict|nearest).
+constexpr caf::atom_value late_data_policy = caf::atom("evict");
+
+/// Number of threads that help the INDEX scan the meta index, where zero
+/// scans on the INDEX actor only.
+constexpr size_t meta_index_threads = 0;
+
+/// Number of threads that read INDEX partitions from disk in the background,
+/// where zero reads partitions on demand on the INDEX actor.
+constexpr size_t loader_threads = 4;
+
+/// Number of INDEX partitions to read ahead of the partitions that a query
+/// evaluates next.
+constexpr size_t readahead_partitions = 5;
+
 /// Maximum number of in-memory INDEX partitions.
 constexpr size_t max_in_mem_partitions = 10;
 
@@ -344,6 +393,24 @@ constexpr size_t segments = 10;
 /// Maximum size of ARCHIVE segments in MB.
 constexpr size_t max_segment_size = 128;
 
+/// Interval between ARCHIVE compaction rounds, where zero disables compaction.
+constexpr std::chrono::milliseconds compaction_interval
+  = std::chrono::minutes{10};
+
+/// Size of ARCHIVE segments in MB below which they qualify for merging.
+constexpr size_t compaction_threshold = 16;
+
+/// Maximum number of merged ARCHIVE segments per compaction round.
+constexpr size_t compaction_max_merges = 4;
+
+/// Age after which the node erases events, where zero keeps events forever.
+constexpr std::chrono::nanoseconds retention_period
+  = std::chrono::nanoseconds::zero();
+
+/// Interval between applications of the retention period.
+constexpr std::chrono::milliseconds retention_interval
+  = std::chrono::hours{1};
+
 /// Number of initial IDs to request in the IMPORTER.
 constexpr size_t initially_requested_ids = 128;
 
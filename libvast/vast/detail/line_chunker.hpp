@@ -0,0 +1,65 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+namespace vast::detail {
+
+/// Splits line-based input into chunks of whole records that can be parsed
+/// independently of each other. Every chunk begins with the header that is
+/// active at its first record, so that a fresh reader can parse it.
+class line_chunker {
+public:
+  /// Describes the header structure of a line-based format.
+  struct policy {
+    /// The number of lines at the beginning of the input that form a header,
+    /// e.g., the column names of a CSV file.
+    size_t header_lines = 0;
+
+    /// Lines starting with this prefix begin a new header block that replaces
+    /// the previous one, e.g., `#separator` for Zeek logs.
+    std::string header_marker;
+
+    /// Lines starting with this prefix extend a header block that they
+    /// immediately follow, and get dropped elsewhere, e.g., `#` for Zeek logs.
+    std::string comment_prefix;
+  };
+
+  line_chunker(std::istream& input, policy p);
+
+  /// Extracts the next chunk with up to `max_records` records.
+  /// @returns the active header followed by the records, or an empty string
+  ///          if the input is exhausted.
+  /// @pre `max_records > 0`
+  std::string next(size_t max_records);
+
+  /// @returns whether the input is exhausted.
+  bool done() const;
+
+private:
+  bool get_line();
+
+  std::istream& input_;
+  policy policy_;
+  std::string header_;
+  std::string line_;
+  size_t line_number_ = 0;
+  bool pending_ = false;
+  bool in_header_ = false;
+};
+
+} // namespace vast::detail
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/time.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace vast::detail {
+
+/// Adapts the size of table slices to the event rate of a source, such that
+/// a slice fills up within a target latency. High-rate sources get large
+/// slices for throughput, and low-rate sources get small slices so that
+/// downstream consumers see events quickly.
+class slice_size_controller {
+public:
+  /// Summarizes the slice latencies since the last call to `summarize`.
+  struct summary {
+    size_t samples = 0;
+    duration p50 = duration::zero();
+    duration p90 = duration::zero();
+    duration p99 = duration::zero();
+    duration max = duration::zero();
+  };
+
+  /// Constructs a controller.
+  /// @param target The desired time to fill a single slice.
+  /// @param min_size The lower bound for the slice size.
+  /// @param max_size The upper bound and initial value for the slice size.
+  /// @pre `target > duration::zero() && 0 < min_size && min_size <= max_size`
+  slice_size_controller(duration target, size_t min_size, size_t max_size);
+
+  /// @returns the slice size for the next read.
+  size_t slice_size() const noexcept {
+    return slice_size_;
+  }
+
+  /// @returns the target latency.
+  duration target() const noexcept {
+    return target_;
+  }
+
+  /// Updates the event rate estimate and the slice size after a read. Reads
+  /// without events extend the interval of the next read with events, so
+  /// that idle periods lower the estimate.
+  /// @param events The number of events that the read produced.
+  /// @param elapsed The wall-clock time since the previous read.
+  void observe(size_t events, duration elapsed);
+
+  /// Records the time from the first row entering a slice until its emission.
+  void record(duration latency);
+
+  /// Computes latency percentiles and resets the recorded samples.
+  summary summarize();
+
+private:
+  duration target_;
+  size_t min_size_;
+  size_t max_size_;
+  size_t slice_size_;
+  double rate_ = 0.0; // events per second
+  size_t pending_events_ = 0;
+  duration pending_time_ = duration::zero();
+  size_t num_samples_ = 0;
+  std::vector<duration> samples_;
+};
+
+} // namespace vast::detail
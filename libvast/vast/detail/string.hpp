@@ -151,6 +151,24 @@ std::vector<std::string_view> split(std::string_view str, std::string_view sep,
                                     size_t max_splits = -1,
                                     bool include_sep = false);
 
+/// Splits a character sequence into a given vector of substrings. Unlike the
+/// overload that returns a new vector, this one allows for reusing the storage
+/// of *result* across calls, e.g., once per line of input.
+/// @param result The vector to fill. Its previous contents get discarded.
+/// @param str The string to split.
+/// @param sep The seperator where to split.
+/// @param esc The escape string. If *esc* occurrs immediately in front of
+///            *sep*, then *sep* will not count as a separator.
+/// @param max_splits The maximum number of splits to perform.
+/// @param include_sep If `true`, also include the separator after each
+///                    match.
+/// @pre `!sep.empty()`
+/// @warning The lifetime of the substrings are bound to the lifetime of the
+/// string pointed to by `str`.
+void split(std::vector<std::string_view>& result, std::string_view str,
+           std::string_view sep, std::string_view esc = "",
+           size_t max_splits = -1, bool include_sep = false);
+
 /// Constructs a `std::vector<std::string>` from a ::split result.
 /// @param v The vector of iterator pairs from ::split.
 /// @returns a vector of strings with the split elements.
@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vast::detail {
+
+/// A fixed-size pool of worker threads that execute jobs in FIFO order. The
+/// pool is meant for CPU-bound work that would otherwise block an actor, e.g.,
+/// parsing or rendering, and does not replace CAF's scheduler.
+class thread_pool {
+public:
+  /// Spawns `num_threads` worker threads.
+  /// @pre `num_threads > 0`
+  explicit thread_pool(size_t num_threads);
+
+  thread_pool(const thread_pool&) = delete;
+
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /// Runs all pending jobs and joins the worker threads.
+  ~thread_pool();
+
+  /// Enqueues a job for execution on one of the worker threads.
+  void post(std::function<void()> job);
+
+  /// Enqueues `f` and returns a future for its result.
+  template <class F>
+  auto async(F f) -> std::future<std::invoke_result_t<F>> {
+    using result_type = std::invoke_result_t<F>;
+    // std::function requires copyable targets, hence the shared_ptr.
+    auto task = std::make_shared<std::packaged_task<result_type()>>(
+      std::move(f));
+    auto result = task->get_future();
+    post([task] { (*task)(); });
+    return result;
+  }
+
+  /// @returns the number of worker threads.
+  size_t size() const noexcept {
+    return workers_.size();
+  }
+
+private:
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> workers_;
+  bool stopping_ = false;
+};
+
+} // namespace vast::detail
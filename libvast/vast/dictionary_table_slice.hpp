@@ -0,0 +1,117 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <caf/atom.hpp>
+
+#include "vast/aliases.hpp"
+#include "vast/data.hpp"
+#include "vast/fwd.hpp"
+#include "vast/table_slice.hpp"
+
+namespace vast {
+
+/// A table slice that stores its values column by column and dictionary-encodes
+/// string columns with few distinct values. An encoded column stores every
+/// distinct string once and refers to it with a fixed-size code per row, which
+/// shrinks low-cardinality columns such as protocols, services, or connection
+/// states.
+class dictionary_table_slice : public table_slice {
+public:
+  // -- friends ----------------------------------------------------------------
+
+  friend class dictionary_table_slice_builder;
+
+  // -- member types -----------------------------------------------------------
+
+  /// The type for referring to an entry in a dictionary.
+  using code_type = uint32_t;
+
+  /// The values of a single column.
+  struct column_data {
+    /// Indicates whether the column uses dictionary encoding.
+    bool encoded = false;
+
+    /// Holds one value per row for plain columns.
+    std::vector<data> values;
+
+    /// Holds the distinct values of an encoded column in insertion order.
+    std::vector<std::string> dictionary;
+
+    /// Holds one position in `dictionary` per row for encoded columns.
+    std::vector<code_type> codes;
+
+    template <class Inspector>
+    friend auto inspect(Inspector& f, column_data& x) {
+      return f(x.encoded, x.values, x.dictionary, x.codes);
+    }
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  static constexpr caf::atom_value class_id = caf::atom("dictionary");
+
+  /// The code for null values in an encoded column.
+  static constexpr code_type null_code = std::numeric_limits<code_type>::max();
+
+  // -- static factory functions -----------------------------------------------
+
+  static table_slice_ptr make(table_slice_header header);
+
+  // -- factory functions ------------------------------------------------------
+
+  dictionary_table_slice* copy() const final;
+
+  table_slice_ptr copy_rows(size_type first_row,
+                            size_type num_rows) const override;
+
+  // -- persistence ------------------------------------------------------------
+
+  caf::error serialize(caf::serializer& sink) const final;
+
+  caf::error deserialize(caf::deserializer& source) final;
+
+  // -- visitation -------------------------------------------------------------
+
+  /// Applies all values in column `col` to `idx`.
+  void append_column_to_index(size_type col, value_index& idx) const final;
+
+  // -- properties -------------------------------------------------------------
+
+  data_view at(size_type row, size_type col) const final;
+
+  caf::atom_value implementation_id() const noexcept override;
+
+  /// @returns the container for storing table slice columns.
+  const std::vector<column_data>& container() const noexcept {
+    return columns_;
+  }
+
+protected:
+  explicit dictionary_table_slice(table_slice_header header);
+
+private:
+  std::vector<column_data> columns_;
+};
+
+/// @relates dictionary_table_slice
+using dictionary_table_slice_ptr
+  = caf::intrusive_cow_ptr<dictionary_table_slice>;
+
+} // namespace vast
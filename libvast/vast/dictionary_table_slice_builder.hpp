@@ -0,0 +1,84 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "vast/dictionary_table_slice.hpp"
+#include "vast/table_slice_builder.hpp"
+
+namespace vast {
+
+/// Builds a `dictionary_table_slice` and assigns dictionary codes to the
+/// values of string columns.
+class dictionary_table_slice_builder : public table_slice_builder {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using super = table_slice_builder;
+
+  using code_type = dictionary_table_slice::code_type;
+
+  // -- constants --------------------------------------------------------------
+
+  /// String columns with more distinct values than this fraction of their rows
+  /// fall back to plain encoding, because a dictionary would not save space.
+  static constexpr double max_distinct_ratio = 0.5;
+
+  // -- class properties -------------------------------------------------------
+
+  static caf::atom_value get_implementation_id() noexcept;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  dictionary_table_slice_builder(record_type layout);
+
+  // -- factory functions ------------------------------------------------------
+
+  static table_slice_builder_ptr make(record_type layout);
+
+  // -- properties -------------------------------------------------------------
+
+  size_t rows() const noexcept override;
+
+  void reserve(size_t num_rows) override;
+
+  caf::atom_value implementation_id() const noexcept override;
+
+protected:
+  // -- utility functions ------------------------------------------------------
+
+  table_slice_ptr finish_impl() override;
+
+  bool add_impl(data_view x) override;
+
+  /// Allocates `slice_` and resets related state if necessary.
+  void lazy_init();
+
+  // -- member variables -------------------------------------------------------
+
+  size_t col_;
+  size_t rows_;
+
+  /// Maps the dictionary entries of each encoded column to their codes.
+  std::vector<std::map<std::string, code_type, std::less<>>> codes_;
+
+  std::unique_ptr<dictionary_table_slice> slice_;
+};
+
+} // namespace vast
@@ -74,6 +74,8 @@ enum class ec : uint8_t {
   unimplemented,
   /// An error that shall print nothing in the render function.
   silent,
+  /// A query exceeded one of its resource limits.
+  budget_exceeded,
 };
 
 /// @relates ec
@@ -20,6 +20,7 @@
 #include "vast/concept/printable/vast/data.hpp"
 #include "vast/config.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/line_chunker.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/format/ostream_writer.hpp"
 #include "vast/format/single_layout_reader.hpp"
@@ -76,6 +77,9 @@ public:
 
   const char* name() const override;
 
+  /// @returns the header structure of CSV files for parallel parsing.
+  static detail::line_chunker::policy chunking_policy();
+
 protected:
   caf::error read_impl(size_t max_events, size_t max_slice_size,
                        consumer& f) override;
@@ -15,6 +15,7 @@
 
 #include "vast/concept/parseable/vast/json.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/line_chunker.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/error.hpp"
 #include "vast/event.hpp"
@@ -103,6 +104,10 @@ public:
 
   const char* name() const override;
 
+  /// @returns the header structure of line-delimited JSON for parallel
+  ///          parsing.
+  static detail::line_chunker::policy chunking_policy();
+
 protected:
   caf::error read_impl(size_t max_events, size_t max_slice_size,
                        consumer& f) override;
@@ -150,6 +155,12 @@ const char* reader<Selector>::name() const {
   return Selector::name();
 }
 
+template <class Selector>
+detail::line_chunker::policy reader<Selector>::chunking_policy() {
+  // Every line is a self-contained JSON object.
+  return {};
+}
+
 template <class Selector>
 caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
                                        consumer& cons) {
@@ -13,19 +13,27 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
+#include <future>
 #include <iosfwd>
 #include <memory>
 #include <string_view>
 #include <vector>
 
 #include <caf/error.hpp>
+#include <caf/expected.hpp>
+#include <caf/intrusive_ptr.hpp>
 
 #include "vast/detail/overload.hpp"
+#include "vast/detail/thread_pool.hpp"
 #include "vast/error.hpp"
 #include "vast/format/writer.hpp"
 #include "vast/policy/include_field_names.hpp"
 #include "vast/policy/omit_field_names.hpp"
 #include "vast/table_slice.hpp"
+#include "vast/type.hpp"
+#include "vast/view.hpp"
 
 namespace vast::format {
 
@@ -57,7 +65,17 @@ public:
   /// @pre `out_ != nullptr`
   std::ostream& out();
 
+  /// Renders subsequent table slices on `pool` instead of the calling
+  /// thread. The output remains in the order of the calls to `write`.
+  /// @param pool The worker threads for rendering, or `nullptr` to render
+  ///        sequentially.
+  void parallelize(std::shared_ptr<detail::thread_pool> pool) override;
+
 protected:
+  /// A function that renders a table slice into a buffer.
+  using renderer
+    = std::function<caf::error(std::vector<char>&, const table_slice&)>;
+
   /// Appends `x` to `buf_`.
   void append(std::string_view x) {
     buf_.insert(buf_.end(), x.begin(), x.end());
@@ -68,12 +86,13 @@ protected:
     buf_.emplace_back(x);
   }
 
-  /// Prints a table slice using the given VAST printer. This function assumes
-  /// a human-readable output where each row in the slice gets printed to a
-  /// single line.
+  /// Prints a table slice into a buffer using the given VAST printer. This
+  /// function assumes a human-readable output where each row in the slice
+  /// gets printed to a single line.
   /// @tparam Policy either ::include_field_names to repeat the field name for
   ///         each value (e.g., JSON output) or ::omit_field_names to print the
   ///         values only after an initial header (e.g., Zeek output).
+  /// @param buf The buffer to append the output to.
   /// @param printer The VAST printer for generating formatted output.
   /// @param xs The table slice for printing.
   /// @param begin_of_line Prefix for each printed line. For example, a JSON
@@ -85,41 +104,77 @@ protected:
   /// @returns `ec::print_error` if `printer` fails to generate output,
   ///          otherwise `caf::none`.
   template <class Policy, class Printer>
-  caf::error print(Printer& printer, const table_slice& xs,
-                   std::string_view begin_of_line, std::string_view separator,
-                   std::string_view end_of_line) {
+  static caf::error
+  render_slice(std::vector<char>& buf, Printer& printer, const table_slice& xs,
+               std::string_view begin_of_line, std::string_view separator,
+               std::string_view end_of_line) {
+    auto& fields = xs.layout().fields;
+    // Only enumerations differ in their canonical representation, so we
+    // look up the affected columns once instead of visiting every value.
+    std::vector<bool> enumerations(fields.size());
+    for (size_t column = 0; column < fields.size(); ++column)
+      enumerations[column]
+        = caf::holds_alternative<enumeration_type>(fields[column].type);
     auto print_field = [&](auto& iter, size_t row, size_t column) {
-      auto rep = [&](data_view x) {
-        if constexpr (std::is_same_v<Policy, policy::include_field_names>)
-          return std::pair{xs.column_name(column), x};
-        else if constexpr (std::is_same_v<Policy, policy::omit_field_names>)
-          return x;
-        else
-          static_assert(detail::always_false_v<Policy>,
-                        "Unsupported policy: Expected either "
-                        "include_field_names or omit_field_names");
-      };
-      auto x = to_canonical(xs.layout().fields[column].type,
-                            xs.at(row, column));
-      return printer.print(iter, rep(std::move(x)));
+      auto x = xs.at(row, column);
+      if (enumerations[column])
+        x = to_canonical(fields[column].type, x);
+      if constexpr (std::is_same_v<Policy, policy::include_field_names>)
+        return printer.print(iter, std::pair{xs.column_name(column), x});
+      else if constexpr (std::is_same_v<Policy, policy::omit_field_names>)
+        return printer.print(iter, std::move(x));
+      else
+        static_assert(detail::always_false_v<Policy>,
+                      "Unsupported policy: Expected either "
+                      "include_field_names or omit_field_names");
     };
-    auto iter = std::back_inserter(buf_);
+    auto put = [&](std::string_view x) {
+      buf.insert(buf.end(), x.begin(), x.end());
+    };
+    auto iter = std::back_inserter(buf);
     for (size_t row = 0; row < xs.rows(); ++row) {
-      append(begin_of_line);
+      put(begin_of_line);
       if (!print_field(iter, row, 0))
         return ec::print_error;
       for (size_t column = 1; column < xs.columns(); ++column) {
-        append(separator);
+        put(separator);
         if (!print_field(iter, row, column))
           return ec::print_error;
       }
-      append(end_of_line);
-      append('\n');
-      write_buf();
+      put(end_of_line);
+      buf.push_back('\n');
     }
     return caf::none;
   }
 
+  /// Prints a table slice using the given VAST printer, either directly or on
+  /// the thread pool. See `render_slice` for a description of the parameters.
+  template <class Policy, class Printer>
+  caf::error print(Printer& printer, const table_slice& xs,
+                   std::string_view begin_of_line, std::string_view separator,
+                   std::string_view end_of_line) {
+    return print(xs, [printer, bol = std::string{begin_of_line},
+                      sep = std::string{separator},
+                      eol = std::string{end_of_line}](
+                       std::vector<char>& buf,
+                       const table_slice& slice) mutable {
+      return render_slice<Policy>(buf, printer, slice, bol, sep, eol);
+    });
+  }
+
+  /// Renders a table slice with `f` and writes the result to `out_` after
+  /// all previously printed slices.
+  /// @param xs The table slice for printing.
+  /// @param f The function that renders *xs*.
+  /// @returns the error of `f` or of a previously rendered slice, if any.
+  caf::error print(const table_slice& xs, renderer f);
+
+  /// Writes `buf` to `out_` after all previously printed slices.
+  caf::error emit(std::vector<char> buf);
+
+  /// Waits for all pending slices and writes them to `out_`.
+  caf::error drain();
+
   /// Writes the content of `buf_` to `out_` and clears `buf_` afterwards.
   void write_buf();
 
@@ -131,6 +186,19 @@ protected:
 
   /// Output stream for writing to STDOUT or disk.
   ostream_ptr out_;
+
+private:
+  using pending_buffer = std::future<caf::expected<std::vector<char>>>;
+
+  /// Writes all rendered buffers at the front of `pending_` while more than
+  /// `max_pending` buffers are outstanding or the front is ready.
+  caf::error write_pending(size_t max_pending);
+
+  /// Optional workers for rendering table slices.
+  std::shared_ptr<detail::thread_pool> pool_;
+
+  /// Buffers in output order that are rendered on `pool_`.
+  std::deque<pending_buffer> pending_;
 };
 
 /// @relates ostream_writer
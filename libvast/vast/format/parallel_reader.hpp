@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/detail/line_chunker.hpp"
+#include "vast/detail/thread_pool.hpp"
+#include "vast/format/reader.hpp"
+#include "vast/schema.hpp"
+#include "vast/table_slice.hpp"
+
+#include <caf/error.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <istream>
+#include <memory>
+#include <vector>
+
+namespace vast::format {
+
+/// A reader that splits line-based input into chunks at record boundaries and
+/// parses the chunks concurrently on a pool of worker threads. Each chunk gets
+/// its own instance of the wrapped reader.
+class parallel_reader final : public reader {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Creates a reader for a single chunk of input.
+  using reader_factory
+    = std::function<std::unique_ptr<reader>(std::unique_ptr<std::istream>)>;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  /// Constructs a parallel reader.
+  /// @param table_slice_type The ID for table slice type to build.
+  /// @param in The stream of logs to read.
+  /// @param policy The header structure of the input format.
+  /// @param factory Creates the readers for individual chunks.
+  /// @param num_workers The number of parser threads.
+  /// @param chunk_size The number of records per chunk.
+  /// @param ordered Whether to produce slices in input order. When `false`,
+  ///                slices of different chunks may get reordered.
+  parallel_reader(caf::atom_value table_slice_type,
+                  std::unique_ptr<std::istream> in,
+                  detail::line_chunker::policy policy, reader_factory factory,
+                  size_t num_workers, size_t chunk_size, bool ordered = true);
+
+  parallel_reader(parallel_reader&&) = default;
+
+  ~parallel_reader() override;
+
+  // -- properties -------------------------------------------------------------
+
+  caf::error schema(vast::schema x) override;
+
+  vast::schema schema() const override;
+
+  const char* name() const override;
+
+protected:
+  caf::error read_impl(size_t max_events, size_t max_slice_size,
+                       consumer& f) override;
+
+private:
+  /// A parsed slice together with the time when its first row entered a
+  /// builder.
+  struct parsed_slice {
+    table_slice_ptr slice;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /// The outcome of parsing a single chunk.
+  struct chunk_result {
+    caf::error error;
+    std::vector<parsed_slice> slices;
+  };
+
+  /// Hands out chunks to the workers until reaching the in-flight limit.
+  void dispatch(size_t max_slice_size);
+
+  /// Waits for a parsed chunk and moves its slices into `ready_`.
+  void collect();
+
+  std::unique_ptr<std::istream> input_;
+  detail::line_chunker chunker_;
+  reader_factory factory_;
+  std::unique_ptr<reader> prototype_;
+  vast::schema schema_;
+  size_t chunk_size_;
+  bool ordered_;
+  caf::error error_;
+  std::deque<parsed_slice> ready_;
+  std::deque<std::future<chunk_result>> in_flight_;
+  std::unique_ptr<detail::thread_pool> workers_;
+};
+
+} // namespace vast::format
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "vast/address.hpp"
+#include "vast/community_id.hpp"
 #include "vast/concept/hashable/hash_append.hpp"
 #include "vast/concept/hashable/xxhash.hpp"
 #include "vast/defaults.hpp"
@@ -30,10 +31,16 @@
 #include <caf/expected.hpp>
 #include <caf/optional.hpp>
 
+#include <array>
 #include <chrono>
+#include <deque>
 #include <pcap.h>
-#include <random>
-#include <unordered_map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <tsl/robin_map.h>
 
 namespace vast {
 namespace format {
@@ -66,33 +73,83 @@ protected:
                        consumer& f) override;
 
 private:
+  /// The maximum length of a Base64-encoded community ID.
+  static constexpr size_t max_community_id_length
+    = community_id::max_length<policy::base64>();
+
+  static_assert(max_community_id_length <= 255);
+
   struct flow_state {
     uint64_t bytes;
     uint64_t last;
-    std::string community_id;
+    uint8_t community_id_length;
+    std::array<char, max_community_id_length> community_id_data;
+
+    std::string_view community_id() const {
+      return {community_id_data.data(), community_id_length};
+    }
   };
 
-  /// @returns either an existing state associated to `x` or a new state for
-  ///          the flow.
-  flow_state& state(const flow& x);
+  /// Packets captured with a single call to `pcap_dispatch`. Because libpcap
+  /// may reuse its buffer between callbacks, the callback decodes each packet
+  /// right away and keeps only its layer 3 bytes, which then move into the
+  /// table slice without another copy.
+  struct packet_batch {
+    // Captured packets.
+    std::vector<time> timestamps;
+    std::vector<uint64_t> seconds;
+    // Decoded headers, where an empty layer 3 marks packets to skip.
+    std::vector<flow> flows;
+    std::vector<uint64_t> payload_sizes;
+    std::vector<std::string> layer3;
+
+    size_t size() const {
+      return timestamps.size();
+    }
+
+    void clear();
+  };
+
+  /// Appends a packet to the batch of a reader. This is the callback for
+  /// `pcap_dispatch`.
+  static void capture(u_char* self, const pcap_pkthdr* header,
+                      const u_char* data);
 
-  /// @returns whether `true` if the flow remains active, `false` if the flow
-  ///          reached the configured cutoff.
-  bool update_flow(const flow& x, uint64_t packet_time, uint64_t payload_size);
+  /// Decodes the headers of the last packet in the current batch.
+  /// @param data The captured bytes of the packet.
+  /// @param size The number of captured bytes.
+  /// @returns an error if the packet is malformed.
+  caf::error decode(const u_char* data, size_t size);
+
+  /// Retrieves or creates the state of a flow and accounts for a packet.
+  /// @returns the state of the flow, or `nullptr` if the flow reached the
+  ///          configured cutoff.
+  flow_state* update_flow(const flow& x, uint64_t packet_time,
+                          uint64_t payload_size);
 
   /// Evict all flows that have been inactive for the maximum age.
   void evict_inactive(uint64_t packet_time);
 
-  /// Evicts random flows when exceeding the maximum configured flow count.
+  /// Evicts the least recently active flows when exceeding the maximum
+  /// configured flow count.
   void shrink_to_max_size();
 
+  /// Schedules the next inactivity check of `x`.
+  /// @param x The flow to check.
+  /// @param last The time of the last packet of *x*.
+  void reschedule(const flow& x, uint64_t last);
+
   pcap_t* pcap_ = nullptr;
-  std::unordered_map<flow, flow_state> flows_;
+  packet_batch batch_;
+  tsl::robin_map<flow, flow_state> flows_;
+  /// Schedules each flow for an inactivity check, grouped by the second of
+  /// scheduling and ordered by time. Activity does not touch this queue; the
+  /// check reschedules a flow that was active in the meantime.
+  std::deque<std::pair<uint64_t, std::vector<flow>>> timeouts_;
   std::string input_;
   caf::optional<std::string> interface_;
   uint64_t cutoff_;
   size_t max_flows_;
-  std::mt19937 generator_;
   uint64_t max_age_;
   uint64_t expire_interval_;
   uint64_t last_expire_ = 0;
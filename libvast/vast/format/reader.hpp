@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <string_view>
 
@@ -99,11 +100,21 @@ public:
   /// @returns The name of the reader type.
   virtual const char* name() const = 0;
 
+  /// @returns the time when the first row of the most recently produced slice
+  ///          entered its builder.
+  std::chrono::steady_clock::time_point last_slice_start() const noexcept {
+    return last_slice_start_;
+  }
+
 protected:
   virtual caf::error read_impl(size_t max_events, size_t max_slice_size,
                                consumer& f) = 0;
 
   caf::atom_value table_slice_type_;
+
+  /// Stores the value of `last_slice_start()`. Readers update it before
+  /// handing a slice to the consumer.
+  std::chrono::steady_clock::time_point last_slice_start_;
 };
 
 } // namespace vast::format
@@ -13,12 +13,21 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <caf/expected.hpp>
+#include <caf/fwd.hpp>
 
 #include "vast/fwd.hpp"
 
+namespace vast::detail {
+
+class thread_pool;
+
+} // namespace vast::detail
+
 namespace vast::format {
 
 /// The base class for writers.
@@ -36,8 +45,21 @@ public:
   /// The default implementation does nothing.
   virtual caf::expected<void> flush();
 
+  /// Allows the writer to render table slices on a pool of worker threads.
+  /// @param pool The worker threads, or `nullptr` to disable parallelism.
+  /// The default implementation does nothing.
+  virtual void parallelize(std::shared_ptr<detail::thread_pool> pool);
+
   /// @returns The name of the writer type.
   virtual const char* name() const = 0;
 };
 
+/// Hands a pool of rendering threads to `x` if `options` set a positive
+/// `<category>.parallel`.
+/// @param x The writer to parallelize.
+/// @param options The options of the sink.
+/// @param category The option category of the sink.
+void parallelize(writer& x, const caf::settings& options,
+                 const std::string& category);
+
 } // namespace vast::format
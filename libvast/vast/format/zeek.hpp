@@ -20,6 +20,7 @@
 #include "vast/concept/parseable/vast/subnet.hpp"
 #include "vast/data.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/line_chunker.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/filesystem.hpp"
@@ -252,6 +253,9 @@ public:
 
   const char* name() const override;
 
+  /// @returns the header structure of Zeek logs for parallel parsing.
+  static detail::line_chunker::policy chunking_policy();
+
 protected:
   caf::error read_impl(size_t max_events, size_t max_slice_size,
                        consumer& f) override;
@@ -275,6 +279,8 @@ private:
   caf::optional<size_t> proto_field_;
   std::vector<size_t> port_fields_;
   std::vector<rule<iterator_type, data>> parsers_;
+  std::vector<std::string_view> fields_;
+  std::vector<data> values_;
 };
 
 /// A Zeek writer.
@@ -298,11 +304,14 @@ public:
 
   caf::expected<void> flush() override;
 
+  void parallelize(std::shared_ptr<detail::thread_pool> pool) override;
+
   const char* name() const override;
 
 private:
   path dir_;
   type previous_layout_;
+  std::shared_ptr<detail::thread_pool> pool_;
 
   /// One writer for each layout.
   std::unordered_map<std::string, ostream_writer_ptr> writers_;
@@ -39,6 +39,7 @@ class meta_index;
 class path;
 class pattern;
 class port;
+class projection_cache;
 class schema;
 class segment;
 class segment_builder;
@@ -213,14 +213,15 @@ private:
     }
     if (op == in || op == not_in) {
       // Ensure that the RHS is a list of strings.
+      using key_set = std::unordered_set<key, key_hasher>;
       auto keys = caf::visit(
-        detail::overload([&](auto xs) -> caf::expected<std::vector<key>> {
+        detail::overload([&](auto xs) -> caf::expected<key_set> {
           using view_type = decltype(xs);
           if constexpr (detail::is_any_v<view_type, view<set>, view<vector>>) {
-            std::vector<key> result;
+            key_set result;
             result.reserve(xs.size());
             for (auto x : xs)
-              result.emplace_back(find_digest(x));
+              result.emplace(find_digest(x));
             return result;
           } else {
             return make_error(ec::type_clash, "expected set or vector on RHS",
@@ -231,13 +232,13 @@ private:
       if (!keys)
         return keys.error();
       // We're good to go with: create the set predicates an run the scan.
+      // Probing a hash set keeps the scan linear in the number of digests,
+      // regardless of the size of the RHS.
       auto in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::any_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) > 0;
       };
       auto not_in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::none_of(keys->begin(), keys->end(), cmp);
+        return keys->count(key{digest}) == 0;
       };
       return op == in ? scan(in_pred) : scan(not_in_pred);
     }
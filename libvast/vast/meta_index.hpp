@@ -13,15 +13,19 @@
 
 #pragma once
 
+#include "vast/detail/thread_pool.hpp"
 #include "vast/fwd.hpp"
 #include "vast/synopsis.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/fwd.hpp>
 #include <caf/settings.hpp>
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -45,10 +49,36 @@ public:
   /// @returns A vector of UUIDs representing candidate partitions.
   std::vector<uuid> lookup(const expression& expr) const;
 
+  /// Retrieves the list of partition IDs whose events all precede a given
+  /// point in time, according to the synopses of fields with the `timestamp`
+  /// attribute. Unlike `lookup`, this never returns false positives: a
+  /// partition with a layout that lacks a timestamp synopsis never qualifies.
+  /// @param cutoff The point in time to compare against.
+  /// @returns A sorted vector of UUIDs representing the partitions.
+  std::vector<uuid> lookup_older_than(time cutoff) const;
+
+  /// Retrieves an upper bound for the event timestamps in a partition,
+  /// according to the synopses of fields with the `timestamp` attribute.
+  /// Events of layouts without such a field do not have a timestamp and do not
+  /// contribute to the bound.
+  /// @param partition The partition ID.
+  /// @returns the latest event timestamp in *partition*, or `time::max()` if
+  ///          the synopses cannot bound the timestamps of the partition.
+  time max_timestamp(const uuid& partition) const;
+
+  /// Removes all synopses of a partition.
+  /// @param partition The partition ID to remove.
+  void erase(const uuid& partition);
+
   /// Gets the options for the synopsis factory.
   /// @returns A reference to the synopsis options.
   caf::settings& factory_options();
 
+  /// Splits large scans over time synopses into jobs for a thread pool. The
+  /// calling thread takes part in each scan and blocks until all jobs finish.
+  /// @param pool The thread pool, or `nullptr` to scan on the calling thread.
+  void parallelize(std::shared_ptr<detail::thread_pool> pool);
+
   // -- concepts ---------------------------------------------------------------
 
   friend caf::error inspect(caf::serializer&, const meta_index&);
@@ -75,6 +105,44 @@ private:
   /// Contains synopses per table layout.
   using partition_synopsis = std::unordered_map<record_type, table_synopsis>;
 
+  /// The synopses of one field across all partitions with a given layout.
+  struct column {
+    /// The synopsis per row, or `nullptr` if the row has none.
+    std::vector<synopsis_ptr> synopses;
+
+    /// The time bounds per row in nanoseconds since the epoch. Only valid if
+    /// `has_ranges` is true, i.e., if all rows have a time synopsis.
+    std::vector<int64_t> mins;
+    std::vector<int64_t> maxs;
+
+    /// Whether `mins` and `maxs` mirror the synopses.
+    bool has_ranges = true;
+  };
+
+  /// The synopses of a layout across all partitions, stored column by
+  /// column. This is a copy of `partition_synopses_` that we never persist.
+  struct layout_columns {
+    /// The partitions with events of the layout, one per row.
+    std::vector<uuid> partitions;
+
+    /// Maps a partition to its row.
+    std::unordered_map<uuid, size_t> rows;
+
+    /// One column per field of the layout.
+    std::vector<column> columns;
+  };
+
+  /// Adds or refreshes the row of a partition in the columns of a layout.
+  void update_columns(const uuid& partition, const record_type& layout,
+                      const table_synopsis& table_syn);
+
+  /// Rebuilds `columns_` from `partition_synopses_`.
+  void rebuild_columns();
+
+  /// Marks the rows whose time bounds may satisfy `op` with `x`.
+  void scan(const column& col, relational_operator op, time x,
+            std::vector<uint8_t>& hits) const;
+
   /// Layouts for which we cannot generate a synopsis structure.
   std::unordered_set<record_type> blacklisted_layouts_;
 
@@ -83,6 +151,12 @@ private:
 
   /// The factory function to construct a synopsis structure for a type.
   caf::settings synopsis_options_;
+
+  /// Maps a layout to the columnar copy of its synopses.
+  std::unordered_map<record_type, layout_columns> columns_;
+
+  /// Runs large scans in parallel if set.
+  std::shared_ptr<detail::thread_pool> pool_;
 };
 
 } // namespace vast
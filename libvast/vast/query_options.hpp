@@ -21,7 +21,8 @@ namespace vast {
 enum class query_options : uint32_t {
   none = 0x00,
   historical = 0x01,
-  continuous = 0x02
+  continuous = 0x02,
+  ordered = 0x04
 };
 
 /// Concatenates two query options.
@@ -36,6 +37,10 @@ constexpr query_options historical = query_options::historical;
 constexpr query_options continuous = query_options::continuous;
 constexpr query_options unified = historical + continuous;
 
+/// Restricts a historical query to its most recent results, sorted by event
+/// timestamp.
+constexpr query_options ordered = query_options::ordered;
+
 constexpr bool has_query_option(query_options haystack, query_options needle) {
   return (static_cast<uint32_t>(haystack) & static_cast<uint32_t>(needle)) != 0;
 }
@@ -53,5 +58,9 @@ constexpr bool has_unified_option(query_options opts) {
          && has_query_option(opts, continuous);
 }
 
+constexpr bool has_ordered_option(query_options opts) {
+  return has_query_option(opts, ordered);
+}
+
 } // namespace vast
 
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <caf/expected.hpp>
@@ -24,10 +25,12 @@
 
 #include "vast/aliases.hpp"
 #include "vast/chunk.hpp"
+#include "vast/column_encoding.hpp"
 #include "vast/fwd.hpp"
 #include "vast/ids.hpp"
 #include "vast/segment_header.hpp"
 #include "vast/uuid.hpp"
+#include "vast/zone_map.hpp"
 
 namespace vast {
 
@@ -58,6 +61,12 @@ using segment_ptr = caf::intrusive_ptr<segment>;
 ///               .                                         . v
 ///               +-----------------------------------------+
 ///
+/// Since version 2, every table slice consists of its implementation ID and
+/// header, followed by one separately encoded buffer per column. The meta
+/// data holds a directory of these buffers, which allows for decoding only
+/// the columns that a lookup needs, and the zone map of every slice, which
+/// allows for skipping slices that cannot match a query. Version 1 segments
+/// store every table slice as a whole and remain readable.
 class segment : public caf::ref_counted {
   friend segment_builder;
 
@@ -68,7 +77,11 @@ public:
   static inline constexpr segment_magic_type magic = 0x2a547ea8;
 
   /// The current version of the segment format.
-  static inline constexpr segment_version_type version = 1;
+  static inline constexpr segment_version_type version = 2;
+
+  /// The first version of the segment format that stores slices column by
+  /// column.
+  static inline constexpr segment_version_type columnar_version = 2;
 
   /// Per-slice meta data.
   struct table_slice_synopsis {
@@ -78,9 +91,26 @@ public:
     uint64_t size;    ///< The number of rows in the slice.
   };
 
+  /// Per-column meta data of a slice.
+  struct column_synopsis {
+    int64_t start;            ///< The byte offset from the beginning of the
+                              ///< payload.
+    int64_t end;              ///< The byte offset to one past the end of the
+                              ///< column.
+    column_encoding encoding; ///< The encoding of the column.
+  };
+
   /// Meta data for a segment.
   struct meta_data {
     std::vector<table_slice_synopsis> slices;
+
+    /// The column directory of every slice. Empty for segments that store
+    /// slices as a whole.
+    std::vector<std::vector<column_synopsis>> columns;
+
+    /// The zone map of every slice. Empty for segments that store slices as a
+    /// whole.
+    std::vector<zone_map> zones;
   };
 
   /// Constructs a segment.
@@ -103,6 +133,32 @@ public:
   caf::expected<std::vector<table_slice_ptr>>
   lookup(const ids& xs) const;
 
+  /// Locates the table slices for a given set of IDs and decodes only the
+  /// columns that match the given fields.
+  /// @param xs The IDs to lookup.
+  /// @param fields The names of the fields to decode, or nothing to decode all
+  ///               columns. Uses the same matching as `project`.
+  /// @param expr The query that the slices must satisfy. Slices whose zone
+  ///             maps rule out *expr* do not get decoded.
+  /// @returns The table slices according to *xs*, leaving out slices without
+  ///          any matching column or without any row that may match *expr*.
+  caf::expected<std::vector<table_slice_ptr>>
+  lookup(const ids& xs, const std::vector<std::string>& fields,
+         const expression& expr) const;
+
+  /// Locates the table slices for a given set of IDs and decodes only the
+  /// columns that a projection keeps.
+  /// @param xs The IDs to lookup.
+  /// @param projection The projection of the slices, with an empty list of
+  ///                   fields to decode all columns. Remembers the resolved
+  ///                   columns across lookups.
+  /// @param expr The query that the slices must satisfy.
+  /// @returns The table slices according to *xs*, leaving out slices without
+  ///          any matching column or without any row that may match *expr*.
+  caf::expected<std::vector<table_slice_ptr>>
+  lookup(const ids& xs, projection_cache& projection,
+         const expression& expr) const;
+
   /// @returns the meta data for the segment.
   const auto& meta() const {
     return meta_;
@@ -119,7 +175,11 @@ private:
   segment() = default;
 
   caf::expected<table_slice_ptr>
-  make_slice(const table_slice_synopsis& slice) const;
+  make_slice(size_t index, projection_cache& projection,
+             const expression& expr) const;
+
+  /// Reads the meta data that follows the header in a serialized segment.
+  caf::error load_meta(caf::deserializer& source);
 
   meta_data meta_;
   chunk_ptr chunk_;
@@ -132,10 +192,16 @@ auto inspect(Inspector& f, segment::table_slice_synopsis& x) {
   return f(x.start, x.end, x.offset, x.size);
 }
 
+/// @relates segment::column_synopsis
+template <class Inspector>
+auto inspect(Inspector& f, segment::column_synopsis& x) {
+  return f(x.start, x.end, x.encoding);
+}
+
 /// @relates segment::meta_data
 template <class Inspector>
 auto inspect(Inspector& f, segment::meta_data& x) {
-  return f(x.slices);
+  return f(x.slices, x.columns, x.zones);
 }
 
 /// @relates segment::meta_data
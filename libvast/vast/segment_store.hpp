@@ -91,12 +91,27 @@ public:
 
   std::unique_ptr<store::lookup> extract(const ids& xs) const override;
 
+  std::unique_ptr<store::lookup>
+  extract(const ids& xs, const std::vector<std::string>& fields,
+          const expression& expr) const override;
+
   caf::error erase(const ids& xs) override;
 
   caf::expected<std::vector<table_slice_ptr>> get(const ids& xs) override;
 
   caf::error flush() override;
 
+  /// Merges runs of adjacent segments into segments of at most the maximum
+  /// segment size. The store first writes the merged segment, then updates
+  /// and persists its meta data, and finally removes the merged segments once
+  /// no lookup holds them any longer. Hence, a crash at any point leaves the
+  /// store consistent.
+  /// @param threshold The size in bytes below which a segment qualifies for
+  ///                  merging.
+  /// @param max_merges The maximum number of merged segments to produce.
+  /// @returns The number of segments that got merged away.
+  caf::expected<size_t> compact(uint64_t threshold, size_t max_merges) override;
+
   void inspect_status(caf::settings& dict) override;
 
 private:
@@ -104,6 +119,13 @@ private:
 
   caf::expected<segment_ptr> load_segment(uuid id) const;
 
+  /// Retrieves a segment from the cache or from disk without caching it.
+  caf::expected<segment_ptr> get_segment(const uuid& id) const;
+
+  /// Merges the given segments into a single new segment.
+  /// @pre `xs.size() > 1`
+  caf::error merge(const std::vector<uuid>& xs);
+
   /// Fills `candidates` with all segments that qualify for `selection`.
   caf::error select_segments(const ids& selection,
                              std::vector<uuid>& candidates) const;
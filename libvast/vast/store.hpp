@@ -17,6 +17,11 @@
 
 #include <caf/expected.hpp>
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "vast/fwd.hpp"
 
 namespace vast {
@@ -48,6 +53,21 @@ public:
   /// @relates lookup
   virtual std::unique_ptr<lookup> extract(const ids& xs) const = 0;
 
+  /// Starts an iterative extraction session that only needs some columns of
+  /// the events matching a query. The default implementation ignores `fields`
+  /// and `expr`, so callers still have to project and filter the resulting
+  /// slices.
+  /// @param xs The IDs for the events to retrieve.
+  /// @param fields The names of the fields to retrieve, or nothing to retrieve
+  ///               all fields.
+  /// @param expr The query of the extraction, which allows for skipping
+  ///             slices that cannot match.
+  /// @returns A pointer to lookup session.
+  /// @relates lookup
+  virtual std::unique_ptr<lookup>
+  extract(const ids& xs, const std::vector<std::string>& fields,
+          const expression& expr) const;
+
   /// Erases events from the store.
   /// @param xs The set of IDs to erase.
   /// @returns No error on success.
@@ -62,6 +82,14 @@ public:
   /// @returns No error on success.
   virtual caf::error flush() = 0;
 
+  /// Merges small units of persistent storage into larger ones. The default
+  /// implementation does nothing.
+  /// @param threshold The size in bytes below which a unit qualifies for
+  ///                  merging.
+  /// @param max_merges The maximum number of merged units to produce.
+  /// @returns The number of units that got merged away.
+  virtual caf::expected<size_t> compact(uint64_t threshold, size_t max_merges);
+
   /// Fills `dict` with implementation-specific status information.
   virtual void inspect_status(caf::settings& dict) = 0;
 };
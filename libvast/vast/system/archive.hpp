@@ -15,6 +15,7 @@
 
 #include <chrono>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -25,12 +26,14 @@
 #include <caf/typed_actor.hpp>
 #include <caf/typed_event_based_actor.hpp>
 
+#include "vast/expression.hpp"
 #include "vast/fwd.hpp"
 #include "vast/ids.hpp"
 #include "vast/store.hpp"
 #include "vast/system/accountant.hpp"
 #include "vast/system/atoms.hpp"
 #include "vast/system/instrumentation.hpp"
+#include "vast/time.hpp"
 
 namespace vast::system {
 
@@ -40,9 +43,13 @@ using archive_type = caf::typed_actor<
   caf::reacts_to<caf::stream<table_slice_ptr>>,
   caf::reacts_to<exporter_atom, caf::actor>,
   caf::replies_to<ids>::with<done_atom, caf::error>,
+  caf::replies_to<ids, time>::with<done_atom, caf::error>,
+  caf::replies_to<ids, time, std::vector<std::string>, expression>
+    ::with<done_atom, caf::error>,
   caf::replies_to<status_atom>::with<caf::dictionary<caf::config_value>>,
   caf::reacts_to<telemetry_atom>,
-  caf::reacts_to<erase_atom, ids>
+  caf::reacts_to<erase_atom, ids>,
+  caf::reacts_to<compact_atom>
 >;
 // clang-format on
 
@@ -54,10 +61,20 @@ struct archive_state {
   std::unordered_set<caf::actor_addr> active_exporters;
   vast::system::measurement measurement;
   accountant_type accountant;
+  /// Counts the events received since the last compaction round. Compaction
+  /// only runs when this counter is zero, i.e., it never competes with ingest.
+  uint64_t ingested_since_compaction = 0;
+  /// Counts the merges of the current compaction round.
+  size_t compaction_merges = 0;
   static inline const char* name = "archive";
 };
 
-/// Stores event batches and answers queries for ID sets.
+/// Stores event batches and answers queries for ID sets. A query may carry a
+/// deadline, after which the ARCHIVE stops extracting further segments and
+/// responds with `ec::budget_exceeded`, a list of fields, in which case the
+/// ARCHIVE ships only the matching columns of the selected rows, and the query
+/// expression, in which case the ARCHIVE skips table slices whose zone maps
+/// rule out the query.
 /// @param self The actor handle.
 /// @param dir The root directory of the archive.
 /// @param capacity The number of segments to cache in memory.
@@ -16,6 +16,7 @@
 #include <chrono>
 #include <deque>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "vast/aliases.hpp"
@@ -26,6 +27,7 @@
 
 #include "vast/system/accountant.hpp"
 #include "vast/system/archive.hpp"
+#include "vast/system/query_budget.hpp"
 #include "vast/system/query_status.hpp"
 
 namespace vast::system {
@@ -39,6 +41,14 @@ struct exporter_state {
 
   caf::settings status();
 
+  /// Checks whether the cached results exhaust the buffer budget.
+  bool exceeds_buffer_budget() const;
+
+  // -- mutators ---------------------------------------------------------------
+
+  /// Adds a slice to the cached results.
+  void cache(table_slice_ptr slice);
+
   // -- member variables -------------------------------------------------------
 
   /// Stores a handle to the ARCHIVE for fetching candidates.
@@ -60,12 +70,31 @@ struct exporter_state {
   /// Stores hits from the INDEX.
   ids hits;
 
+  /// Stores hits that await an ARCHIVE lookup until the cached results fall
+  /// below the buffer budget again.
+  ids deferred_hits;
+
   /// Caches tailored candidate checkers.
   std::unordered_map<type, expression> checkers;
 
   /// Caches results for the SINK.
   std::vector<table_slice_ptr> results;
 
+  /// Stores the approximate memory footprint of each slice in `results`. Only
+  /// tracked if the query has a buffer budget.
+  std::vector<size_t> result_sizes;
+
+  /// Stores the approximate memory footprint of all cached results.
+  size_t buffered_bytes = 0;
+
+  /// Caches the results of an ordered query until the query completes. Holds
+  /// at most the requested number of rows once pruned.
+  std::vector<table_slice_ptr> ordered_results;
+
+  /// Stores upper bounds for the event timestamps of the candidate partitions
+  /// of an ordered query, in the order in which the INDEX evaluates them.
+  std::vector<time> partition_bounds;
+
   /// Stores the time point for when this actor got started via 'run'.
   std::chrono::steady_clock::time_point start;
 
@@ -81,15 +110,39 @@ struct exporter_state {
 
   /// Stores the user-defined export query.
   expression expr;
+
+  /// Stores the resource limits of the query.
+  query_budget budget;
+
+  /// Stores the point in time when the query runs out of time.
+  time deadline = time::max();
+
+  /// Stores the fields to include in the results, or nothing to include all
+  /// fields.
+  std::vector<std::string> projection;
+
+  /// Stores the fields that the ARCHIVE ships: the projection plus all fields
+  /// that the candidate check needs. Empty if the ARCHIVE must ship entire
+  /// rows.
+  std::vector<std::string> archive_projection;
 };
 
 /// The EXPORTER receives index hits, looks up the corresponding events in the
 /// archive, and performs a candidate check to select the resulting stream of
-/// matching events.
+/// matching events. For ordered queries, the EXPORTER ranks the results by
+/// their event timestamp, ships the requested number of most recent results
+/// sorted by time, and stops the INDEX from evaluating partitions that only
+/// contain older events.
 /// @param self The actor handle.
-/// @param ast The AST of query.
-/// @param qos The query options.
+/// @param expr The AST of query.
+/// @param opts The query options.
+/// @param budget The resource limits of the query.
+/// @param projection The fields to include in the results. Result rows that
+///                   have none of these fields get dropped. An empty list
+///                   includes all fields.
 caf::behavior exporter(caf::stateful_actor<exporter_state>* self,
-                       expression expr, query_options opts);
+                       expression expr, query_options opts,
+                       query_budget budget,
+                       std::vector<std::string> projection);
 
 } // namespace vast::system
@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/expression.hpp"
+#include "vast/fwd.hpp"
+#include "vast/query_options.hpp"
+#include "vast/system/query_budget.hpp"
+#include "vast/system/query_status.hpp"
+#include "vast/system/tracker.hpp"
+
+#include <caf/actor.hpp>
+#include <caf/fwd.hpp>
+#include <caf/settings.hpp>
+#include <caf/stateful_actor.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vast::system {
+
+struct federated_exporter_state {
+  // -- constants --------------------------------------------------------------
+
+  static inline const char* name = "federated-exporter";
+
+  // -- properties -------------------------------------------------------------
+
+  caf::settings status();
+
+  // -- member variables -------------------------------------------------------
+
+  /// Stores a handle to the TRACKER for looking up the peered nodes.
+  tracker_type tracker;
+
+  /// Stores a handle to the SINK that processes results.
+  caf::actor sink;
+
+  /// Stores a handle to the STATISTICS_SUBSCRIBER that receives the final
+  /// query status.
+  caf::actor statistics_subscriber;
+
+  /// Maps the EXPORTER of every node that still takes part in the query to
+  /// the number of results that we requested from it but did not receive yet.
+  std::unordered_map<caf::actor, uint64_t> exporters;
+
+  /// Stores the number of nodes that took part in the query.
+  size_t nodes = 0;
+
+  /// Caches results for the SINK.
+  std::vector<table_slice_ptr> results;
+
+  /// Accumulates the progress of the query over all nodes.
+  query_status query;
+
+  /// Stores the user-defined export query.
+  expression expr;
+
+  /// Stores flags for the query.
+  query_options options;
+
+  /// Stores the resource limits for the query on each node.
+  query_budget budget;
+
+  /// Stores the fields to include in the results.
+  std::vector<std::string> projection;
+};
+
+/// The FEDERATED_EXPORTER runs a historical query on all peered nodes. It
+/// spawns one EXPORTER per node that has an INDEX and an ARCHIVE, merges their
+/// results into a single stream for the SINK, and enforces the requested
+/// number of results across all nodes by splitting the demand of the SINK
+/// among the nodes. Nodes whose meta index rules out the
+/// query drop out before touching their ARCHIVE.
+/// @param self The actor handle.
+/// @param tracker The TRACKER of the local node.
+/// @param expr The AST of query.
+/// @param opts The query options.
+/// @param budget The resource limits of the query on each node.
+/// @param projection The fields to include in the results.
+/// @pre `!has_continuous_option(opts)`
+caf::behavior
+federated_exporter(caf::stateful_actor<federated_exporter_state>* self,
+                   tracker_type tracker, expression expr, query_options opts,
+                   query_budget budget, std::vector<std::string> projection);
+
+} // namespace vast::system
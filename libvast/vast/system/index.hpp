@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <future>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -24,12 +27,15 @@
 #include "vast/system/accountant.hpp"
 #include "vast/system/indexer_stage_driver.hpp"
 #include "vast/system/partition.hpp"
+#include "vast/system/query_budget.hpp"
 #include "vast/system/query_supervisor.hpp"
 #include "vast/system/spawn_indexer.hpp"
+#include "vast/time.hpp"
 #include "vast/uuid.hpp"
 
 #include "vast/detail/flat_lru_cache.hpp"
 #include "vast/detail/flat_set.hpp"
+#include "vast/detail/thread_pool.hpp"
 
 namespace vast::system {
 
@@ -79,12 +85,43 @@ struct index_state {
 
     /// Unscheduled partitions.
     std::vector<uuid> partitions;
+
+    /// Resource limits of the query.
+    query_budget budget;
+
+    /// Point in time when the query runs out of time.
+    time deadline = time::max();
+
+    /// Schedules partitions strictly in the order of `partitions`.
+    bool ordered = false;
   };
 
+  /// Maps partition IDs to their persistent state, which the loader reads
+  /// ahead of the first access.
+  using prefetch_map
+    = std::unordered_map<uuid,
+                         std::future<caf::expected<partition::snapshot>>>;
+
   /// Stores evaluation metadata for pending partitions.
   using pending_query_map
     = caf::detail::unordered_flat_map<uuid, evaluation_map>;
 
+  /// Bookkeeping for a partition that receives the events of a single
+  /// event-time bucket.
+  struct time_bucket {
+    /// The partition that stores the events of the bucket.
+    partition_ptr part;
+
+    /// Active indexer count for the partition.
+    size_t indexers = 0;
+
+    /// Outbound paths to the INDEXER actors of the partition.
+    std::vector<caf::stream_slot> slots;
+  };
+
+  /// Maps the start of a time bucket to its open partition.
+  using time_bucket_map = std::map<time, time_bucket>;
+
   /// Accumulates statistics for a given layout.
   struct layout_statistics {
     uint64_t count; ///< Number of events indexed.
@@ -135,12 +172,31 @@ struct index_state {
   /// @pre `has_worker()`
   caf::actor next_worker();
 
+  /// Hands a query to the next idle worker and tracks the partitions it
+  /// evaluates until the worker becomes idle again.
+  /// @pre `has_worker()`
+  void dispatch(expression expr, query_map qm, caf::actor client,
+                time deadline);
+
+  /// Puts a worker back onto the idle workers stack and releases the
+  /// partitions of its last query.
+  void add_idle_worker(caf::actor worker);
+
   /// @returns various status metrics.
   caf::dictionary<caf::config_value> status() const;
 
   /// Creates a new partition owned by the INDEX (stored as `active`).
   void reset_active_partition();
 
+  /// Persists a partition that no longer receives data and keeps it in memory
+  /// until all of its INDEXER actors have persisted their state.
+  void retire_partition(partition_ptr part, size_t num_indexers);
+
+  /// @returns the start of the event-time bucket for `slice`, or `time::min()`
+  ///          if its layout has no field with the `timestamp` attribute.
+  /// @pre `partition_time_window > duration::zero()`
+  time time_bucket_of(const table_slice& slice) const;
+
   /// @returns a new partition with random ID.
   partition_ptr make_partition();
 
@@ -154,14 +210,35 @@ struct index_state {
   /// Decrements the indexer count for a partition.
   void decrement_indexer_count(uuid pid);
 
+  /// Drops all persisted partitions whose events precede `cutoff` according
+  /// to the meta index. Removes their directories, meta index entries, and
+  /// statistics as a whole. Keeps partitions that fail to load or that
+  /// running queries still evaluate, such that a later call can drop them.
+  /// @returns the IDs of all events in the dropped partitions.
+  ids erase_older_than(time cutoff);
+
   /// @returns the unpersisted partition matching `id` or `nullptr` if no
   ///          partition matches.
   partition* find_unpersisted(const uuid& id);
 
+  /// @returns the partition matching `id` that currently receives data, or
+  ///          `nullptr` if no partition matches.
+  partition* find_active(const uuid& id);
+
   /// Prepares a subset of partitions from the lookup_state for evaluation.
   pending_query_map
   build_query_map(lookup_state& lookup, uint32_t num_partitions);
 
+  /// Reads the next partitions of a lookup from disk in the background,
+  /// skipping all partitions that are in memory already.
+  /// @param lookup The lookup whose candidates to read ahead.
+  /// @param num_partitions The number of partitions to read ahead.
+  void prefetch(const lookup_state& lookup, size_t num_partitions);
+
+  /// Drops all pending lookups that exceeded their deadline. Protects against
+  /// clients that disappear without cancelling their query.
+  void drop_expired_lookups();
+
   /// Spawns one evaluator for each partition.
   /// @returns a query map for passing to INDEX workers over the spawned
   ///          EVALUATOR actors.
@@ -205,6 +282,12 @@ struct index_state {
   /// Caches idle workers.
   std::vector<caf::actor> idle_workers;
 
+  /// Maps busy workers to the partitions of the query they evaluate.
+  std::unordered_map<caf::actor, std::vector<uuid>> busy_workers;
+
+  /// Counts the busy workers per partition.
+  std::unordered_map<uuid, size_t> evaluating;
+
   /// Spawns an INDEXER actor. Default-initialized to `spawn_indexer`, but
   /// allows users to redirect to other implementations (primarily for unit
   /// testing).
@@ -216,9 +299,43 @@ struct index_state {
   /// Active indexer count for the current partition.
   size_t active_partition_indexers;
 
+  /// The width of the event-time buckets for routing slices to partitions, or
+  /// zero for routing slices in arrival order to the `active` partition.
+  duration partition_time_window = duration::zero();
+
+  /// The maximum number of concurrently open partitions when routing slices by
+  /// event time.
+  size_t max_open_partitions;
+
+  /// Decides where to put slices whose bucket precedes all open buckets when
+  /// reaching `max_open_partitions`: `evict` closes the oldest open partition
+  /// to make room for the late bucket, and `nearest` adds the slices to the
+  /// oldest open partition instead. Partitions never get merged, so `evict`
+  /// may leave small partitions behind.
+  caf::atom_value late_data_policy;
+
+  /// Open partitions when routing slices by event time.
+  time_bucket_map buckets;
+
+  /// The partition of the slices in the stream buffer when routing slices by
+  /// event time.
+  uuid routing_target = uuid::nil();
+
   /// Recently accessed partitions.
   partition_cache_type lru_partitions;
 
+  /// Reads partitions from disk in the background, or `nullptr` if the INDEX
+  /// reads all partitions on demand.
+  std::unique_ptr<detail::thread_pool> loader;
+
+  /// Partitions that the loader reads or has read, but that did not enter
+  /// `lru_partitions` yet.
+  prefetch_map prefetched;
+
+  /// The number of partitions to read ahead of the partitions that a query
+  /// evaluates next.
+  size_t readahead_partitions = 0;
+
   /// Stores partitions that are no longer active but have not persisted their
   /// state yet.
   std::vector<std::pair<partition_ptr, size_t>> unpersisted;
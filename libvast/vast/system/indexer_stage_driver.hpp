@@ -18,12 +18,24 @@
 
 #include "vast/fwd.hpp"
 #include "vast/system/fwd.hpp"
+#include "vast/type.hpp"
+#include "vast/uuid.hpp"
 
 namespace vast::system {
 
 /// @relates indexer_stage_driver
 /// Filter type for dispatching slices to INDEXER actors.
-using indexer_stage_filter = type;
+struct indexer_stage_filter {
+  /// The layout of the slices for the INDEXER.
+  type layout;
+
+  /// The partition that owns the INDEXER.
+  uuid partition;
+
+  /// Points to the partition that receives the currently buffered slices when
+  /// multiple partitions are open at the same time, or `nullptr` otherwise.
+  const uuid* target = nullptr;
+};
 
 /// @relates indexer_stage_driver
 /// Selects an INDEXER actor based on its filter.
@@ -76,6 +88,11 @@ public:
   }
 
 private:
+  // -- implementation details -------------------------------------------------
+
+  /// Dispatches slices to partitions by event time.
+  void process_by_time(downstream_type& out, batch_type& slices);
+
   // -- member variables -------------------------------------------------------
 
   /// State of the INDEX actor that owns this stage.
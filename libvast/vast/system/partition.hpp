@@ -14,6 +14,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <unordered_map>
 
 #include <caf/detail/unordered_flat_map.hpp>
 #include <caf/event_based_actor.hpp>
@@ -46,6 +48,16 @@ public:
     bool dirty = false;
   };
 
+  /// The persistent state of a partition, including the state of all of its
+  /// table indexers.
+  struct snapshot {
+    /// The layouts of the partition.
+    meta_data meta;
+
+    /// The persistent state of every table indexer by type digest.
+    std::unordered_map<std::string, table_indexer::snapshot> tables;
+  };
+
   // -- constructors, destructors, and assignment operators --------------------
 
   /// @param self The parent actor.
@@ -60,10 +72,22 @@ public:
 
   // -- persistence ------------------------------------------------------------
 
+  /// Reads the persistent state of a partition. Unlike `init`, this function
+  /// does not access the INDEX and is safe to call from any thread.
+  /// @param dir The base directory of the partition.
+  /// @param expr The query that needs the partition. Only the table indexers
+  ///             of layouts that *expr* resolves against get read; the others
+  ///             load on first access.
+  /// @returns the persistent state or an error if I/O operations fail.
+  static caf::expected<snapshot> read(const path& dir, const expression& expr);
+
   /// Materializes the partition layouts from disk.
   /// @returns an error if I/O operations fail.
   caf::error init();
 
+  /// Materializes the partition from previously read persistent state.
+  void init(snapshot x);
+
   /// Persists the partition layouts to disk.
   /// @returns an error if I/O operations fail.
   caf::error flush_to_disk();
@@ -147,6 +171,10 @@ private:
   /// Stores one table indexer per layout that in turn manages INDEXER actors.
   table_indexer_map table_indexers_;
 
+  /// Stores the persistent state of table indexers by type digest until the
+  /// first access to the table indexer.
+  std::unordered_map<std::string, table_indexer::snapshot> snapshots_;
+
   /// Remaining capacity in this partition.
   size_t capacity_;
 
@@ -0,0 +1,58 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/time.hpp"
+
+#include <caf/meta/type_name.hpp>
+
+#include <cstddef>
+
+namespace vast::system {
+
+/// Resource limits for a single query. A value of zero means unlimited.
+struct query_budget {
+  /// Maximum number of bytes of results that the EXPORTER caches before it
+  /// stops issuing further ARCHIVE lookups.
+  size_t max_buffered_bytes = 0;
+
+  /// Maximum number of partitions that the INDEX evaluates concurrently on
+  /// behalf of the query.
+  size_t max_partitions = 0;
+
+  /// Maximum wall-clock time until the query gets cancelled.
+  duration timeout = duration::zero();
+};
+
+/// Computes the point in time when a query that started at `start` runs out
+/// of time.
+/// @param budget The limits of the query.
+/// @param start The point in time when the query started.
+/// @returns `start + budget.timeout` or `time::max()` if the query has no
+///          timeout.
+/// @relates query_budget
+inline time deadline(const query_budget& budget, time start) {
+  if (budget.timeout <= duration::zero())
+    return time::max();
+  return start + budget.timeout;
+}
+
+/// @relates query_budget
+template <class Inspector>
+auto inspect(Inspector& f, query_budget& x) {
+  return f(caf::meta::type_name("query_budget"), x.max_buffered_bytes,
+           x.max_partitions, x.timeout);
+}
+
+} // namespace vast::system
@@ -26,8 +26,10 @@
 #include "vast/concept/parseable/vast/schema.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/make_io_stream.hpp"
+#include "vast/detail/type_traits.hpp"
 #include "vast/endpoint.hpp"
 #include "vast/error.hpp"
+#include "vast/format/parallel_reader.hpp"
 #include "vast/format/reader.hpp"
 #include "vast/logger.hpp"
 #include "vast/schema.hpp"
@@ -38,6 +40,10 @@
 
 namespace vast::system {
 
+/// Detects readers that can parse chunks of their input independently.
+template <class Reader>
+using chunking_policy_t = decltype(Reader::chunking_policy());
+
 /// Default implementation for import sub-commands. Compatible with Bro and MRT
 /// formats.
 /// @relates application
@@ -116,6 +122,35 @@ reader_command(const command::invocation& invocation, caf::actor_system& sys) {
     auto in = detail::make_input_stream(*file, uds);
     if (!in)
       return caf::make_message(std::move(in.error()));
+    auto parallel = get_or(options, "import.parallel",
+                           defaults::import::parallel);
+    if (parallel > 1) {
+      if constexpr (detail::is_detected_v<chunking_policy_t, Reader>) {
+        auto chunk_size = get_or(options, "import.chunk-size",
+                                 defaults::import::parallel_chunk_size);
+        auto ordered = !get_or(options, "import.unordered", false);
+        auto factory = [=](std::unique_ptr<std::istream> input) {
+          return std::make_unique<Reader>(slice_type, options,
+                                          std::move(input));
+        };
+        format::parallel_reader reader{slice_type,
+                                       std::move(*in),
+                                       Reader::chunking_policy(),
+                                       std::move(factory),
+                                       parallel,
+                                       chunk_size,
+                                       ordered};
+        if (schema)
+          reader.schema(*schema);
+        VAST_INFO(reader, "reads data from", *file, "with", parallel,
+                  "threads");
+        src = sys.spawn(source<format::parallel_reader>, std::move(reader),
+                        slice_size, max_events);
+        return source_command(invocation, sys, std::move(src));
+      } else {
+        VAST_WARNING_ANON(category, "does not support parallel parsing");
+      }
+    }
     Reader reader{slice_type, options, std::move(*in)};
     if (schema)
       reader.schema(*schema);
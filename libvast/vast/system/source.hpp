@@ -22,6 +22,7 @@
 #include "vast/default_table_slice_builder.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/slice_size_controller.hpp"
 #include "vast/error.hpp"
 #include "vast/event.hpp"
 #include "vast/expression.hpp"
@@ -45,6 +46,9 @@
 #include <caf/stateful_actor.hpp>
 #include <caf/stream_source.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
 #include <unordered_map>
 
 namespace vast::detail {
@@ -112,13 +116,20 @@ struct source_state {
   /// Stores whether `reader` is constructed.
   bool initialized;
 
+  /// Adapts the slice size to the event rate when targeting a latency.
+  std::optional<detail::slice_size_controller> slice_sizer;
+
+  /// The end of the previous read, from which `slice_sizer` measures the
+  /// wall-clock time of the next read.
+  std::optional<std::chrono::steady_clock::time_point> last_read;
+
   // -- utility functions ------------------------------------------------------
 
   /// Initializes the state.
   void init(Reader rd, caf::optional<size_t> max_events) {
     // Initialize members from given arguments.
-    name = reader.name();
     new (&reader) Reader(std::move(rd));
+    name = reader.name();
     remaining = std::move(max_events);
     initialized = true;
   }
@@ -143,6 +154,20 @@ struct source_state {
       if (accountant)
         self->send(accountant, std::move(r));
     }
+    if (slice_sizer) {
+      auto latency = slice_sizer->summarize();
+      if (latency.samples > 0 && accountant) {
+        auto key = std::string{name};
+        auto r = report{
+          {key + ".latency.p50", latency.p50},
+          {key + ".latency.p90", latency.p90},
+          {key + ".latency.p99", latency.p99},
+          {key + ".latency.max", latency.max},
+          {key + ".slice-size", uint64_t{slice_sizer->slice_size()}},
+        };
+        self->send(accountant, std::move(r));
+      }
+    }
   }
 };
 
@@ -159,6 +184,20 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
   namespace defs = defaults::system;
   // Initialize state.
   self->state.init(std::move(reader), std::move(max_events));
+  // Target a latency for filling slices if configured, treating the given
+  // slice size as upper bound.
+  auto& cfg = self->system().config();
+  auto latency_target = get_or(cfg, "system.latency-target",
+                               vast::duration{defs::latency_target});
+  if (latency_target > vast::duration::zero()) {
+    auto min_size = get_or(cfg, "system.min-table-slice-size",
+                           defs::min_table_slice_size);
+    min_size = std::clamp(min_size, size_t{1}, table_slice_size);
+    self->state.slice_sizer.emplace(latency_target, min_size,
+                                    table_slice_size);
+    VAST_DEBUG(self, "targets a latency of", to_string(latency_target),
+               "with slice sizes between", min_size, "and", table_slice_size);
+  }
   // Spin up the stream manager for the source.
   self->state.mgr = self->make_continuous_source(
     // init
@@ -171,13 +210,28 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
     [=](bool& done, downstream<table_slice_ptr>& out, size_t num) {
       auto& st = self->state;
       auto t = timer::start(st.measurement_);
+      auto slice_size = st.slice_sizer ? st.slice_sizer->slice_size()
+                                       : table_slice_size;
       // Extract events until the source has exhausted its input or until
       // we have completed a batch.
-      auto push_slice = [&](table_slice_ptr x) { out.push(std::move(x)); };
-      // We can produce up to num * table_slice_size events per run.
-      auto events = detail::opt_min(st.remaining, num * table_slice_size);
-      auto [err, produced] = st.reader.read(events, table_slice_size,
-                                            push_slice);
+      auto start = steady_clock::now();
+      auto push_slice = [&](table_slice_ptr x) {
+        // Measure from the first row entering the slice until its emission.
+        if (st.slice_sizer)
+          st.slice_sizer->record(steady_clock::now()
+                                 - st.reader.last_slice_start());
+        out.push(std::move(x));
+      };
+      // We can produce up to num * slice_size events per run.
+      auto events = detail::opt_min(st.remaining, num * slice_size);
+      auto [err, produced] = st.reader.read(events, slice_size, push_slice);
+      if (st.slice_sizer) {
+        // Estimate the event rate over the wall-clock time since the previous
+        // read, which includes the time the source spent idle.
+        auto now = steady_clock::now();
+        st.slice_sizer->observe(produced, now - st.last_read.value_or(start));
+        st.last_read = now;
+      }
       // TODO: If the source is unable to generate new events (returns 0),
       //       the source will stall and never be polled again. We should
       //       trigger CAF to poll the source after a predefined interval of
@@ -31,12 +31,24 @@
 #include "vast/system/fwd.hpp"
 #include "vast/system/instrumentation.hpp"
 #include "vast/type.hpp"
+#include "vast/zone_map.hpp"
 
 namespace vast::system {
 
 /// Wraps multiple INDEXER actors according to a layout and dispatches queries.
 class table_indexer {
 public:
+  // -- member types -----------------------------------------------------------
+
+  /// The persistent state of a table indexer.
+  struct snapshot {
+    /// The IDs of all rows in the table.
+    ids row_ids;
+
+    /// The zone map of every table slice in the table.
+    std::vector<zone_map> zone_maps;
+  };
+
   // -- destructor, constructors, assignment operators, and factory ------------
 
   ~table_indexer() noexcept;
@@ -51,11 +63,25 @@ public:
   static caf::expected<table_indexer> make(partition* parent,
                                            const record_type& layout);
 
+  /// Constructs a table indexer from previously read persistent state.
+  /// @pre `parent != nullptr`
+  static table_indexer make(partition* parent, const record_type& layout,
+                            snapshot x);
+
   // -- persistence ------------------------------------------------------------
 
+  /// Reads the persistent state of a table indexer. Unlike `init`, this
+  /// function does not access the INDEX and is safe to call from any thread.
+  /// @param dir The base directory of the table indexer.
+  /// @returns the persistent state, which is empty if *dir* has none.
+  static caf::expected<snapshot> read(const path& dir);
+
   /// Loads state from disk.
   caf::error init();
 
+  /// Adopts previously read persistent state.
+  void init(snapshot x);
+
   /// Persists all indexes to disk.
   caf::error flush_to_disk();
 
@@ -85,6 +111,15 @@ public:
     return row_ids_;
   }
 
+  /// @returns the path to the file for persisting `zone_maps_`.
+  path zone_maps_file() const;
+
+  /// Tests whether any table slice of this table may contain rows that match
+  /// an expression, according to the zone maps of the slices.
+  /// @param expr The expression to test.
+  /// @returns `false` if the zone maps rule out all slices.
+  bool may_match(const expression& expr) const;
+
   /// Spawns all currently unloaded INDEXER actors.
   void spawn_indexers();
 
@@ -166,6 +201,10 @@ private:
   /// Stores what IDs are present in this table.
   ids row_ids_;
 
+  /// Stores the zone map of every table slice in this table. Partitions that
+  /// predate zone maps have none.
+  std::vector<zone_map> zone_maps_;
+
   /// Stores what size row_ids_ had when we last flushed.
   size_t last_flush_size_;
 
@@ -23,6 +23,7 @@
 
 #include "vast/defaults.hpp"
 #include "vast/detail/make_io_stream.hpp"
+#include "vast/format/writer.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/sink.hpp"
 #include "vast/system/sink_command.hpp"
@@ -48,9 +49,11 @@ writer_command(const command::invocation& invocation, caf::actor_system& sys) {
     if (!out)
       return caf::make_message(out.error());
     Writer writer{std::move(*out)};
+    format::parallelize(writer, options, category);
     snk = sys.spawn(sink<Writer>, std::move(writer), max_events);
   } else {
     Writer writer;
+    format::parallelize(writer, options, category);
     snk = sys.spawn(sink<Writer>, std::move(writer), max_events);
   }
   return sink_command(invocation, sys, std::move(snk));
@@ -15,7 +15,9 @@
 
 #include <cstddef>
 #include <limits>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include <caf/allowed_unsafe_message_type.hpp>
@@ -113,6 +115,17 @@ public:
   /// Makes a copy of this slice.
   virtual table_slice* copy() const = 0;
 
+  /// Copies a range of rows into a new table slice of the same implementation
+  /// and layout. The default implementation goes through a builder;
+  /// implementations override it to copy rows or column buffers in bulk.
+  /// @param first_row The first row to copy.
+  /// @param num_rows The number of rows to copy.
+  /// @returns a table slice with the rows `[first_row, first_row + num_rows)`
+  ///          and the offset `offset() + first_row`, or `nullptr` on failure.
+  /// @pre `num_rows > 0 && first_row + num_rows <= rows()`
+  virtual table_slice_ptr copy_rows(size_type first_row,
+                                    size_type num_rows) const;
+
   // -- persistence ------------------------------------------------------------
 
   /// Saves the contents (excluding the layout!) of this slice to `sink`.
@@ -259,6 +272,50 @@ table_slice_ptr truncate(const table_slice_ptr& slice, size_t num_rows);
 std::pair<table_slice_ptr, table_slice_ptr> split(const table_slice_ptr& slice,
                                                   size_t partition_point);
 
+/// Selects the columns of `slice` that match any of the given field names. A
+/// field name matches a column if it is a suffix of the column name, just like
+/// for key extractors in queries.
+/// @param slice The input table slice.
+/// @param fields The names of the fields to keep.
+/// @returns `slice` if all columns match, `nullptr` if no column matches,
+///          otherwise a new table slice of the same implementation type with
+///          the matching columns in layout order.
+/// @pre `slice != nullptr`
+table_slice_ptr project(const table_slice_ptr& slice,
+                        const std::vector<std::string>& fields);
+
+/// Determines the columns of a layout that `project` keeps.
+/// @param layout The layout of a table slice.
+/// @param fields The names of the fields to keep.
+/// @returns the offsets of the matching columns in ascending order.
+std::vector<size_t> project_columns(const record_type& layout,
+                                    const std::vector<std::string>& fields);
+
+/// Projects table slices onto a fixed set of fields and resolves the matching
+/// columns only once per layout.
+class projection_cache {
+public:
+  /// Constructs a projection onto the given fields.
+  /// @param fields The names of the fields to keep.
+  explicit projection_cache(std::vector<std::string> fields);
+
+  /// @returns the names of the fields to keep.
+  const std::vector<std::string>& fields() const noexcept {
+    return fields_;
+  }
+
+  /// @returns the columns of `layout` that match the fields.
+  const std::vector<size_t>& columns(const record_type& layout);
+
+  /// Projects `slice` onto the fields.
+  /// @pre `slice != nullptr`
+  table_slice_ptr operator()(const table_slice_ptr& slice);
+
+private:
+  std::vector<std::string> fields_;
+  std::unordered_map<record_type, std::vector<size_t>> columns_;
+};
+
 /// @relates table_slice
 bool operator==(const table_slice& x, const table_slice& y);
 
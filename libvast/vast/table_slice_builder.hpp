@@ -19,7 +19,9 @@
 #include <caf/make_counted.hpp>
 #include <caf/ref_counted.hpp>
 
+#include <chrono>
 #include <type_traits>
+#include <utility>
 
 namespace vast {
 
@@ -44,6 +46,7 @@ public:
   /// @returns `true` on success.
   template <class T>
   [[nodiscard]] bool add(const T& x) {
+    track_first_value();
     if constexpr (std::is_same_v<std::decay_t<T>, data_view>) {
       return add_impl(x);
     } else {
@@ -51,6 +54,16 @@ public:
     }
   }
 
+  /// Adds data to the builder, which may take ownership of *x* instead of
+  /// copying it. Readers should prefer this overload for values that they
+  /// constructed for a single row anyway.
+  /// @param x The data to add.
+  /// @returns `true` on success.
+  [[nodiscard]] bool add(data&& x) {
+    track_first_value();
+    return add_owned_impl(std::move(x));
+  }
+
   /// Adds data to the builder.
   /// @param xs The data to add.
   /// @returns `true` on success.
@@ -59,12 +72,26 @@ public:
     return add(x0) && add(x1) && (add(xs) && ...);
   }
 
-  /// Constructs a table_slice from the currently accumulated state. After
-  /// calling this function, implementations must reset their internal state
-  /// such that subsequent calls to add will restart with a new table_slice.
+  /// Adds entire rows of a table slice with the same layout to the builder.
+  /// @param xs The table slice to copy from.
+  /// @param first_row The first row in *xs* to copy.
+  /// @param num_rows The number of rows to copy.
+  /// @returns `true` on success.
+  /// @pre `first_row + num_rows <= xs.rows()`
+  [[nodiscard]] bool
+  add_rows(const table_slice& xs, size_t first_row, size_t num_rows);
+
+  /// Constructs a table_slice from the currently accumulated state.
+  /// Subsequent calls to add restart with a new table_slice.
   /// @returns A table slice from the accumulated calls to add or `nullptr` on
   ///          failure.
-  virtual table_slice_ptr finish() = 0;
+  table_slice_ptr finish();
+
+  /// @returns the time when the current table slice received its first value.
+  /// @pre `rows() > 0`
+  std::chrono::steady_clock::time_point first_value_time() const noexcept {
+    return first_value_time_;
+  }
 
   /// @returns the current number of rows in the table slice.
   virtual size_t rows() const noexcept = 0;
@@ -87,13 +114,45 @@ public:
 protected:
   // -- utilities -------------------------------------------------------------
 
+  /// Constructs a table_slice from the currently accumulated state. After
+  /// calling this function, implementations must reset their internal state
+  /// such that subsequent calls to add will restart with a new table_slice.
+  /// @returns A table slice from the accumulated calls to add or `nullptr` on
+  ///          failure.
+  virtual table_slice_ptr finish_impl() = 0;
+
   /// Adds data to the builder.
   /// @param x The data to add.
   /// @returns `true` on success.
   virtual bool add_impl(data_view x) = 0;
 
+  /// Adds data that the builder may take ownership of. The default
+  /// implementation calls `add_impl` with a view of *x*.
+  /// @param x The data to add.
+  /// @returns `true` on success.
+  virtual bool add_owned_impl(data&& x);
+
+  /// Adds entire rows of a table slice with the same layout to the builder.
+  /// The default implementation adds all values individually.
+  /// @param xs The table slice to copy from.
+  /// @param first_row The first row in *xs* to copy.
+  /// @param num_rows The number of rows to copy.
+  /// @returns `true` on success.
+  virtual bool
+  add_rows_impl(const table_slice& xs, size_t first_row, size_t num_rows);
+
 private:
+  /// Remembers when a fresh table slice receives its first value.
+  void track_first_value() {
+    if (!has_values_) {
+      has_values_ = true;
+      first_value_time_ = std::chrono::steady_clock::now();
+    }
+  }
+
   record_type layout_;
+  bool has_values_ = false;
+  std::chrono::steady_clock::time_point first_value_time_;
 };
 
 /// @relates table_slice_builder
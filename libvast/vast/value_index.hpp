@@ -13,13 +13,18 @@
 
 #pragma once
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/bitmap_index.hpp"
+#include "vast/concept/hashable/uhash.hpp"
+#include "vast/concept/hashable/xxhash.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/base.hpp"
 #include "vast/concept/printable/vast/data.hpp"
 #include "vast/concept/printable/vast/operator.hpp"
+#include "vast/data.hpp"
 #include "vast/detail/assert.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/detail/radix_tree.hpp"
 #include "vast/die.hpp"
 #include "vast/error.hpp"
 #include "vast/ewah_bitmap.hpp"
@@ -36,7 +41,11 @@
 
 #include <algorithm>
 #include <memory>
+#include <string_view>
 #include <type_traits>
+#include <vector>
+
+#include <tsl/robin_map.h>
 
 namespace vast {
 
@@ -124,37 +133,32 @@ caf::error inspect(caf::deserializer& source, value_index_ptr& x);
 
 namespace detail {
 
+/// Combines the results of individual equality lookups into the result of
+/// a set membership lookup.
+/// @param offset The number of IDs in the index.
+/// @param op Either `in` or `not_in`.
+/// @param hits The results of the equality lookups.
+/// @returns The IDs matching *op* over the set.
+ids combine_hits(ids::size_type offset, relational_operator op,
+                 const std::vector<ids>& hits);
+
 template <class Index, class Sequence>
 caf::expected<ids>
 container_lookup_impl(const Index& idx, relational_operator op,
                       const Sequence& xs) {
-  ids result;
-  if (op == in) {
-    result = bitmap{idx.offset(), false};
-    for (auto x : xs) {
-      auto r = idx.lookup(equal, x);
-      if (r)
-        result |= *r;
-      else
-        return r;
-      if (all<1>(result)) // short-circuit
-        return result;
-    }
-  } else if (op == not_in) {
-    result = bitmap{idx.offset(), true};
-    for (auto x : xs) {
-      auto r = idx.lookup(equal, x);
-      if (r)
-        result -= *r;
-      else
-        return r;
-      if (all<0>(result)) // short-circuit
-        return result;
-    }
-  } else {
+  if (!(op == in || op == not_in))
     return make_error(ec::unsupported_operator, op);
+  // Collect the hits first and combine them with a single n-ary OR, which
+  // is considerably cheaper than growing the result one element at a time.
+  std::vector<ids> hits;
+  hits.reserve(xs.size());
+  for (auto x : xs) {
+    auto r = idx.lookup(equal, x);
+    if (!r)
+      return r;
+    hits.push_back(std::move(*r));
   }
-  return result;
+  return combine_hits(idx.offset(), op, hits);
 }
 
 template <class Index>
@@ -323,6 +327,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  /// Looks up a set of strings at once, sharing the work for common
+  /// prefixes between its elements.
+  caf::expected<ids>
+  lookup_set(relational_operator op, std::vector<std::string_view> xs) const;
+
   size_t max_length_;
   length_bitmap_index length_;
   std::vector<char_bitmap_index> chars_;
@@ -366,6 +375,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  /// Looks up a set of addresses at once, sharing the work for common
+  /// prefixes between its elements.
+  caf::expected<ids>
+  lookup_set(relational_operator op, const std::vector<address>& xs) const;
+
   std::array<byte_index, 16> bytes_;
   type_index v4_;
 };
@@ -389,6 +403,10 @@ private:
 
   address_index network_;
   prefix_index length_;
+
+  /// Maps the bits of each distinct subnet to the IDs where it occurs, such
+  /// that containment lookups only visit the subnets that actually exist.
+  detail::radix_tree<ids> prefixes_;
 };
 
 /// An index for ports.
@@ -450,4 +468,50 @@ private:
   vast::type value_type_;
 };
 
+/// An index for vectors and sets that maps every distinct element to the
+/// rows containing it. Unlike ::sequence_index, it ignores element positions,
+/// so its size grows with the total number of elements instead of the length
+/// of the longest sequence. Select it with the attribute `#index=membership`.
+class membership_index : public value_index {
+public:
+  /// Constructs a membership index.
+  /// @param t The sequence type.
+  /// @param opts Runtime context for index parameterization.
+  explicit membership_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  /// Hashes `data` and `data_view` identically to allow for heterogenous
+  /// lookups.
+  struct data_hash {
+    size_t operator()(const data& x) const {
+      return uhash<xxhash>{}(make_view(x));
+    }
+
+    size_t operator()(const data_view& x) const {
+      return uhash<xxhash>{}(x);
+    }
+  };
+
+  struct data_equal {
+    using is_transparent = void;
+
+    template <class L, class R>
+    bool operator()(const L& x, const R& y) const {
+      return x == y;
+    }
+  };
+
+  /// Maps each distinct element to the IDs of the sequences containing it.
+  tsl::robin_map<data, ids, data_hash, data_equal> postings_;
+};
+
 } // namespace vast
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "vast/data.hpp"
+#include "vast/fwd.hpp"
+
+namespace vast {
+
+/// The value ranges of the columns of a single table slice. A zone map tracks
+/// the minimum and maximum of every count, integer, time, duration, and
+/// address column, which allows for skipping slices that cannot contain any
+/// row matching a query. Like a synopsis, a zone map may produce false
+/// positives but never false negatives.
+class zone_map {
+public:
+  /// The smallest and largest value of a column. Both are nil for columns
+  /// without a tracked type or without any values.
+  struct range {
+    data min;
+    data max;
+  };
+
+  /// Computes the zone map of a table slice.
+  /// @param slice The table slice to summarize.
+  /// @returns the zone map of *slice*.
+  static zone_map make(const table_slice& slice);
+
+  /// Tests whether a table slice may contain rows that match an expression.
+  /// @param expr The expression to test.
+  /// @param layout The layout of the summarized table slice.
+  /// @returns `false` if no row of the summarized table slice can match
+  ///          *expr*, and `true` otherwise.
+  bool lookup(const expression& expr, const record_type& layout) const;
+
+  /// @returns the value ranges of all columns.
+  const std::vector<range>& ranges() const {
+    return ranges_;
+  }
+
+  template <class Inspector>
+  friend auto inspect(Inspector& f, zone_map& x) {
+    return f(x.ranges_);
+  }
+
+private:
+  bool lookup(const predicate& pred, const record_type& layout) const;
+
+  std::vector<range> ranges_;
+};
+
+/// @relates zone_map::range
+template <class Inspector>
+auto inspect(Inspector& f, zone_map::range& x) {
+  return f(x.min, x.max);
+}
+
+} // namespace vast
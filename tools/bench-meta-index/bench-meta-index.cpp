@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/default_table_slice_builder.hpp"
+#include "vast/detail/thread_pool.hpp"
+#include "vast/expression.hpp"
+#include "vast/factory.hpp"
+#include "vast/meta_index.hpp"
+#include "vast/synopsis_factory.hpp"
+#include "vast/system/atoms.hpp"
+#include "vast/table_slice.hpp"
+#include "vast/uuid.hpp"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using namespace vast;
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Every partition covers one minute of event time.
+constexpr auto partition_width = std::chrono::minutes{1};
+
+vast::time minute(size_t i) {
+  return vast::time{} + static_cast<int64_t>(i) * partition_width;
+}
+
+double elapsed_ms(clock_type::time_point start) {
+  std::chrono::duration<double, std::milli> result = clock_type::now() - start;
+  return result.count();
+}
+
+expression make_range_query(vast::time from, vast::time to) {
+  auto ts = attribute_extractor{system::timestamp_atom::value};
+  return conjunction{predicate{ts, greater_equal, vast::data{from}},
+                     predicate{ts, less_equal, vast::data{to}}};
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t partitions = 100'000;
+  size_t threads = 0;
+  size_t queries = 100;
+  auto r = caf::message_builder{argv + 1, argv + argc}.extract_opts({
+    {"partitions,n", "number of partitions in the meta index", partitions},
+    {"threads,t", "number of threads that help scanning", threads},
+    {"queries,q", "number of range queries to run", queries},
+  });
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext << endl;
+    return 0;
+  }
+  factory<synopsis>::initialize();
+  meta_index meta_idx;
+  if (threads > 0)
+    meta_idx.parallelize(std::make_shared<detail::thread_pool>(threads));
+  cerr << "adding " << partitions << " partitions" << endl;
+  auto layout = record_type{{"ts", time_type{}.attributes({{"timestamp"}})},
+                            {"n", count_type{}}}
+                  .name("bench");
+  auto start = clock_type::now();
+  for (size_t i = 0; i < partitions; ++i) {
+    auto builder = default_table_slice_builder::make(layout);
+    auto first = minute(i);
+    auto last = first + partition_width - std::chrono::seconds{1};
+    auto n = vast::count{i};
+    if (!(builder->add(make_data_view(first)) && builder->add(make_data_view(n))
+          && builder->add(make_data_view(last))
+          && builder->add(make_data_view(n)))) {
+      cerr << "failed to build table slice" << endl;
+      return 1;
+    }
+    meta_idx.add(uuid::random(), *builder->finish());
+  }
+  cerr << "added partitions in " << elapsed_ms(start) << " ms" << endl;
+  std::mt19937_64 gen{42};
+  std::uniform_int_distribution<size_t> dist{0, partitions - 1};
+  size_t candidates = 0;
+  start = clock_type::now();
+  for (size_t i = 0; i < queries; ++i) {
+    auto from = minute(dist(gen));
+    auto expr = make_range_query(from, from + 10 * partition_width);
+    candidates += meta_idx.lookup(expr).size();
+  }
+  auto total = elapsed_ms(start);
+  cout << "partitions: " << partitions << '\n'
+       << "threads: " << threads << '\n'
+       << "queries: " << queries << '\n'
+       << "candidates: " << candidates << '\n'
+       << "total: " << total << " ms\n"
+       << "per query: " << (queries > 0 ? total / queries : 0.0) << " ms"
+       << endl;
+  return 0;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <caf/message_builder.hpp>
+
+#include "vast/address.hpp"
+#include "vast/concept/parseable/core.hpp"
+#include "vast/concept/parseable/numeric.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using namespace vast;
+
+namespace {
+
+std::vector<std::string>
+random_strings(size_t n, std::string (*gen)(std::mt19937&)) {
+  std::mt19937 rng{42};
+  std::vector<std::string> result(n);
+  for (auto& x : result)
+    x = gen(rng);
+  return result;
+}
+
+template <class Parser, class Attribute>
+bool benchmark(const char* name, const std::vector<std::string>& xs,
+               const Parser& p, Attribute& x) {
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (auto& str : xs) {
+    if (!p(str, x)) {
+      cerr << "failed to parse " << name << ": " << str << endl;
+      return false;
+    }
+    bytes += str.size();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto secs = std::chrono::duration<double>(elapsed).count();
+  cout << name << ": " << xs.size() / secs << " values/s, "
+       << bytes / secs / 1e6 << " MB/s" << endl;
+  return true;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t values = 1'000'000;
+  auto r = caf::message_builder{argv + 1, argv + argc}.extract_opts({
+    {"values,n", "number of values to parse per parser", values},
+  });
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext << endl;
+    return 0;
+  }
+  auto counts = random_strings(values, [](std::mt19937& rng) {
+    return std::to_string(std::uniform_int_distribution<uint64_t>{}(rng)
+                          >> (rng() % 64));
+  });
+  uint64_t count;
+  if (!benchmark("count", counts, parsers::u64, count))
+    return 1;
+  auto ports = random_strings(values, [](std::mt19937& rng) {
+    return std::to_string(rng() % 65536);
+  });
+  uint16_t number;
+  if (!benchmark("port", ports, parsers::u16, number))
+    return 1;
+  auto addresses = random_strings(values, [](std::mt19937& rng) {
+    return std::to_string(rng() % 256) + '.' + std::to_string(rng() % 256)
+           + '.' + std::to_string(rng() % 256) + '.'
+           + std::to_string(rng() % 256);
+  });
+  address addr;
+  if (!benchmark("IPv4", addresses, parsers::addr, addr))
+    return 1;
+  auto timestamps = random_strings(values, [](std::mt19937& rng) {
+    auto fraction = std::to_string(1'000'000 + rng() % 1'000'000);
+    return std::to_string(1'200'000'000 + rng() % 400'000'000) + '.'
+           + fraction.substr(1);
+  });
+  double ts;
+  if (!benchmark("epoch", timestamps, parsers::real, ts))
+    return 1;
+  return 0;
+}
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <caf/message_builder.hpp>
+#include <caf/settings.hpp>
+
+#include <pcap/pcap.h>
+
+#include "vast/defaults.hpp"
+#include "vast/error.hpp"
+#include "vast/factory.hpp"
+#include "vast/format/pcap.hpp"
+#include "vast/table_slice_builder.hpp"
+#include "vast/table_slice_builder_factory.hpp"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+using namespace vast;
+
+namespace {
+
+// Writes a trace of UDP packets with 32 bytes of payload each, cycling through
+// the given number of flows at 10k packets per second.
+bool write_trace(const std::string& filename, size_t num_packets,
+                 size_t num_flows) {
+  auto pcap = ::pcap_open_dead(DLT_EN10MB, 65535);
+  if (pcap == nullptr)
+    return false;
+  auto dumper = ::pcap_dump_open(pcap, filename.c_str());
+  if (dumper == nullptr) {
+    ::pcap_close(pcap);
+    return false;
+  }
+  std::array<u_char, 14 + 20 + 8 + 32> packet{};
+  packet[12] = 0x08; // EtherType IPv4
+  packet[14] = 0x45; // IPv4 with a 20-byte header
+  packet[17] = 20 + 8 + 32;
+  packet[22] = 64; // TTL
+  packet[23] = 17; // UDP
+  packet[26] = 10; // 10.0.0.1 -> 10.x.y.z
+  packet[29] = 1;
+  packet[30] = 10;
+  packet[34] = 0xc0; // 49152 -> 53
+  packet[37] = 53;
+  ::pcap_pkthdr header{};
+  header.caplen = header.len = packet.size();
+  for (size_t i = 0; i < num_packets; ++i) {
+    auto flow = i % num_flows;
+    packet[31] = (flow >> 16) & 0xff;
+    packet[32] = (flow >> 8) & 0xff;
+    packet[33] = flow & 0xff;
+    header.ts.tv_sec = i / 10'000;
+    header.ts.tv_usec = i % 10'000 * 100;
+    ::pcap_dump(reinterpret_cast<u_char*>(dumper), &header, packet.data());
+  }
+  ::pcap_dump_close(dumper);
+  ::pcap_close(pcap);
+  return true;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  std::string trace = "bench-pcap.pcap";
+  size_t packets = 1'000'000;
+  size_t flows = 100'000;
+  size_t max_flows = defaults::import::pcap::max_flows;
+  auto r = caf::message_builder{argv + 1, argv + argc}.extract_opts({
+    {"trace,r", "path of the generated trace", trace},
+    {"packets,n", "number of packets in the trace", packets},
+    {"flows,f", "number of concurrent flows in the trace", flows},
+    {"max-flows,m", "size of the flow table of the reader", max_flows},
+  });
+  if (!r.error.empty()) {
+    cerr << r.error << endl;
+    return 1;
+  }
+  if (r.opts.count("help") > 0) {
+    cout << r.helptext << endl;
+    return 0;
+  }
+  if (flows == 0 || flows > (1u << 24)) {
+    cerr << "the number of flows must be in [1, 2^24]" << endl;
+    return 1;
+  }
+  factory<table_slice_builder>::initialize();
+  cerr << "writing " << packets << " packets of " << flows << " flows to "
+       << trace << endl;
+  if (!write_trace(trace, packets, flows)) {
+    cerr << "failed to write trace" << endl;
+    return 1;
+  }
+  caf::settings settings;
+  caf::put(settings, "import.pcap.read", trace);
+  caf::put(settings, "import.pcap.max-flows", max_flows);
+  format::pcap::reader reader{defaults::system::table_slice_type, settings};
+  auto start = std::chrono::steady_clock::now();
+  auto [err, produced] = reader.read(std::numeric_limits<size_t>::max(),
+                                     defaults::system::table_slice_size,
+                                     [](const table_slice_ptr&) {});
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  std::remove(trace.c_str());
+  if (err != ec::end_of_input) {
+    cerr << "failed to read trace: " << render(err) << endl;
+    return 1;
+  }
+  auto secs = std::chrono::duration<double>(elapsed).count();
+  cout << "packets: " << produced << '\n'
+       << "flows: " << flows << '\n'
+       << "max flows: " << max_flows << '\n'
+       << "total: " << secs << " s\n"
+       << "rate: " << produced / secs << " packets/s" << endl;
+  return 0;
+}